@@ -55,10 +55,13 @@ uint8_t pmw3901mb_basic_init(void)
     DRIVER_PMW3901MB_LINK_SPI_DEINIT(&gs_handle, pmw3901mb_interface_spi_deinit);
     DRIVER_PMW3901MB_LINK_SPI_READ(&gs_handle, pmw3901mb_interface_spi_read);
     DRIVER_PMW3901MB_LINK_SPI_WRITE(&gs_handle, pmw3901mb_interface_spi_write);
+    DRIVER_PMW3901MB_LINK_SPI_TRANSFER_BATCH(&gs_handle, pmw3901mb_interface_spi_transfer_batch);
     DRIVER_PMW3901MB_LINK_RESET_GPIO_INIT(&gs_handle, pmw3901mb_interface_reset_gpio_init);
     DRIVER_PMW3901MB_LINK_RESET_GPIO_DEINIT(&gs_handle, pmw3901mb_interface_reset_gpio_deinit);
     DRIVER_PMW3901MB_LINK_RESET_GPIO_WRITE(&gs_handle, pmw3901mb_interface_reset_gpio_write);
     DRIVER_PMW3901MB_LINK_DELAY_MS(&gs_handle, pmw3901mb_interface_delay_ms);
+    DRIVER_PMW3901MB_LINK_DELAY_US(&gs_handle, pmw3901mb_interface_delay_us);
+    DRIVER_PMW3901MB_LINK_GET_TIMESTAMP_US(&gs_handle, pmw3901mb_interface_get_timestamp_us);
     DRIVER_PMW3901MB_LINK_DEBUG_PRINT(&gs_handle, pmw3901mb_interface_debug_print);
 
     /* init pmw3901mb */
@@ -107,6 +110,8 @@ uint8_t pmw3901mb_basic_init(void)
 uint8_t pmw3901mb_basic_read(float height_m, pmw3901mb_motion_t *motion, float *delta_x, float *delta_y)
 {
     uint8_t res;
+    int16_t raw[2];
+    float cm[2];
 
     if (pmw3901mb_burst_read(&gs_handle, motion) != 0)
     {
@@ -116,19 +121,16 @@ uint8_t pmw3901mb_basic_read(float height_m, pmw3901mb_motion_t *motion, float *
     {
         if (motion->is_valid == 1)
         {
-            /* convert the delta x */
-            res = pmw3901mb_delta_raw_to_delta_cm(&gs_handle, motion->delta_x, height_m, (float *)delta_x);
-            if (res != 0)
-            {
-                return 1;
-            }
-
-            /* convert the delta y */
-            res = pmw3901mb_delta_raw_to_delta_cm(&gs_handle, motion->delta_y, height_m, (float *)delta_y);
+            /* convert the delta x and delta y */
+            raw[0] = motion->delta_x;
+            raw[1] = motion->delta_y;
+            res = pmw3901mb_delta_raw_to_delta_cm_batch(&gs_handle, (const int16_t *)raw, height_m, (float *)cm, 2);
             if (res != 0)
             {
                 return 1;
             }
+            *delta_x = cm[0];
+            *delta_y = cm[1];
         }
         else
         {
@@ -140,6 +142,28 @@ uint8_t pmw3901mb_basic_read(float height_m, pmw3901mb_motion_t *motion, float *
     }
 }
 
+/**
+ * @brief      basic example read many samples
+ * @param[out] *samples pointer to a motion array
+ * @param[in]  n sample number
+ * @param[in]  period_us sample period in us, 0 means back to back
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t pmw3901mb_basic_read_many(pmw3901mb_motion_t *samples, uint32_t n, uint32_t period_us)
+{
+    if (pmw3901mb_burst_read_many(&gs_handle, samples, n, period_us) != 0)
+    {
+        return 1;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
 /**
  * @brief  basic example deinit
  * @return status code
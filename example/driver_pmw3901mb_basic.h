@@ -81,6 +81,18 @@ uint8_t pmw3901mb_basic_deinit(void);
  */
 uint8_t pmw3901mb_basic_read(float height_m, pmw3901mb_motion_t *motion, float *delta_x, float *delta_y);
 
+/**
+ * @brief      basic example read many samples
+ * @param[out] *samples pointer to a motion array
+ * @param[in]  n sample number
+ * @param[in]  period_us sample period in us, 0 means back to back
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t pmw3901mb_basic_read_many(pmw3901mb_motion_t *samples, uint32_t n, uint32_t period_us);
+
 /**
  * @}
  */
@@ -38,51 +38,160 @@
 
 static pmw3901mb_handle_t gs_handle;                                                           /**< pmw3901mb handle */
 static void (*gs_irq)(pmw3901mb_motion_t *motion, float delta_x, float delta_y) = NULL;        /**< irq */
+static pmw3901mb_motion_t gs_ring[PMW3901MB_INTERRUPT_RING_SIZE];                              /**< motion ring */
+static volatile uint32_t gs_ring_head = 0;                                                     /**< ring head, written by the irq */
+static volatile uint32_t gs_ring_tail = 0;                                                     /**< ring tail, written by the consumer */
+static volatile uint32_t gs_ring_overrun = 0;                                                  /**< samples dropped because the ring is full */
+static volatile uint32_t gs_read_failed = 0;                                                   /**< failed irq reads */
+
+/**
+ * @brief ring size check definition
+ */
+#if (PMW3901MB_INTERRUPT_RING_SIZE == 0) || ((PMW3901MB_INTERRUPT_RING_SIZE & (PMW3901MB_INTERRUPT_RING_SIZE - 1)) != 0)
+    #error "PMW3901MB_INTERRUPT_RING_SIZE must be a power of 2"
+#endif
+
+/**
+ * @brief memory barrier definition
+ */
+#ifndef PMW3901MB_INTERRUPT_BARRIER
+    #if defined(__GNUC__)
+        #define PMW3901MB_INTERRUPT_BARRIER()        __sync_synchronize()                            /**< full memory barrier */
+    #elif defined(__ICCARM__)
+        #include <intrinsics.h>
+        #define PMW3901MB_INTERRUPT_BARRIER()        __DMB()                                         /**< data memory barrier */
+    #elif defined(__CC_ARM)
+        #define PMW3901MB_INTERRUPT_BARRIER()        __dmb(0xF)                                      /**< data memory barrier */
+    #elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L) && !defined(__STDC_NO_ATOMICS__)
+        #include <stdatomic.h>
+        #define PMW3901MB_INTERRUPT_BARRIER()        atomic_thread_fence(memory_order_seq_cst)       /**< full fence */
+    #else
+        #error "define PMW3901MB_INTERRUPT_BARRIER() as a memory barrier of this compiler"
+    #endif
+#endif
 
 /**
  * @brief     interrupt irq
- * @param[in] height_m height(m)
+ * @param[in] height_m height(m), ignored, it is kept for the existing callers
  * @return    status code
  *            - 0 success
  *            - 1 run failed
- * @note      none
+ * @note      the irq only reads and enqueues the valid samples, the height is applied by pmw3901mb_interrupt_process
  */
 uint8_t pmw3901mb_interrupt_irq_handler(float height_m)
 {
     uint8_t res;
-    float delta_x;
-    float delta_y;
-    pmw3901mb_motion_t motion;
+    uint32_t head;
+    pmw3901mb_motion_t drop;
+    pmw3901mb_motion_t *motion;
+
+    (void)height_m;
+
+    /* read into the free slot or drop the sample when the ring is full */
+    head = gs_ring_head;
+    if ((head - gs_ring_tail) < PMW3901MB_INTERRUPT_RING_SIZE)
+    {
+        motion = &gs_ring[head % PMW3901MB_INTERRUPT_RING_SIZE];
+    }
+    else
+    {
+        motion = &drop;
+    }
 
     /* burst read */
-    res = pmw3901mb_burst_read(&gs_handle, &motion);
+    res = pmw3901mb_burst_read(&gs_handle, motion);
     if (res != 0)
     {
-        pmw3901mb_interface_debug_print("pmw3901mb: burst read failed.\n");
+        gs_read_failed++;
         (void)pmw3901mb_set_motion(&gs_handle, 0x00);
 
         return 1;
     }
 
+    /* stamp the sample with the motion edge when the port knows it */
+    (void)pmw3901mb_interface_get_edge_timestamp_us(&motion->timestamp_us);
+
     /* check the result */
-    if (motion.is_valid == 1)
+    if (motion->is_valid == 1)
     {
-        /* convert the delta x */
-        res = pmw3901mb_delta_raw_to_delta_cm(&gs_handle, motion.delta_x, height_m, (float *)&delta_x);
-        if (res != 0)
+        if (motion != &drop)
         {
-            pmw3901mb_interface_debug_print("pmw3901mb: delta raw to delta cm failed.\n");
-            (void)pmw3901mb_set_motion(&gs_handle, 0x00);
-
-            return 1;
+            /* publish the sample */
+            PMW3901MB_INTERRUPT_BARRIER();
+            gs_ring_head = head + 1;
+        }
+        else
+        {
+            gs_ring_overrun++;
         }
+    }
+
+    /* clear the interrupt flag */
+    res = pmw3901mb_set_motion(&gs_handle, 0x00);
+    if (res != 0)
+    {
+        gs_read_failed++;
+
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief      interrupt example read a sample
+ * @param[out] *motion pointer to a motion structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 ring is empty
+ * @note       only one consumer can read the ring
+ */
+uint8_t pmw3901mb_interrupt_read(pmw3901mb_motion_t *motion)
+{
+    uint32_t tail;
+
+    /* check the samples */
+    tail = gs_ring_tail;
+    if (tail == gs_ring_head)
+    {
+        return 1;
+    }
+    PMW3901MB_INTERRUPT_BARRIER();
+
+    /* copy the sample */
+    *motion = gs_ring[tail % PMW3901MB_INTERRUPT_RING_SIZE];
+
+    /* free the slot */
+    PMW3901MB_INTERRUPT_BARRIER();
+    gs_ring_tail = tail + 1;
+
+    return 0;
+}
+
+/**
+ * @brief     interrupt example process the samples
+ * @param[in] height_m height(m)
+ * @return    status code
+ *            - 0 success
+ *            - 1 process failed
+ * @note      run it from the application loop, it drains the ring and runs the callback
+ */
+uint8_t pmw3901mb_interrupt_process(float height_m)
+{
+    uint8_t res;
+    int16_t raw[2];
+    float cm[2];
+    pmw3901mb_motion_t motion;
 
-        /* convert the delta y */
-        res = pmw3901mb_delta_raw_to_delta_cm(&gs_handle, motion.delta_y, height_m, (float *)&delta_y);
+    while (pmw3901mb_interrupt_read(&motion) == 0)
+    {
+        /* convert the delta x and delta y */
+        raw[0] = motion.delta_x;
+        raw[1] = motion.delta_y;
+        res = pmw3901mb_delta_raw_to_delta_cm_batch(&gs_handle, (const int16_t *)raw, height_m, (float *)cm, 2);
         if (res != 0)
         {
             pmw3901mb_interface_debug_print("pmw3901mb: delta raw to delta cm failed.\n");
-            (void)pmw3901mb_set_motion(&gs_handle, 0x00);
 
             return 1;
         }
@@ -90,22 +199,25 @@ uint8_t pmw3901mb_interrupt_irq_handler(float height_m)
         /* run the callback */
         if (gs_irq != NULL)
         {
-            gs_irq(&motion, delta_x, delta_y);
+            gs_irq(&motion, cm[0], cm[1]);
         }
     }
 
-    /* clear the interrupt flag */
-    res = pmw3901mb_set_motion(&gs_handle, 0x00);
-    if (res != 0)
-    {
-        pmw3901mb_interface_debug_print("pmw3901mb: set motion failed.\n");
-
-        return 1;
-    }
-
     return 0;
 }
 
+/**
+ * @brief      interrupt example get the overrun counters
+ * @param[out] *overrun pointer to a dropped samples buffer
+ * @param[out] *failed pointer to a failed irq reads buffer
+ * @note       none
+ */
+void pmw3901mb_interrupt_get_overrun(uint32_t *overrun, uint32_t *failed)
+{
+    *overrun = gs_ring_overrun;
+    *failed = gs_read_failed;
+}
+
 /**
  * @brief     interrupt example init
  * @param[in] *callback pointer to a callback function
@@ -124,10 +236,13 @@ uint8_t pmw3901mb_interrupt_init(void (*callback)(pmw3901mb_motion_t *motion, fl
     DRIVER_PMW3901MB_LINK_SPI_DEINIT(&gs_handle, pmw3901mb_interface_spi_deinit);
     DRIVER_PMW3901MB_LINK_SPI_READ(&gs_handle, pmw3901mb_interface_spi_read);
     DRIVER_PMW3901MB_LINK_SPI_WRITE(&gs_handle, pmw3901mb_interface_spi_write);
+    DRIVER_PMW3901MB_LINK_SPI_TRANSFER_BATCH(&gs_handle, pmw3901mb_interface_spi_transfer_batch);
     DRIVER_PMW3901MB_LINK_RESET_GPIO_INIT(&gs_handle, pmw3901mb_interface_reset_gpio_init);
     DRIVER_PMW3901MB_LINK_RESET_GPIO_DEINIT(&gs_handle, pmw3901mb_interface_reset_gpio_deinit);
     DRIVER_PMW3901MB_LINK_RESET_GPIO_WRITE(&gs_handle, pmw3901mb_interface_reset_gpio_write);
     DRIVER_PMW3901MB_LINK_DELAY_MS(&gs_handle, pmw3901mb_interface_delay_ms);
+    DRIVER_PMW3901MB_LINK_DELAY_US(&gs_handle, pmw3901mb_interface_delay_us);
+    DRIVER_PMW3901MB_LINK_GET_TIMESTAMP_US(&gs_handle, pmw3901mb_interface_get_timestamp_us);
     DRIVER_PMW3901MB_LINK_DEBUG_PRINT(&gs_handle, pmw3901mb_interface_debug_print);
 
     /* init pmw3901mb */
@@ -159,6 +274,12 @@ uint8_t pmw3901mb_interrupt_init(void (*callback)(pmw3901mb_motion_t *motion, fl
         return 1;
     }
 
+    /* clear the ring */
+    gs_ring_head = 0;
+    gs_ring_tail = 0;
+    gs_ring_overrun = 0;
+    gs_read_failed = 0;
+
     /* set callback */
     gs_irq = callback;
 
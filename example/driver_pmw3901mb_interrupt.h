@@ -48,16 +48,51 @@ extern "C"{
  * @{
  */
 
+/**
+ * @brief interrupt example default definition
+ */
+#ifndef PMW3901MB_INTERRUPT_RING_SIZE
+    #define PMW3901MB_INTERRUPT_RING_SIZE        16        /**< motion ring size, it must be a power of 2 */
+#endif
+
 /**
  * @brief     interrupt irq
- * @param[in] height_m height(m)
+ * @param[in] height_m height(m), ignored, it is kept for the existing callers
  * @return    status code
  *            - 0 success
  *            - 1 run failed
- * @note      none
+ * @note      the irq only reads and enqueues the valid samples, the height is applied by pmw3901mb_interrupt_process
  */
 uint8_t pmw3901mb_interrupt_irq_handler(float height_m);
 
+/**
+ * @brief      interrupt example read a sample
+ * @param[out] *motion pointer to a motion structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 ring is empty
+ * @note       only one consumer can read the ring
+ */
+uint8_t pmw3901mb_interrupt_read(pmw3901mb_motion_t *motion);
+
+/**
+ * @brief     interrupt example process the samples
+ * @param[in] height_m height(m)
+ * @return    status code
+ *            - 0 success
+ *            - 1 process failed
+ * @note      run it from the application loop, it drains the ring and runs the callback
+ */
+uint8_t pmw3901mb_interrupt_process(float height_m);
+
+/**
+ * @brief      interrupt example get the overrun counters
+ * @param[out] *overrun pointer to a dropped samples buffer
+ * @param[out] *failed pointer to a failed irq reads buffer
+ * @note       none
+ */
+void pmw3901mb_interrupt_get_overrun(uint32_t *overrun, uint32_t *failed);
+
 /**
  * @brief     interrupt example init
  * @param[in] *callback pointer to a callback function
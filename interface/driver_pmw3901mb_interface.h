@@ -92,6 +92,17 @@ uint8_t pmw3901mb_interface_spi_read(uint8_t reg, uint8_t *buf, uint16_t len);
  */
 uint8_t pmw3901mb_interface_spi_write(uint8_t reg, uint8_t *buf, uint16_t len);
 
+/**
+ * @brief         interface spi bus transfer batch
+ * @param[in,out] *transfer pointer to a transfer array
+ * @param[in]     num transfer number
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          none
+ */
+uint8_t pmw3901mb_interface_spi_transfer_batch(pmw3901mb_transfer_t *transfer, uint16_t num);
+
 /**
  * @brief  interface reset gpio init
  * @return status code
@@ -127,6 +138,30 @@ uint8_t pmw3901mb_interface_reset_gpio_write(uint8_t data);
  */
 void pmw3901mb_interface_delay_ms(uint32_t ms);
 
+/**
+ * @brief     interface delay us
+ * @param[in] us time
+ * @note      none
+ */
+void pmw3901mb_interface_delay_us(uint32_t us);
+
+/**
+ * @brief  interface get timestamp us
+ * @return timestamp in us
+ * @note   none
+ */
+uint64_t pmw3901mb_interface_get_timestamp_us(void);
+
+/**
+ * @brief      interface get the motion edge timestamp
+ * @param[out] *us pointer to a timestamp buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 no edge is being serviced
+ * @note       the timestamp is in the clock of get_timestamp_us and only valid inside the irq
+ */
+uint8_t pmw3901mb_interface_get_edge_timestamp_us(uint64_t *us);
+
 /**
  * @brief     interface print format data
  * @param[in] fmt format data
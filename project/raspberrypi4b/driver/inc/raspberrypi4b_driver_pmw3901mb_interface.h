@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      raspberrypi4b_driver_pmw3901mb_interface.h
+ * @brief     raspberrypi4b driver pmw3901mb interface header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef RASPBERRYPI4B_DRIVER_PMW3901MB_INTERFACE_H
+#define RASPBERRYPI4B_DRIVER_PMW3901MB_INTERFACE_H
+
+#include "driver_pmw3901mb_interface.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup raspberrypi4b_pmw3901mb_interface raspberrypi4b pmw3901mb interface function
+ * @brief    raspberrypi4b pmw3901mb interface spi clock modules
+ * @ingroup  pmw3901mb_interface_driver
+ * @{
+ */
+
+/**
+ * @brief spi clock tuning definition
+ */
+#define PMW3901MB_INTERFACE_SPI_DEFAULT_HZ    1000000        /**< default spi clock */
+#define PMW3901MB_INTERFACE_SPI_TUNE_MIN_HZ   1000000        /**< lowest tuned spi clock */
+#define PMW3901MB_INTERFACE_SPI_TUNE_MAX_HZ   2000000        /**< highest tuned spi clock, the datasheet limit */
+#define PMW3901MB_INTERFACE_SPI_TUNE_STEP_HZ  125000         /**< tuning step */
+#define PMW3901MB_INTERFACE_SPI_TUNE_MARGIN   10             /**< safety margin in percent */
+#define PMW3901MB_INTERFACE_SPI_TUNE_ROUNDS   64             /**< check rounds at each step */
+
+/**
+ * @brief     interface spi bus set clock
+ * @param[in] hz spi clock
+ * @return    status code
+ *            - 0 success
+ *            - 1 set clock failed
+ * @note      the clock is applied to the opened bus at once and used by the next spi init
+ */
+uint8_t pmw3901mb_interface_spi_set_clock(uint32_t hz);
+
+/**
+ * @brief  interface spi bus get clock
+ * @return spi clock
+ * @note   none
+ */
+uint32_t pmw3901mb_interface_spi_get_clock(void);
+
+/**
+ * @brief      interface spi bus clock tuning
+ * @param[in]  *handle pointer to an initialized pmw3901mb handle structure
+ * @param[in]  min_hz lowest spi clock
+ * @param[in]  max_hz highest spi clock
+ * @param[in]  step_hz clock step
+ * @param[in]  margin safety margin in percent
+ * @param[out] *hz pointer to a settled spi clock buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 tune failed
+ *             - 4 param is invalid
+ * @note       the clock steps up from min_hz until the product id pair or the burst check fails,
+ *             then settles margin percent below the fastest passing clock, never below min_hz
+ */
+uint8_t pmw3901mb_interface_spi_tune(pmw3901mb_handle_t *handle, uint32_t min_hz, uint32_t max_hz,
+                                     uint32_t step_hz, uint8_t margin, uint32_t *hz);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
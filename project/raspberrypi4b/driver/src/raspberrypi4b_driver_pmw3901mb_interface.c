@@ -34,21 +34,37 @@
  * </table>
  */
 
-#include "driver_pmw3901mb_interface.h"
+#include "raspberrypi4b_driver_pmw3901mb_interface.h"
 #include "spi.h"
 #include "gpio.h"
 #include "wire.h"
 #include <stdarg.h>
+#include <linux/spi/spidev.h>
+#include <sys/ioctl.h>
+#include <time.h>
 
 /**
  * @brief spi device name definition
  */
 #define SPI_DEVICE_NAME "/dev/spidev0.0"    /**< spi device name */
 
+/**
+ * @brief spi transfer timing definition
+ */
+#define SPI_TSRAD_US    35                  /**< read address to data delay */
+#define SPI_TSWW_US     45                  /**< write to next command delay */
+#define SPI_TSRW_US     20                  /**< read to next command delay */
+
+/**
+ * @brief spi max batch transfers definition
+ */
+#define SPI_BATCH_MAX   64                  /**< max transfers in one ioctl */
+
 /**
  * @brief spi device handle definition
  */
-static int gs_fd;                           /**< spi handle */
+static int gs_fd = -1;                      /**< spi handle */
+static uint32_t gs_spi_hz = PMW3901MB_INTERFACE_SPI_DEFAULT_HZ;        /**< spi clock */
 
 /**
  * @brief  interface spi bus init
@@ -59,7 +75,7 @@ static int gs_fd;                           /**< spi handle */
  */
 uint8_t pmw3901mb_interface_spi_init(void)
 {
-    return spi_init(SPI_DEVICE_NAME, &gs_fd, SPI_MODE_TYPE_0, 1000 * 1000);
+    return spi_init(SPI_DEVICE_NAME, &gs_fd, SPI_MODE_TYPE_0, gs_spi_hz);
 }
 
 /**
@@ -71,7 +87,171 @@ uint8_t pmw3901mb_interface_spi_init(void)
  */
 uint8_t pmw3901mb_interface_spi_deinit(void)
 {   
-    return spi_deinit(gs_fd);
+    uint8_t res;
+    
+    res = spi_deinit(gs_fd);
+    gs_fd = -1;
+    
+    return res;
+}
+
+/**
+ * @brief     interface spi bus set clock
+ * @param[in] hz spi clock
+ * @return    status code
+ *            - 0 success
+ *            - 1 set clock failed
+ * @note      the clock is applied to the opened bus at once and used by the next spi init
+ */
+uint8_t pmw3901mb_interface_spi_set_clock(uint32_t hz)
+{
+    if (hz == 0)
+    {
+        return 1;
+    }
+    if (gs_fd >= 0)
+    {
+        if (spi_set_freq(gs_fd, hz) != 0)
+        {
+            return 1;
+        }
+    }
+    gs_spi_hz = hz;
+    
+    return 0;
+}
+
+/**
+ * @brief  interface spi bus get clock
+ * @return spi clock
+ * @note   none
+ */
+uint32_t pmw3901mb_interface_spi_get_clock(void)
+{
+    return gs_spi_hz;
+}
+
+/**
+ * @brief     spi integrity check
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] rounds check rounds
+ * @return    status code
+ *            - 0 success
+ *            - 1 check failed
+ * @note      each round reads the product id pair and one motion burst, the burst has no fixed
+ *            value, so only the fields with hardware limits are checked
+ */
+static uint8_t a_spi_check(pmw3901mb_handle_t *handle, uint32_t rounds)
+{
+    pmw3901mb_motion_t motion;
+    uint8_t id;
+    uint8_t inverse_id;
+    uint32_t i;
+    
+    for (i = 0; i < rounds; i++)
+    {
+        /* the product id and its inverse */
+        if (pmw3901mb_get_product_id(handle, &id) != 0)
+        {
+            return 1;
+        }
+        if (pmw3901mb_get_inverse_product_id(handle, &inverse_id) != 0)
+        {
+            return 1;
+        }
+        if ((id != 0x49) || ((uint8_t)(id ^ inverse_id) != 0xFF))
+        {
+            return 1;
+        }
+        
+        /* the shutter is 13 bits and the max raw data is not below the min */
+        if (pmw3901mb_burst_read(handle, &motion) != 0)
+        {
+            return 1;
+        }
+        if (((motion.raw[10] & 0xE0) != 0) || (motion.raw[8] < motion.raw[9]))
+        {
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      interface spi bus clock tuning
+ * @param[in]  *handle pointer to an initialized pmw3901mb handle structure
+ * @param[in]  min_hz lowest spi clock
+ * @param[in]  max_hz highest spi clock
+ * @param[in]  step_hz clock step
+ * @param[in]  margin safety margin in percent
+ * @param[out] *hz pointer to a settled spi clock buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 tune failed
+ *             - 4 param is invalid
+ * @note       the clock steps up from min_hz until the product id pair or the burst check fails,
+ *             then settles margin percent below the fastest passing clock, never below min_hz
+ */
+uint8_t pmw3901mb_interface_spi_tune(pmw3901mb_handle_t *handle, uint32_t min_hz, uint32_t max_hz,
+                                     uint32_t step_hz, uint8_t margin, uint32_t *hz)
+{
+    uint32_t old_hz;
+    uint32_t best;
+    uint32_t f;
+    
+    if ((handle == NULL) || (hz == NULL) || (min_hz == 0) || (min_hz > max_hz) ||
+        (step_hz == 0) || (margin >= 100))
+    {
+        return 4;
+    }
+    
+    /* step up until the first failure */
+    old_hz = gs_spi_hz;
+    best = 0;
+    for (f = min_hz; f <= max_hz; f += step_hz)
+    {
+        if (pmw3901mb_interface_spi_set_clock(f) != 0)
+        {
+            break;
+        }
+        if (a_spi_check(handle, PMW3901MB_INTERFACE_SPI_TUNE_ROUNDS) != 0)
+        {
+            break;
+        }
+        best = f;
+        if (max_hz - f < step_hz)
+        {
+            break;
+        }
+    }
+    
+    /* no clock passed, restore the old one */
+    if (best == 0)
+    {
+        (void)pmw3901mb_interface_spi_set_clock(old_hz);
+        
+        return 1;
+    }
+    
+    /* back off by the margin and check again */
+    f = best - (uint32_t)(((uint64_t)best * margin) / 100);
+    f = (f < min_hz) ? min_hz : f;
+    if (pmw3901mb_interface_spi_set_clock(f) != 0)
+    {
+        (void)pmw3901mb_interface_spi_set_clock(old_hz);
+        
+        return 1;
+    }
+    if (a_spi_check(handle, PMW3901MB_INTERFACE_SPI_TUNE_ROUNDS) != 0)
+    {
+        (void)pmw3901mb_interface_spi_set_clock(old_hz);
+        
+        return 1;
+    }
+    *hz = f;
+    
+    return 0;
 }
 
 /**
@@ -104,6 +284,72 @@ uint8_t pmw3901mb_interface_spi_write(uint8_t reg, uint8_t *buf, uint16_t len)
     return spi_write(gs_fd, reg, buf, len);
 }
 
+/**
+ * @brief         interface spi bus transfer batch
+ * @param[in,out] *transfer pointer to a transfer array
+ * @param[in]     num transfer number
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          all transfers of one chunk are sent with a single ioctl
+ */
+uint8_t pmw3901mb_interface_spi_transfer_batch(pmw3901mb_transfer_t *transfer, uint16_t num)
+{
+    struct spi_ioc_transfer k[SPI_BATCH_MAX * 2];
+    uint8_t reg[SPI_BATCH_MAX];
+    uint16_t i;
+    uint16_t n;
+    int total;
+    int l;
+    
+    while (num != 0)
+    {
+        /* set the chunk size */
+        n = (num > SPI_BATCH_MAX) ? SPI_BATCH_MAX : num;
+        
+        /* clear ioc transfer */
+        memset(k, 0, sizeof(struct spi_ioc_transfer) * n * 2);
+        
+        /* set the param */
+        total = 0;
+        for (i = 0; i < n; i++)
+        {
+            reg[i] = transfer[i].reg;
+            k[i * 2 + 0].tx_buf = (unsigned long)&reg[i];
+            k[i * 2 + 0].len = 1;
+            k[i * 2 + 1].len = transfer[i].len;
+            k[i * 2 + 1].cs_change = (i != (n - 1)) ? 1 : 0;
+            if ((transfer[i].reg & 0x80) != 0)
+            {
+                k[i * 2 + 1].tx_buf = (unsigned long)transfer[i].buf;
+                k[i * 2 + 1].delay_usecs = SPI_TSWW_US;
+            }
+            else
+            {
+                k[i * 2 + 0].delay_usecs = SPI_TSRAD_US;
+                k[i * 2 + 1].rx_buf = (unsigned long)transfer[i].buf;
+                k[i * 2 + 1].delay_usecs = SPI_TSRW_US;
+            }
+            total += 1 + transfer[i].len;
+        }
+        
+        /* transmit */
+        l = ioctl(gs_fd, SPI_IOC_MESSAGE(n * 2), k);
+        if (l != total)
+        {
+            perror("spi: length check error.\n");
+            
+            return 1;
+        }
+        
+        /* next chunk */
+        transfer += n;
+        num -= n;
+    }
+    
+    return 0;
+}
+
 /**
  * @brief  interface reset gpio init
  * @return status code
@@ -151,6 +397,44 @@ void pmw3901mb_interface_delay_ms(uint32_t ms)
     usleep(1000 * ms);
 }
 
+/**
+ * @brief     interface delay us
+ * @param[in] us time
+ * @note      none
+ */
+void pmw3901mb_interface_delay_us(uint32_t us)
+{
+    usleep(us);
+}
+
+/**
+ * @brief  interface get timestamp us
+ * @return timestamp in us
+ * @note   none
+ */
+uint64_t pmw3901mb_interface_get_timestamp_us(void)
+{
+    struct timespec ts;
+
+    /* get the monotonic time */
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief      interface get the motion edge timestamp
+ * @param[out] *us pointer to a timestamp buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 no edge is being serviced
+ * @note       the libgpiod event time is CLOCK_MONOTONIC as get_timestamp_us and only valid inside the irq
+ */
+uint8_t pmw3901mb_interface_get_edge_timestamp_us(uint64_t *us)
+{
+    return gpio_interrupt_get_timestamp(us);
+}
+
 /**
  * @brief     interface print format data
  * @param[in] fmt format data
@@ -0,0 +1,218 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      host_driver_pmw3901mb_interface.c
+ * @brief     pmw3901mb host simulator driver interface source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_pmw3901mb_interface.h"
+#include "pmw3901mb_sim.h"
+
+/**
+ * @brief gpio irq definition
+ */
+extern uint8_t (*g_gpio_irq)(float m);        /**< gpio irq */
+
+/**
+ * @brief irq running definition
+ */
+static uint8_t gs_irq_running = 0;            /**< bool value, 1 blocks the nested irq */
+
+/**
+ * @brief  interface spi bus init
+ * @return status code
+ *         - 0 success
+ *         - 1 spi init failed
+ * @note   none
+ */
+uint8_t pmw3901mb_interface_spi_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  interface spi bus deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 spi deinit failed
+ * @note   none
+ */
+uint8_t pmw3901mb_interface_spi_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief      interface spi bus read
+ * @param[in]  reg register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       none
+ */
+uint8_t pmw3901mb_interface_spi_read(uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    return pmw3901mb_sim_spi_read(reg, buf, len);
+}
+
+/**
+ * @brief     interface spi bus write
+ * @param[in] reg register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t pmw3901mb_interface_spi_write(uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    return pmw3901mb_sim_spi_write(reg, buf, len);
+}
+
+/**
+ * @brief         interface spi bus transfer batch
+ * @param[in,out] *transfer pointer to a transfer array
+ * @param[in]     num transfer number
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          none
+ */
+uint8_t pmw3901mb_interface_spi_transfer_batch(pmw3901mb_transfer_t *transfer, uint16_t num)
+{
+    return pmw3901mb_sim_spi_transfer_batch(transfer, num);
+}
+
+/**
+ * @brief  interface reset gpio init
+ * @return status code
+ *         - 0 success
+ *         - 1 init failed
+ * @note   none
+ */
+uint8_t pmw3901mb_interface_reset_gpio_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  interface reset gpio deinit
+ * @return status code
+ *         - 0 success
+ *         - 1 deinit failed
+ * @note   none
+ */
+uint8_t pmw3901mb_interface_reset_gpio_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     interface reset gpio write
+ * @param[in] data written data
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      none
+ */
+uint8_t pmw3901mb_interface_reset_gpio_write(uint8_t data)
+{
+    return pmw3901mb_sim_reset_gpio_write(data);
+}
+
+/**
+ * @brief     interface delay ms
+ * @param[in] ms time
+ * @note      the virtual time is advanced and then the motion pin is polled,
+ *            so the irq handler runs only between the caller's transactions
+ */
+void pmw3901mb_interface_delay_ms(uint32_t ms)
+{
+    pmw3901mb_sim_delay_us(ms * 1000);
+    if ((g_gpio_irq != NULL) && (gs_irq_running == 0) && (pmw3901mb_sim_get_motion_pin() != 0))
+    {
+        gs_irq_running = 1;
+        (void)g_gpio_irq(1.0f);
+        gs_irq_running = 0;
+    }
+}
+
+/**
+ * @brief     interface delay us
+ * @param[in] us time
+ * @note      none
+ */
+void pmw3901mb_interface_delay_us(uint32_t us)
+{
+    pmw3901mb_sim_delay_us(us);
+}
+
+/**
+ * @brief  interface get timestamp us
+ * @return timestamp in us
+ * @note   the virtual time of the model
+ */
+uint64_t pmw3901mb_interface_get_timestamp_us(void)
+{
+    return pmw3901mb_sim_get_timestamp_us();
+}
+
+/**
+ * @brief      interface get the motion edge timestamp
+ * @param[out] *us pointer to a timestamp buffer
+ * @return     status code
+ *             - 1 no edge is being serviced
+ * @note       the model has no edge time, the read time is used
+ */
+uint8_t pmw3901mb_interface_get_edge_timestamp_us(uint64_t *us)
+{
+    (void)us;
+    
+    return 1;
+}
+
+/**
+ * @brief     interface print format data
+ * @param[in] fmt format data
+ * @note      none
+ */
+void pmw3901mb_interface_debug_print(const char *const fmt, ...)
+{
+    va_list args;
+    
+    va_start(args, fmt);
+    pmw3901mb_sim_debug_vprint(fmt, args);
+    va_end(args);
+}
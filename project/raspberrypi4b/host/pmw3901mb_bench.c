@@ -0,0 +1,875 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_bench.c
+ * @brief     pmw3901mb host benchmark source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "pmw3901mb_sim.h"
+#include "pmw3901mb_soa.h"
+#include "pmw3901mb_log.h"
+#include "pmw3901mb_log_index.h"
+#include "pmw3901mb_log_mmap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief bench result structure definition
+ */
+typedef struct bench_result_s
+{
+    const char *name;                /**< benchmark name */
+    uint32_t iterations;             /**< iterations */
+    uint64_t ns;                     /**< wall time */
+    uint64_t virtual_us;             /**< simulated bus and delay time */
+    uint32_t transfers;              /**< spi transfers */
+    uint32_t bytes;                  /**< spi bytes */
+    uint32_t calls;                  /**< spi calls */
+    uint64_t busy_ns;                /**< simulated bus busy time */
+    uint8_t failed;                  /**< bool value */
+} bench_result_t;
+
+/**
+ * @brief bench variables definition
+ */
+static pmw3901mb_handle_t gs_handle;                        /**< pmw3901mb handle */
+static pmw3901mb_stats_t gs_stats;                          /**< pmw3901mb stats */
+static uint8_t gs_frame[35][35];                            /**< frame buffer */
+static volatile float gs_sink;                              /**< keeps the results alive */
+static const pmw3901mb_sim_waypoint_t gsc_line[] =
+{
+    {1000000, 300.0f, 150.0f},
+};
+
+/**
+ * @brief  get the monotonic time
+ * @return time in ns
+ * @note   none
+ */
+static uint64_t a_now_ns(void)
+{
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief      begin a benchmark
+ * @param[out] *result pointer to a result structure
+ * @param[in]  *name pointer to a benchmark name
+ * @param[in]  iterations iterations
+ * @note       none
+ */
+static void a_begin(bench_result_t *result, const char *name, uint32_t iterations)
+{
+    pmw3901mb_sim_bus_t bus;
+    
+    memset(result, 0, sizeof(bench_result_t));
+    result->name = name;
+    result->iterations = iterations;
+    result->virtual_us = pmw3901mb_sim_get_timestamp_us();
+    result->transfers = gs_stats.spi_read + gs_stats.spi_write;
+    result->bytes = gs_stats.read_bytes + gs_stats.write_bytes;
+    (void)pmw3901mb_sim_get_bus(&bus);
+    result->calls = bus.calls;
+    result->busy_ns = bus.busy_ns;
+}
+
+/**
+ * @brief         end a benchmark
+ * @param[in,out] *result pointer to a result structure
+ * @note          none
+ */
+static void a_end(bench_result_t *result)
+{
+    pmw3901mb_sim_bus_t bus;
+    
+    (void)pmw3901mb_sim_get_bus(&bus);
+    result->calls = bus.calls - result->calls;
+    result->busy_ns = bus.busy_ns - result->busy_ns;
+    result->virtual_us = pmw3901mb_sim_get_timestamp_us() - result->virtual_us;
+    result->transfers = gs_stats.spi_read + gs_stats.spi_write - result->transfers;
+    result->bytes = gs_stats.read_bytes + gs_stats.write_bytes - result->bytes;
+}
+
+/**
+ * @brief  bring the simulated chip up
+ * @return status code
+ *         - 0 success
+ *         - 1 run failed
+ * @note   none
+ */
+static uint8_t a_bring_up(void)
+{
+    if (pmw3901mb_init(&gs_handle) != 0)
+    {
+        return 1;
+    }
+    if ((pmw3901mb_power_up(&gs_handle) != 0) || (pmw3901mb_set_optimum_performance(&gs_handle) != 0))
+    {
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief         run the init benchmark
+ * @param[in,out] *result pointer to a result structure
+ * @param[in]     n iterations
+ * @note          the deinit between the calls is not timed
+ */
+static void a_bench_init(bench_result_t *result, uint32_t n)
+{
+    uint64_t start;
+    uint64_t ns;
+    uint32_t i;
+    
+    a_begin(result, "init", n);
+    ns = 0;
+    for (i = 0; i < n; i++)
+    {
+        start = a_now_ns();
+        result->failed |= (pmw3901mb_init(&gs_handle) != 0);
+        ns += a_now_ns() - start;
+        (void)pmw3901mb_deinit(&gs_handle);
+    }
+    a_end(result);
+    result->ns = ns;
+}
+
+/**
+ * @brief         run the burst read benchmark
+ * @param[in,out] *result pointer to a result structure
+ * @param[in]     n iterations
+ * @note          none
+ */
+static void a_bench_burst_read(bench_result_t *result, uint32_t n)
+{
+    pmw3901mb_motion_t motion;
+    uint64_t start;
+    uint32_t i;
+    
+    a_begin(result, "burst_read", n);
+    start = a_now_ns();
+    for (i = 0; i < n; i++)
+    {
+        result->failed |= (pmw3901mb_burst_read(&gs_handle, &motion) != 0);
+    }
+    result->ns = a_now_ns() - start;
+    a_end(result);
+    gs_sink = (float)motion.delta_x;
+}
+
+/**
+ * @brief         run the burst profile read benchmark
+ * @param[in,out] *result pointer to a result structure
+ * @param[in]     *name pointer to a benchmark name
+ * @param[in]     profile burst profile
+ * @param[in]     n iterations
+ * @note          none
+ */
+static void a_bench_burst_read_profile(bench_result_t *result, const char *name, pmw3901mb_burst_profile_t profile, uint32_t n)
+{
+    pmw3901mb_motion_t motion;
+    uint64_t start;
+    uint32_t i;
+    
+    a_begin(result, name, n);
+    start = a_now_ns();
+    for (i = 0; i < n; i++)
+    {
+        result->failed |= (pmw3901mb_burst_read_profile(&gs_handle, profile, &motion) != 0);
+    }
+    result->ns = a_now_ns() - start;
+    a_end(result);
+    gs_sink = (float)motion.delta_x;
+}
+
+/**
+ * @brief         run the multi sample burst read benchmark
+ * @param[in,out] *result pointer to a result structure
+ * @param[in]     n iterations
+ * @note          the samples are read back to back in blocks of 64
+ */
+static void a_bench_burst_read_many(bench_result_t *result, uint32_t n)
+{
+    static pmw3901mb_motion_t samples[64];
+    uint64_t start;
+    uint32_t i;
+    
+    n = n & ~63U;
+    a_begin(result, "burst_read_many", n);
+    start = a_now_ns();
+    for (i = 0; i < n; i += 64)
+    {
+        result->failed |= (pmw3901mb_burst_read_many(&gs_handle, samples, 64, 0) != 0);
+    }
+    result->ns = a_now_ns() - start;
+    a_end(result);
+    gs_sink = (float)samples[63].delta_x;
+}
+
+/**
+ * @brief         run the delta conversion benchmark
+ * @param[in,out] *result pointer to a result structure
+ * @param[in]     n iterations
+ * @note          none
+ */
+static void a_bench_delta_raw_to_delta_cm(bench_result_t *result, uint32_t n)
+{
+    uint64_t start;
+    uint32_t i;
+    float cm;
+    float sum;
+    
+    a_begin(result, "delta_raw_to_delta_cm", n);
+    sum = 0.0f;
+    start = a_now_ns();
+    for (i = 0; i < n; i++)
+    {
+        result->failed |= (pmw3901mb_delta_raw_to_delta_cm(&gs_handle, (int16_t)(i & 0x3FF), 0.5f, &cm) != 0);
+        sum += cm;
+    }
+    result->ns = a_now_ns() - start;
+    a_end(result);
+    gs_sink = sum;
+}
+
+/**
+ * @brief         run the batch delta conversion benchmark
+ * @param[in,out] *result pointer to a result structure
+ * @param[in]     n iterations
+ * @note          one op is one converted delta
+ */
+static void a_bench_delta_raw_to_delta_cm_batch(bench_result_t *result, uint32_t n)
+{
+    int16_t raw[256];
+    float cm[256];
+    uint64_t start;
+    uint32_t i;
+    
+    for (i = 0; i < 256; i++)
+    {
+        raw[i] = (int16_t)(i * 37 - 4000);
+    }
+    a_begin(result, "delta_raw_to_delta_cm_batch", (n / 256) * 256);
+    start = a_now_ns();
+    for (i = 0; i < n / 256; i++)
+    {
+        result->failed |= (pmw3901mb_delta_raw_to_delta_cm_batch(&gs_handle, raw, 0.5f, cm, 256) != 0);
+    }
+    result->ns = a_now_ns() - start;
+    a_end(result);
+    gs_sink = cm[255];
+}
+
+/**
+ * @brief         run the q16.16 delta conversion benchmark
+ * @param[in,out] *result pointer to a result structure
+ * @param[in]     n iterations
+ * @note          one op is one converted delta
+ */
+static void a_bench_delta_raw_to_delta_cm_q16(bench_result_t *result, uint32_t n)
+{
+    int16_t raw[256];
+    int32_t cm[256];
+    uint64_t start;
+    uint32_t i;
+    
+    for (i = 0; i < 256; i++)
+    {
+        raw[i] = (int16_t)(i * 37 - 4000);
+    }
+    a_begin(result, "delta_raw_to_delta_cm_q16", (n / 256) * 256);
+    start = a_now_ns();
+    for (i = 0; i < n / 256; i++)
+    {
+        result->failed |= (pmw3901mb_delta_raw_to_delta_cm_q16(&gs_handle, raw, 0x8000, cm, 256) != 0);
+    }
+    result->ns = a_now_ns() - start;
+    a_end(result);
+    gs_sink = (float)cm[255];
+}
+
+/**
+ * @brief         run the soa decode benchmark
+ * @param[in,out] *simd pointer to a simd result structure
+ * @param[in,out] *scalar pointer to a scalar result structure
+ * @param[in]     n iterations
+ * @note          the bursts are pseudo random, the simd result fails if its columns differ from the scalar ones
+ */
+static void a_bench_soa_decode(bench_result_t *simd, bench_result_t *scalar, uint32_t n)
+{
+    static uint8_t raw[4096 * PMW3901MB_SOA_RAW_SIZE];
+    pmw3901mb_soa_t a;
+    pmw3901mb_soa_t b;
+    uint32_t seed;
+    uint64_t start;
+    uint32_t i;
+    
+    /* random bursts */
+    seed = 1;
+    for (i = 0; i < sizeof(raw); i++)
+    {
+        seed = seed * 1103515245U + 12345U;
+        raw[i] = (uint8_t)(seed >> 16);
+    }
+    n = n & ~4095U;
+    memset(simd, 0, sizeof(bench_result_t));
+    memset(scalar, 0, sizeof(bench_result_t));
+    simd->name = "soa_decode";
+    simd->iterations = n;
+    scalar->name = "soa_decode_scalar";
+    scalar->iterations = n;
+    memset(&a, 0, sizeof(pmw3901mb_soa_t));
+    memset(&b, 0, sizeof(pmw3901mb_soa_t));
+    if ((pmw3901mb_soa_init(&a, 4096) != 0) || (pmw3901mb_soa_init(&b, 4096) != 0))
+    {
+        simd->failed = 1;
+        scalar->failed = 1;
+        (void)pmw3901mb_soa_free(&a);
+        
+        return;
+    }
+    
+    /* simd */
+    (void)pmw3901mb_soa_set_simd(1);
+    start = a_now_ns();
+    for (i = 0; i < n; i += 4096)
+    {
+        (void)pmw3901mb_soa_clear(&a);
+        simd->failed |= (pmw3901mb_soa_decode(&a, raw, NULL, 4096) != 4096);
+    }
+    simd->ns = a_now_ns() - start;
+    
+    /* scalar */
+    (void)pmw3901mb_soa_set_simd(0);
+    start = a_now_ns();
+    for (i = 0; i < n; i += 4096)
+    {
+        (void)pmw3901mb_soa_clear(&b);
+        scalar->failed |= (pmw3901mb_soa_decode(&b, raw, NULL, 4096) != 4096);
+    }
+    scalar->ns = a_now_ns() - start;
+    (void)pmw3901mb_soa_set_simd(1);
+    
+    /* the columns must match */
+    simd->failed |= (memcmp(a.delta_x, b.delta_x, 4096 * sizeof(int16_t)) != 0);
+    simd->failed |= (memcmp(a.delta_y, b.delta_y, 4096 * sizeof(int16_t)) != 0);
+    simd->failed |= (memcmp(a.shutter, b.shutter, 4096 * sizeof(uint16_t)) != 0);
+    simd->failed |= (memcmp(a.squal, b.squal, 4096) != 0);
+    simd->failed |= (memcmp(a.valid, b.valid, 4096) != 0);
+    (void)pmw3901mb_soa_free(&a);
+    (void)pmw3901mb_soa_free(&b);
+}
+
+/**
+ * @brief         run the log index window query benchmark
+ * @param[in,out] *result pointer to a result structure
+ * @param[in]     *sample pointer to the logged samples
+ * @param[in]     n logged samples
+ * @param[in]     *path pointer to a log file path
+ * @note          the first 100 windows are checked against a full scan of the samples, the sidecar index is removed
+ */
+static void a_bench_log_index(bench_result_t *result, const pmw3901mb_motion_t *sample, uint32_t n, const char *path)
+{
+    pmw3901mb_log_index_t index;
+    char index_path[512];
+    uint64_t start;
+    uint64_t t0;
+    uint64_t t1;
+    int64_t delta_x;
+    int64_t delta_y;
+    int64_t sum_x;
+    int64_t sum_y;
+    uint32_t q;
+    uint32_t i;
+    uint32_t a;
+    uint32_t b;
+    
+    memset(result, 0, sizeof(bench_result_t));
+    result->name = "log_index_query";
+    result->iterations = n / 10;
+    (void)snprintf(index_path, sizeof(index_path), "%s%s", path, PMW3901MB_LOG_INDEX_SUFFIX);
+    if ((n == 0) || (pmw3901mb_log_index_open(&index, path) != 0))
+    {
+        result->failed = 1;
+        (void)remove(index_path);
+        
+        return;
+    }
+    start = a_now_ns();
+    for (q = 0; q < result->iterations; q++)
+    {
+        a = (uint32_t)(((uint64_t)q * 7919U) % n);
+        b = (uint32_t)(((uint64_t)q * 104729U + 12345U) % n);
+        t0 = sample[(a < b) ? a : b].timestamp_us;
+        t1 = sample[(a < b) ? b : a].timestamp_us;
+        result->failed |= (pmw3901mb_log_index_displacement(&index, t0, t1, &delta_x, &delta_y) != 0);
+    }
+    result->ns = a_now_ns() - start;
+    for (q = 0; (q < result->iterations) && (q < 100); q++)
+    {
+        a = (uint32_t)(((uint64_t)q * 7919U) % n);
+        b = (uint32_t)(((uint64_t)q * 104729U + 12345U) % n);
+        t0 = sample[(a < b) ? a : b].timestamp_us;
+        t1 = sample[(a < b) ? b : a].timestamp_us;
+        sum_x = 0;
+        sum_y = 0;
+        for (i = 0; i < n; i++)
+        {
+            if ((sample[i].timestamp_us >= t0) && (sample[i].timestamp_us < t1) && (sample[i].is_valid == 1))
+            {
+                sum_x += sample[i].delta_x;
+                sum_y += sample[i].delta_y;
+            }
+        }
+        result->failed |= (pmw3901mb_log_index_displacement(&index, t0, t1, &delta_x, &delta_y) != 0);
+        result->failed |= (delta_x != sum_x) || (delta_y != sum_y);
+    }
+    (void)pmw3901mb_log_index_close(&index);
+    (void)remove(index_path);
+}
+
+/**
+ * @brief         run the log mmap read benchmark
+ * @param[in,out] *result pointer to a result structure
+ * @param[in]     *sample pointer to the logged samples
+ * @param[in]     n logged samples
+ * @param[in]     *path pointer to a log file path
+ * @note          the samples are iterated block by block from the mapping and compared like the read benchmark
+ */
+static void a_bench_log_mmap(bench_result_t *result, const pmw3901mb_motion_t *sample, uint32_t n, const char *path)
+{
+    pmw3901mb_log_mmap_t map;
+    const pmw3901mb_log_sample_t *s;
+    uint64_t start;
+    uint16_t count;
+    uint32_t i;
+    uint16_t k;
+    
+    memset(result, 0, sizeof(bench_result_t));
+    result->name = "log_mmap_read";
+    result->iterations = n;
+    start = a_now_ns();
+    if (pmw3901mb_log_mmap_open(&map, path, PMW3901MB_LOG_MMAP_ADVICE_SEQUENTIAL) != 0)
+    {
+        result->failed = 1;
+        
+        return;
+    }
+    for (i = 0; i < n; i += count)
+    {
+        if ((pmw3901mb_log_mmap_next_block(&map, &s, &count) != 0) || (count == 0) || (count > n - i))
+        {
+            result->failed = 1;
+            
+            break;
+        }
+        for (k = 0; k < count; k++)
+        {
+            result->failed |= (s[k].timestamp_us != sample[i + k].timestamp_us);
+            result->failed |= (s[k].motion != sample[i + k].raw[0]);
+            result->failed |= (s[k].delta_x != (int16_t)(sample[i + k].raw[2] | (sample[i + k].raw[3] << 8)));
+            result->failed |= (s[k].delta_y != (int16_t)(sample[i + k].raw[4] | (sample[i + k].raw[5] << 8)));
+            result->failed |= (s[k].squal != sample[i + k].raw[6]);
+        }
+    }
+    result->failed |= (pmw3901mb_log_mmap_next_block(&map, &s, &count) != 0) || (count != 0);
+    (void)pmw3901mb_log_mmap_close(&map);
+    result->ns = a_now_ns() - start;
+}
+
+/**
+ * @brief         run the log write and read benchmark
+ * @param[in,out] *write_result pointer to a write result structure
+ * @param[in,out] *read_result pointer to a read result structure
+ * @param[in,out] *index_result pointer to an index result structure
+ * @param[in,out] *mmap_result pointer to an mmap result structure
+ * @param[in]     n iterations
+ * @param[in]     *path pointer to a log file path
+ * @param[out]    *file_bytes pointer to a log size buffer
+ * @note          the samples come from the simulator, the read result fails if a sample differs after the round trip,
+ *                the log file is removed at the end
+ */
+static void a_bench_log(bench_result_t *write_result, bench_result_t *read_result, bench_result_t *index_result,
+                        bench_result_t *mmap_result, uint32_t n, const char *path, uint64_t *file_bytes)
+{
+    pmw3901mb_log_writer_t writer;
+    pmw3901mb_log_reader_t reader;
+    pmw3901mb_motion_t *sample;
+    pmw3901mb_motion_t motion[64];
+    uint64_t start;
+    uint32_t num;
+    uint32_t i;
+    uint32_t k;
+    
+    n = n & ~63U;
+    memset(write_result, 0, sizeof(bench_result_t));
+    memset(read_result, 0, sizeof(bench_result_t));
+    memset(index_result, 0, sizeof(bench_result_t));
+    memset(mmap_result, 0, sizeof(bench_result_t));
+    index_result->name = "log_index_query";
+    mmap_result->name = "log_mmap_read";
+    write_result->name = "log_write";
+    write_result->iterations = n;
+    read_result->name = "log_read";
+    read_result->iterations = n;
+    *file_bytes = 0;
+    sample = (pmw3901mb_motion_t *)malloc(sizeof(pmw3901mb_motion_t) * n);
+    if (sample == NULL)
+    {
+        write_result->failed = 1;
+        read_result->failed = 1;
+        index_result->failed = 1;
+        mmap_result->failed = 1;
+        
+        return;
+    }
+    
+    /* collect the samples */
+    for (i = 0; i < n; i += 64)
+    {
+        write_result->failed |= (pmw3901mb_burst_read_many(&gs_handle, &sample[i], 64, 1000) != 0);
+    }
+    
+    /* write */
+    start = a_now_ns();
+    if (pmw3901mb_log_writer_open(&writer, path, 0) != 0)
+    {
+        write_result->failed = 1;
+        read_result->failed = 1;
+        index_result->failed = 1;
+        mmap_result->failed = 1;
+        free(sample);
+        
+        return;
+    }
+    for (i = 0; i < n; i += 64)
+    {
+        write_result->failed |= (pmw3901mb_log_writer_write(&writer, &sample[i], 64) != 0);
+    }
+    write_result->failed |= (pmw3901mb_log_writer_close(&writer) != 0);
+    write_result->ns = a_now_ns() - start;
+    *file_bytes = writer.bytes;
+    
+    /* read and compare */
+    start = a_now_ns();
+    if (pmw3901mb_log_reader_open(&reader, path) != 0)
+    {
+        read_result->failed = 1;
+        index_result->failed = 1;
+        mmap_result->failed = 1;
+        free(sample);
+        (void)remove(path);
+        
+        return;
+    }
+    for (i = 0; i < n; i += num)
+    {
+        if ((pmw3901mb_log_reader_read(&reader, motion, 64, &num) != 0) || (num == 0))
+        {
+            read_result->failed = 1;
+            
+            break;
+        }
+        for (k = 0; k < num; k++)
+        {
+            read_result->failed |= (motion[k].timestamp_us != sample[i + k].timestamp_us);
+            read_result->failed |= (motion[k].is_valid != sample[i + k].is_valid);
+            read_result->failed |= (memcmp(&motion[k].raw[0], &sample[i + k].raw[0], 1) != 0);
+            read_result->failed |= (memcmp(&motion[k].raw[2], &sample[i + k].raw[2], 5) != 0);
+            read_result->failed |= (memcmp(&motion[k].raw[10], &sample[i + k].raw[10], 2) != 0);
+        }
+    }
+    read_result->failed |= (pmw3901mb_log_reader_read(&reader, motion, 64, &num) != 0) || (num != 0);
+    (void)pmw3901mb_log_reader_close(&reader);
+    read_result->ns = a_now_ns() - start;
+    a_bench_log_mmap(mmap_result, sample, n, path);
+    a_bench_log_index(index_result, sample, n, path);
+    free(sample);
+    (void)remove(path);
+}
+
+/**
+ * @brief         run the frame capture start and stop benchmark
+ * @param[in,out] *start_result pointer to a start result structure
+ * @param[in,out] *stop_result pointer to a stop result structure
+ * @param[in]     n iterations
+ * @note          none
+ */
+static void a_bench_frame_capture(bench_result_t *start_result, bench_result_t *stop_result, uint32_t n)
+{
+    bench_result_t tmp;
+    uint64_t start;
+    uint32_t i;
+    
+    memset(start_result, 0, sizeof(bench_result_t));
+    memset(stop_result, 0, sizeof(bench_result_t));
+    start_result->name = "start_frame_capture";
+    start_result->iterations = n;
+    stop_result->name = "stop_frame_capture";
+    stop_result->iterations = n;
+    for (i = 0; i < n; i++)
+    {
+        a_begin(&tmp, "", 1);
+        start = a_now_ns();
+        start_result->failed |= (pmw3901mb_start_frame_capture(&gs_handle) != 0);
+        start_result->ns += a_now_ns() - start;
+        a_end(&tmp);
+        start_result->virtual_us += tmp.virtual_us;
+        start_result->transfers += tmp.transfers;
+        start_result->bytes += tmp.bytes;
+        start_result->calls += tmp.calls;
+        start_result->busy_ns += tmp.busy_ns;
+        
+        a_begin(&tmp, "", 1);
+        start = a_now_ns();
+        stop_result->failed |= (pmw3901mb_stop_frame_capture(&gs_handle) != 0);
+        stop_result->ns += a_now_ns() - start;
+        a_end(&tmp);
+        stop_result->virtual_us += tmp.virtual_us;
+        stop_result->transfers += tmp.transfers;
+        stop_result->bytes += tmp.bytes;
+        stop_result->calls += tmp.calls;
+        stop_result->busy_ns += tmp.busy_ns;
+    }
+}
+
+/**
+ * @brief         run the get frame benchmark
+ * @param[in,out] *result pointer to a result structure
+ * @param[in]     n iterations
+ * @note          the frame capture is started before the timing
+ */
+static void a_bench_get_frame(bench_result_t *result, uint32_t n)
+{
+    uint64_t start;
+    uint32_t i;
+    
+    if (pmw3901mb_start_frame_capture(&gs_handle) != 0)
+    {
+        a_begin(result, "get_frame", n);
+        result->failed = 1;
+        
+        return;
+    }
+    a_begin(result, "get_frame", n);
+    start = a_now_ns();
+    for (i = 0; i < n; i++)
+    {
+        result->failed |= (pmw3901mb_get_frame(&gs_handle, gs_frame) != 0);
+    }
+    result->ns = a_now_ns() - start;
+    a_end(result);
+    (void)pmw3901mb_stop_frame_capture(&gs_handle);
+}
+
+/**
+ * @brief     print a result as json
+ * @param[in] *fp pointer to a file
+ * @param[in] *result pointer to a result structure
+ * @param[in] last bool value
+ * @note      none
+ */
+static void a_print(FILE *fp, const bench_result_t *result, uint8_t last)
+{
+    double n;
+    
+    n = (result->iterations != 0) ? (double)result->iterations : 1.0;
+    fprintf(fp, "    {\"name\": \"%s\", \"iterations\": %u, \"ns_per_op\": %.2f, \"transfers_per_op\": %.3f, "
+            "\"bytes_per_op\": %.3f, \"calls_per_op\": %.3f, \"bus_busy_us_per_op\": %.3f, "
+            "\"virtual_us_per_op\": %.3f, \"ok\": %s}%s\n",
+            result->name, result->iterations, (double)result->ns / n, (double)result->transfers / n,
+            (double)result->bytes / n, (double)result->calls / n, (double)result->busy_ns / 1000.0 / n,
+            (double)result->virtual_us / n, (result->failed != 0) ? "false" : "true", (last != 0) ? "" : ",");
+}
+
+/**
+ * @brief     main function
+ * @param[in] argc arg numbers
+ * @param[in] **argv arg address
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      none
+ */
+int main(int argc, char **argv)
+{
+    pmw3901mb_sim_config_t config;
+    pmw3901mb_info_t info;
+    bench_result_t result[17];
+    uint64_t log_bytes;
+    const char *log_path;
+    const char *output;
+    uint32_t n;
+    uint32_t sensors;
+    double busy_us;
+    double cycle_us;
+    double rate;
+    uint8_t failed;
+    FILE *fp;
+    int i;
+    
+    n = 100000;
+    output = NULL;
+    log_path = "pmw3901mb_bench.log";
+    sensors = 1;
+    (void)pmw3901mb_sim_get_default_config(&config);
+    for (i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--iterations=", 13) == 0)
+        {
+            n = (uint32_t)strtoul(argv[i] + 13, NULL, 10);
+        }
+        else if (strncmp(argv[i], "--output=", 9) == 0)
+        {
+            output = argv[i] + 9;
+        }
+        else if (strncmp(argv[i], "--log=", 6) == 0)
+        {
+            log_path = argv[i] + 6;
+        }
+        else if (strncmp(argv[i], "--spi-hz=", 9) == 0)
+        {
+            config.spi_hz = (uint32_t)strtoul(argv[i] + 9, NULL, 10);
+        }
+        else if (strncmp(argv[i], "--call-ns=", 10) == 0)
+        {
+            config.call_ns = (uint32_t)strtoul(argv[i] + 10, NULL, 10);
+        }
+        else if (strncmp(argv[i], "--cs-ns=", 8) == 0)
+        {
+            config.cs_ns = (uint32_t)strtoul(argv[i] + 8, NULL, 10);
+        }
+        else if (strncmp(argv[i], "--sensors=", 10) == 0)
+        {
+            sensors = (uint32_t)strtoul(argv[i] + 10, NULL, 10);
+        }
+        else if (strcmp(argv[i], "--batch") == 0)
+        {
+            config.batch = 1;
+        }
+        else
+        {
+            n = 0;
+            
+            break;
+        }
+    }
+    if ((n < 1000) || (sensors == 0) || (config.spi_hz == 0))
+    {
+        fprintf(stderr, "usage: pmw3901mb_bench [--iterations=<num>] [--output=<file>] [--spi-hz=<hz>] [--cs-ns=<ns>]\n");
+        fprintf(stderr, "                       [--call-ns=<ns>] [--sensors=<num>] [--batch] [--log=<file>]\n");
+        fprintf(stderr, "       iterations is at least 1000, init and frame capture run 1/100 of it, get_frame 1/1000.\n");
+        
+        return 1;
+    }
+    
+    config.trajectory = gsc_line;
+    config.trajectory_len = sizeof(gsc_line) / sizeof(gsc_line[0]);
+    config.trajectory_loop = 1;
+    (void)pmw3901mb_sim_init(&config);
+    pmw3901mb_sim_set_print(0);
+    (void)pmw3901mb_sim_link(&gs_handle);
+    (void)pmw3901mb_set_stats(&gs_handle, &gs_stats);
+    
+    a_bench_init(&result[0], n / 100);
+    if (a_bring_up() != 0)
+    {
+        fprintf(stderr, "pmw3901mb_bench: bring up failed.\n");
+        
+        return 1;
+    }
+    a_bench_burst_read(&result[1], n);
+    a_bench_burst_read_profile(&result[2], "burst_read_motion", PMW3901MB_BURST_PROFILE_MOTION, n);
+    a_bench_burst_read_profile(&result[3], "burst_read_squal", PMW3901MB_BURST_PROFILE_SQUAL, n);
+    a_bench_burst_read_many(&result[4], n);
+    a_bench_delta_raw_to_delta_cm(&result[5], n);
+    a_bench_delta_raw_to_delta_cm_batch(&result[6], n);
+    a_bench_delta_raw_to_delta_cm_q16(&result[7], n);
+    a_bench_soa_decode(&result[11], &result[12], n);
+    a_bench_log(&result[13], &result[14], &result[15], &result[16], n, log_path, &log_bytes);
+    a_bench_frame_capture(&result[8], &result[9], n / 100);
+    a_bench_get_frame(&result[10], n / 1000);
+    (void)pmw3901mb_deinit(&gs_handle);
+    
+    fp = stdout;
+    if (output != NULL)
+    {
+        fp = fopen(output, "w");
+        if (fp == NULL)
+        {
+            fprintf(stderr, "pmw3901mb_bench: can't open %s.\n", output);
+            
+            return 1;
+        }
+    }
+    (void)pmw3901mb_info(&info);
+    fprintf(fp, "{\n  \"driver\": \"pmw3901mb\",\n  \"driver_version\": %u,\n  \"backend\": \"sim\",\n",
+            (unsigned)info.driver_version);
+    fprintf(fp, "  \"bus\": {\"spi_hz\": %u, \"cs_ns\": %u, \"call_ns\": %u, \"tsrad_us\": %u, \"tsww_us\": %u, "
+            "\"tsrw_us\": %u, \"batch\": %s},\n  \"simd\": \"%s\",\n", config.spi_hz, config.cs_ns, config.call_ns, config.tsrad_us,
+            config.tsww_us, config.tsrw_us, (config.batch != 0) ? "true" : "false",
+            pmw3901mb_soa_get_simd());
+    busy_us = (double)result[1].busy_ns / 1000.0 / (double)result[1].iterations;
+    cycle_us = (double)result[1].virtual_us / (double)result[1].iterations;
+    rate = 1e6 / (busy_us * sensors);
+    rate = (1e6 / cycle_us < rate) ? 1e6 / cycle_us : rate;
+    fprintf(fp, "  \"burst_read_rate\": {\"sensors\": %u, \"bus_busy_us\": %.3f, \"cycle_us\": %.3f, "
+            "\"max_rate_hz_per_sensor\": %.1f},\n", sensors, busy_us, cycle_us, rate);
+    fprintf(fp, "  \"log\": {\"samples\": %u, \"file_bytes\": %llu, \"bytes_per_sample\": %.3f, "
+            "\"raw_bytes_per_sample\": %u},\n", result[13].iterations, (unsigned long long)log_bytes,
+            (result[13].iterations != 0) ? (double)log_bytes / result[13].iterations : 0.0,
+            (unsigned)(12 + sizeof(uint64_t)));
+    fprintf(fp, "  \"results\": [\n");
+    failed = 0;
+    for (i = 0; i < 17; i++)
+    {
+        a_print(fp, &result[i], (uint8_t)(i == 16));
+        failed |= result[i].failed;
+    }
+    fprintf(fp, "  ]\n}\n");
+    if (fp != stdout)
+    {
+        fclose(fp);
+    }
+    
+    return (failed != 0) ? 1 : 0;
+}
@@ -0,0 +1,1003 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_log.c
+ * @brief     pmw3901mb binary motion log source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "pmw3901mb_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief log variables definition
+ */
+static uint32_t gs_crc_table[256];        /**< crc32 table */
+static uint8_t gs_crc_inited = 0;         /**< crc32 table flag */
+
+/**
+ * @brief     update a crc32
+ * @param[in] crc crc before the data
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @return    crc after the data
+ * @note      ieee 802.3 polynomial, the caller starts with 0
+ */
+static uint32_t a_log_crc32(uint32_t crc, const uint8_t *buf, size_t len)
+{
+    size_t i;
+    uint32_t c;
+    uint32_t k;
+    
+    if (gs_crc_inited == 0)
+    {
+        for (i = 0; i < 256; i++)
+        {
+            c = (uint32_t)i;
+            for (k = 0; k < 8; k++)
+            {
+                c = ((c & 1) != 0) ? (0xEDB88320U ^ (c >> 1)) : (c >> 1);
+            }
+            gs_crc_table[i] = c;
+        }
+        gs_crc_inited = 1;
+    }
+    crc = ~crc;
+    for (i = 0; i < len; i++)
+    {
+        crc = gs_crc_table[(crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
+    }
+    
+    return ~crc;
+}
+
+/**
+ * @brief     write a little endian value
+ * @param[in] *p pointer to a data buffer
+ * @param[in] v written value
+ * @param[in] len value bytes
+ * @note      none
+ */
+static void a_log_put(uint8_t *p, uint64_t v, uint8_t len)
+{
+    uint8_t i;
+    
+    for (i = 0; i < len; i++)
+    {
+        p[i] = (uint8_t)(v >> (i * 8));
+    }
+}
+
+/**
+ * @brief     read a little endian value
+ * @param[in] *p pointer to a data buffer
+ * @param[in] len value bytes
+ * @return    read value
+ * @note      none
+ */
+static uint64_t a_log_get(const uint8_t *p, uint8_t len)
+{
+    uint64_t v;
+    uint8_t i;
+    
+    v = 0;
+    for (i = 0; i < len; i++)
+    {
+        v |= (uint64_t)p[i] << (i * 8);
+    }
+    
+    return v;
+}
+
+/**
+ * @brief     write a varint
+ * @param[in] *p pointer to a data buffer
+ * @param[in] v written value
+ * @return    next write position
+ * @note      none
+ */
+static uint8_t *a_log_put_varint(uint8_t *p, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    
+    return p;
+}
+
+/**
+ * @brief      read a varint
+ * @param[in]  **p pointer to a read position, it is moved after the varint
+ * @param[in]  *end pointer to the buffer end
+ * @param[out] *v pointer to a value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 varint is truncated or too long
+ * @note       none
+ */
+static uint8_t a_log_get_varint(const uint8_t **p, const uint8_t *end, uint64_t *v)
+{
+    uint64_t r;
+    uint8_t shift;
+    uint8_t b;
+    
+    r = 0;
+    for (shift = 0; shift < 64; shift += 7)
+    {
+        if (*p >= end)
+        {
+            return 1;
+        }
+        b = *(*p)++;
+        r |= (uint64_t)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0)
+        {
+            *v = r;
+            
+            return 0;
+        }
+    }
+    
+    return 1;
+}
+
+/**
+ * @brief     zigzag encode
+ * @param[in] v signed value
+ * @return    unsigned value
+ * @note      none
+ */
+static uint64_t a_log_zigzag(int64_t v)
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+/**
+ * @brief     zigzag decode
+ * @param[in] v unsigned value
+ * @return    signed value
+ * @note      none
+ */
+static int64_t a_log_unzigzag(uint64_t v)
+{
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+/**
+ * @brief      convert a motion structure to a log sample
+ * @param[in]  *motion pointer to a motion structure
+ * @param[out] *sample pointer to a log sample structure
+ * @note       the sample is taken from the raw burst, so no motion and invalid samples are kept as read
+ */
+void pmw3901mb_log_motion_to_sample(const pmw3901mb_motion_t *motion, pmw3901mb_log_sample_t *sample)
+{
+    sample->timestamp_us = motion->timestamp_us;
+    sample->delta_x = (int16_t)(((uint16_t)motion->raw[3] << 8) | motion->raw[2]);
+    sample->delta_y = (int16_t)(((uint16_t)motion->raw[5] << 8) | motion->raw[4]);
+    sample->shutter = (uint16_t)(((uint16_t)motion->raw[10] << 8) | motion->raw[11]);
+    sample->motion = motion->raw[0];
+    sample->squal = motion->raw[6];
+}
+
+/**
+ * @brief      convert a log sample to a motion structure
+ * @param[in]  *sample pointer to a log sample structure
+ * @param[out] *motion pointer to a motion structure
+ * @note       the raw burst is rebuilt and decoded like the burst read,
+ *             observation, raw average, raw max and raw min are not logged and read as 0
+ */
+void pmw3901mb_log_sample_to_motion(const pmw3901mb_log_sample_t *sample, pmw3901mb_motion_t *motion)
+{
+    memset(motion, 0, sizeof(pmw3901mb_motion_t));
+    motion->raw[0] = sample->motion;
+    motion->raw[2] = (uint8_t)((uint16_t)sample->delta_x & 0xFF);
+    motion->raw[3] = (uint8_t)((uint16_t)sample->delta_x >> 8);
+    motion->raw[4] = (uint8_t)((uint16_t)sample->delta_y & 0xFF);
+    motion->raw[5] = (uint8_t)((uint16_t)sample->delta_y >> 8);
+    motion->raw[6] = sample->squal;
+    motion->raw[10] = (uint8_t)(sample->shutter >> 8);
+    motion->raw[11] = (uint8_t)(sample->shutter & 0xFF);
+    motion->timestamp_us = sample->timestamp_us;
+    if ((sample->motion & (1 << 7)) == 0)
+    {
+        motion->is_valid = 0;
+    }
+    else if ((motion->raw[6] < 0x19) || (motion->raw[10] == 0x1F))
+    {
+        motion->is_valid = 2;
+    }
+    else
+    {
+        motion->delta_x = sample->delta_x;
+        motion->delta_y = sample->delta_y;
+        motion->shutter = sample->shutter & 0x1FFF;
+        motion->surface_quality = (uint16_t)(sample->squal * 4);
+        motion->is_valid = 1;
+    }
+}
+
+/**
+ * @brief      encode one block
+ * @param[in]  *sample pointer to a log sample array
+ * @param[in]  count sample number, 1 to PMW3901MB_LOG_BLOCK_SAMPLES_MAX
+ * @param[out] *block pointer to a block buffer with at least
+ *             PMW3901MB_LOG_BLOCK_HEADER_SIZE + count * PMW3901MB_LOG_SAMPLE_SIZE_MAX bytes
+ * @return     block length, 0 means count is invalid
+ * @note       the payload keeps the delta of delta timestamps, zigzag delta_x and delta_y,
+ *             then the motion, squal and shutter runs, all as varints
+ */
+uint32_t pmw3901mb_log_encode_block(const pmw3901mb_log_sample_t *sample, uint16_t count, uint8_t *block)
+{
+    uint8_t *p;
+    int64_t delta;
+    int64_t last;
+    uint32_t payload_len;
+    uint32_t crc;
+    uint16_t i;
+    uint16_t run;
+    
+    if ((count == 0) || (count > PMW3901MB_LOG_BLOCK_SAMPLES_MAX))
+    {
+        return 0;
+    }
+    p = block + PMW3901MB_LOG_BLOCK_HEADER_SIZE;
+    
+    /* delta of delta timestamps from the first one */
+    last = 0;
+    for (i = 1; i < count; i++)
+    {
+        delta = (int64_t)(sample[i].timestamp_us - sample[i - 1].timestamp_us);
+        p = a_log_put_varint(p, a_log_zigzag(delta - last));
+        last = delta;
+    }
+    
+    /* deltas */
+    for (i = 0; i < count; i++)
+    {
+        p = a_log_put_varint(p, a_log_zigzag(sample[i].delta_x));
+    }
+    for (i = 0; i < count; i++)
+    {
+        p = a_log_put_varint(p, a_log_zigzag(sample[i].delta_y));
+    }
+    
+    /* motion, squal and shutter runs */
+    for (i = 0; i < count; i += run)
+    {
+        run = 1;
+        while (((i + run) < count) && (sample[i + run].motion == sample[i].motion))
+        {
+            run++;
+        }
+        p = a_log_put_varint(p, run);
+        *p++ = sample[i].motion;
+    }
+    for (i = 0; i < count; i += run)
+    {
+        run = 1;
+        while (((i + run) < count) && (sample[i + run].squal == sample[i].squal))
+        {
+            run++;
+        }
+        p = a_log_put_varint(p, run);
+        *p++ = sample[i].squal;
+    }
+    for (i = 0; i < count; i += run)
+    {
+        run = 1;
+        while (((i + run) < count) && (sample[i + run].shutter == sample[i].shutter))
+        {
+            run++;
+        }
+        p = a_log_put_varint(p, run);
+        p = a_log_put_varint(p, sample[i].shutter);
+    }
+    
+    /* header and checksum */
+    payload_len = (uint32_t)(p - block) - PMW3901MB_LOG_BLOCK_HEADER_SIZE;
+    a_log_put(block + 0, PMW3901MB_LOG_BLOCK_MAGIC, 4);
+    a_log_put(block + 4, payload_len, 4);
+    a_log_put(block + 8, count, 2);
+    a_log_put(block + 10, 0, 2);
+    a_log_put(block + 12, sample[0].timestamp_us, 8);
+    crc = a_log_crc32(0, block, 20);
+    crc = a_log_crc32(crc, block + PMW3901MB_LOG_BLOCK_HEADER_SIZE, payload_len);
+    a_log_put(block + 20, crc, 4);
+    
+    return PMW3901MB_LOG_BLOCK_HEADER_SIZE + payload_len;
+}
+
+/**
+ * @brief      decode the runs of one column
+ * @param[in]  **p pointer to a read position
+ * @param[in]  *end pointer to the payload end
+ * @param[out] *sample pointer to a log sample array
+ * @param[in]  count sample number
+ * @param[in]  column 0 motion, 1 squal, 2 shutter
+ * @return     status code
+ *             - 0 success
+ *             - 1 runs are invalid
+ * @note       none
+ */
+static uint8_t a_log_decode_runs(const uint8_t **p, const uint8_t *end, pmw3901mb_log_sample_t *sample,
+                                 uint16_t count, uint8_t column)
+{
+    uint64_t run;
+    uint64_t v;
+    uint32_t i;
+    uint32_t k;
+    
+    for (i = 0; i < count; i += (uint32_t)run)
+    {
+        if ((a_log_get_varint(p, end, &run) != 0) || (run == 0) || (run > (uint64_t)(count - i)))
+        {
+            return 1;
+        }
+        if (column == 2)
+        {
+            if ((a_log_get_varint(p, end, &v) != 0) || (v > 0xFFFF))
+            {
+                return 1;
+            }
+        }
+        else
+        {
+            if (*p >= end)
+            {
+                return 1;
+            }
+            v = *(*p)++;
+        }
+        for (k = i; k < i + (uint32_t)run; k++)
+        {
+            if (column == 0)
+            {
+                sample[k].motion = (uint8_t)v;
+            }
+            else if (column == 1)
+            {
+                sample[k].squal = (uint8_t)v;
+            }
+            else
+            {
+                sample[k].shutter = (uint16_t)v;
+            }
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      decode one block
+ * @param[in]  *block pointer to a block buffer
+ * @param[in]  len buffer length
+ * @param[out] *sample pointer to a log sample array with PMW3901MB_LOG_BLOCK_SAMPLES_MAX entries
+ * @param[out] *count pointer to a sample number buffer
+ * @param[out] *block_len pointer to a block length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 block is truncated or invalid
+ *             - 4 checksum error
+ * @note       block_len is set when the header is valid, so a block with a checksum error can be skipped
+ */
+uint8_t pmw3901mb_log_decode_block(const uint8_t *block, size_t len, pmw3901mb_log_sample_t *sample,
+                                   uint16_t *count, size_t *block_len)
+{
+    const uint8_t *p;
+    const uint8_t *end;
+    uint32_t payload_len;
+    uint32_t crc;
+    uint64_t v;
+    int64_t delta;
+    uint16_t n;
+    uint16_t i;
+    
+    /* header */
+    if (len < PMW3901MB_LOG_BLOCK_HEADER_SIZE)
+    {
+        return 1;
+    }
+    payload_len = (uint32_t)a_log_get(block + 4, 4);
+    n = (uint16_t)a_log_get(block + 8, 2);
+    if ((a_log_get(block, 4) != PMW3901MB_LOG_BLOCK_MAGIC) || (n == 0) || (n > PMW3901MB_LOG_BLOCK_SAMPLES_MAX) ||
+        (payload_len > (uint32_t)n * PMW3901MB_LOG_SAMPLE_SIZE_MAX))
+    {
+        return 1;
+    }
+    if (len - PMW3901MB_LOG_BLOCK_HEADER_SIZE < payload_len)
+    {
+        return 1;
+    }
+    *block_len = PMW3901MB_LOG_BLOCK_HEADER_SIZE + payload_len;
+    
+    /* checksum */
+    crc = a_log_crc32(0, block, 20);
+    crc = a_log_crc32(crc, block + PMW3901MB_LOG_BLOCK_HEADER_SIZE, payload_len);
+    if (crc != (uint32_t)a_log_get(block + 20, 4))
+    {
+        return 4;
+    }
+    p = block + PMW3901MB_LOG_BLOCK_HEADER_SIZE;
+    end = p + payload_len;
+    
+    /* timestamps */
+    sample[0].timestamp_us = a_log_get(block + 12, 8);
+    delta = 0;
+    for (i = 1; i < n; i++)
+    {
+        if (a_log_get_varint(&p, end, &v) != 0)
+        {
+            return 1;
+        }
+        delta += a_log_unzigzag(v);
+        sample[i].timestamp_us = sample[i - 1].timestamp_us + (uint64_t)delta;
+    }
+    
+    /* deltas */
+    for (i = 0; i < n; i++)
+    {
+        if (a_log_get_varint(&p, end, &v) != 0)
+        {
+            return 1;
+        }
+        sample[i].delta_x = (int16_t)a_log_unzigzag(v);
+    }
+    for (i = 0; i < n; i++)
+    {
+        if (a_log_get_varint(&p, end, &v) != 0)
+        {
+            return 1;
+        }
+        sample[i].delta_y = (int16_t)a_log_unzigzag(v);
+    }
+    
+    /* runs */
+    if ((a_log_decode_runs(&p, end, sample, n, 0) != 0) ||
+        (a_log_decode_runs(&p, end, sample, n, 1) != 0) ||
+        (a_log_decode_runs(&p, end, sample, n, 2) != 0) || (p != end))
+    {
+        return 1;
+    }
+    *count = n;
+    
+    return 0;
+}
+
+/**
+ * @brief      encode one frame
+ * @param[in]  **frame pointer to a frame buffer
+ * @param[in]  timestamp_us frame timestamp in us
+ * @param[out] *block pointer to a block buffer with at least
+ *             PMW3901MB_LOG_BLOCK_HEADER_SIZE + PMW3901MB_LOG_FRAME_SIZE bytes
+ * @return     block length
+ * @note       the frame is kept raw, row by row
+ */
+uint32_t pmw3901mb_log_encode_frame(uint8_t frame[35][35], uint64_t timestamp_us, uint8_t *block)
+{
+    uint32_t crc;
+    
+    memcpy(block + PMW3901MB_LOG_BLOCK_HEADER_SIZE, &frame[0][0], PMW3901MB_LOG_FRAME_SIZE);
+    a_log_put(block + 0, PMW3901MB_LOG_FRAME_MAGIC, 4);
+    a_log_put(block + 4, PMW3901MB_LOG_FRAME_SIZE, 4);
+    a_log_put(block + 8, 1, 2);
+    a_log_put(block + 10, 0, 2);
+    a_log_put(block + 12, timestamp_us, 8);
+    crc = a_log_crc32(0, block, 20);
+    crc = a_log_crc32(crc, block + PMW3901MB_LOG_BLOCK_HEADER_SIZE, PMW3901MB_LOG_FRAME_SIZE);
+    a_log_put(block + 20, crc, 4);
+    
+    return PMW3901MB_LOG_BLOCK_HEADER_SIZE + PMW3901MB_LOG_FRAME_SIZE;
+}
+
+/**
+ * @brief      decode one frame
+ * @param[in]  *block pointer to a block buffer
+ * @param[in]  len buffer length
+ * @param[out] **frame pointer to a frame pointer, it points into the block
+ * @param[out] *timestamp_us pointer to a timestamp buffer
+ * @param[out] *block_len pointer to a block length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 block is truncated or invalid
+ *             - 4 checksum error
+ * @note       nothing is copied, block_len is set when the header is valid
+ */
+uint8_t pmw3901mb_log_decode_frame(const uint8_t *block, size_t len, const uint8_t **frame,
+                                   uint64_t *timestamp_us, size_t *block_len)
+{
+    uint32_t crc;
+    
+    if ((len < PMW3901MB_LOG_BLOCK_HEADER_SIZE + PMW3901MB_LOG_FRAME_SIZE) ||
+        (a_log_get(block, 4) != PMW3901MB_LOG_FRAME_MAGIC) || (a_log_get(block + 4, 4) != PMW3901MB_LOG_FRAME_SIZE))
+    {
+        return 1;
+    }
+    *block_len = PMW3901MB_LOG_BLOCK_HEADER_SIZE + PMW3901MB_LOG_FRAME_SIZE;
+    crc = a_log_crc32(0, block, 20);
+    crc = a_log_crc32(crc, block + PMW3901MB_LOG_BLOCK_HEADER_SIZE, PMW3901MB_LOG_FRAME_SIZE);
+    if (crc != (uint32_t)a_log_get(block + 20, 4))
+    {
+        return 4;
+    }
+    *frame = block + PMW3901MB_LOG_BLOCK_HEADER_SIZE;
+    *timestamp_us = a_log_get(block + 12, 8);
+    
+    return 0;
+}
+
+/**
+ * @brief     open a log for writing
+ * @param[in] *writer pointer to a log writer structure
+ * @param[in] *path pointer to a log file path
+ * @param[in] block_samples samples in one block, 0 means the default
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      none
+ */
+uint8_t pmw3901mb_log_writer_open(pmw3901mb_log_writer_t *writer, const char *path, uint16_t block_samples)
+{
+    uint8_t header[PMW3901MB_LOG_HEADER_SIZE];
+    
+    if ((writer == NULL) || (path == NULL) || (block_samples > PMW3901MB_LOG_BLOCK_SAMPLES_MAX))
+    {
+        return 1;
+    }
+    memset(writer, 0, sizeof(pmw3901mb_log_writer_t));
+    writer->block_samples = (block_samples == 0) ? PMW3901MB_LOG_BLOCK_SAMPLES_DEFAULT : block_samples;
+    writer->sample = (pmw3901mb_log_sample_t *)malloc(sizeof(pmw3901mb_log_sample_t) * writer->block_samples);
+    writer->block = (uint8_t *)malloc(PMW3901MB_LOG_BLOCK_HEADER_SIZE +
+                                      (size_t)writer->block_samples * PMW3901MB_LOG_SAMPLE_SIZE_MAX);
+    writer->fp = fopen(path, "wb");
+    if ((writer->sample == NULL) || (writer->block == NULL) || (writer->fp == NULL))
+    {
+        goto failed;
+    }
+    
+    /* file header */
+    memset(header, 0, sizeof(header));
+    a_log_put(header + 0, PMW3901MB_LOG_MAGIC, 4);
+    header[4] = PMW3901MB_LOG_VERSION;
+    header[5] = PMW3901MB_LOG_HEADER_SIZE;
+    a_log_put(header + 6, writer->block_samples, 2);
+    if (fwrite(header, 1, sizeof(header), writer->fp) != sizeof(header))
+    {
+        goto failed;
+    }
+    writer->bytes = sizeof(header);
+    
+    return 0;
+    
+    failed:
+    if (writer->fp != NULL)
+    {
+        (void)fclose(writer->fp);
+    }
+    free(writer->sample);
+    free(writer->block);
+    memset(writer, 0, sizeof(pmw3901mb_log_writer_t));
+    
+    return 1;
+}
+
+/**
+ * @brief     write the buffered samples as a short block
+ * @param[in] *writer pointer to a log writer structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ * @note      none
+ */
+uint8_t pmw3901mb_log_writer_flush(pmw3901mb_log_writer_t *writer)
+{
+    uint32_t len;
+    
+    if ((writer == NULL) || (writer->fp == NULL))
+    {
+        return 1;
+    }
+    if (writer->count == 0)
+    {
+        return 0;
+    }
+    len = pmw3901mb_log_encode_block(writer->sample, writer->count, writer->block);
+    if (fwrite(writer->block, 1, len, writer->fp) != len)
+    {
+        return 1;
+    }
+    writer->blocks++;
+    writer->samples += writer->count;
+    writer->bytes += len;
+    writer->count = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief     write motion samples
+ * @param[in] *writer pointer to a log writer structure
+ * @param[in] *motion pointer to a motion array
+ * @param[in] n sample number
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      a block is written each time it is full
+ */
+uint8_t pmw3901mb_log_writer_write(pmw3901mb_log_writer_t *writer, const pmw3901mb_motion_t *motion, uint32_t n)
+{
+    uint32_t i;
+    
+    if ((writer == NULL) || (writer->fp == NULL) || ((motion == NULL) && (n != 0)))
+    {
+        return 1;
+    }
+    for (i = 0; i < n; i++)
+    {
+        pmw3901mb_log_motion_to_sample(&motion[i], &writer->sample[writer->count]);
+        writer->count++;
+        if (writer->count == writer->block_samples)
+        {
+            if (pmw3901mb_log_writer_flush(writer) != 0)
+            {
+                return 1;
+            }
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     write a frame
+ * @param[in] *writer pointer to a log writer structure
+ * @param[in] **frame pointer to a frame buffer
+ * @param[in] timestamp_us frame timestamp in us
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the buffered samples are flushed first to keep the log in time order
+ */
+uint8_t pmw3901mb_log_writer_write_frame(pmw3901mb_log_writer_t *writer, uint8_t frame[35][35], uint64_t timestamp_us)
+{
+    uint32_t len;
+    
+    if ((writer == NULL) || (writer->fp == NULL) || (frame == NULL))
+    {
+        return 1;
+    }
+    if (pmw3901mb_log_writer_flush(writer) != 0)
+    {
+        return 1;
+    }
+    len = pmw3901mb_log_encode_frame(frame, timestamp_us, writer->block);
+    if (fwrite(writer->block, 1, len, writer->fp) != len)
+    {
+        return 1;
+    }
+    writer->frames++;
+    writer->bytes += len;
+    
+    return 0;
+}
+
+/**
+ * @brief     flush and close a log writer
+ * @param[in] *writer pointer to a log writer structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 close failed
+ * @note      none
+ */
+uint8_t pmw3901mb_log_writer_close(pmw3901mb_log_writer_t *writer)
+{
+    uint8_t res;
+    
+    if ((writer == NULL) || (writer->fp == NULL))
+    {
+        return 1;
+    }
+    res = pmw3901mb_log_writer_flush(writer);
+    if (fclose(writer->fp) != 0)
+    {
+        res = 1;
+    }
+    writer->fp = NULL;
+    free(writer->sample);
+    free(writer->block);
+    writer->sample = NULL;
+    writer->block = NULL;
+    
+    return res;
+}
+
+/**
+ * @brief     open a log for reading
+ * @param[in] *reader pointer to a log reader structure
+ * @param[in] *path pointer to a log file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ *            - 4 not a log
+ * @note      none
+ */
+uint8_t pmw3901mb_log_reader_open(pmw3901mb_log_reader_t *reader, const char *path)
+{
+    uint8_t header[PMW3901MB_LOG_HEADER_SIZE];
+    uint8_t res;
+    
+    if ((reader == NULL) || (path == NULL))
+    {
+        return 1;
+    }
+    memset(reader, 0, sizeof(pmw3901mb_log_reader_t));
+    reader->fp = fopen(path, "rb");
+    if (reader->fp == NULL)
+    {
+        return 1;
+    }
+    
+    /* file header */
+    res = 4;
+    if (fread(header, 1, sizeof(header), reader->fp) != sizeof(header))
+    {
+        goto failed;
+    }
+    reader->block_samples = (uint16_t)a_log_get(header + 6, 2);
+    if ((a_log_get(header, 4) != PMW3901MB_LOG_MAGIC) || (header[4] != PMW3901MB_LOG_VERSION) ||
+        (header[5] < PMW3901MB_LOG_HEADER_SIZE) || (reader->block_samples == 0) ||
+        (reader->block_samples > PMW3901MB_LOG_BLOCK_SAMPLES_MAX))
+    {
+        goto failed;
+    }
+    if (fseek(reader->fp, header[5], SEEK_SET) != 0)
+    {
+        goto failed;
+    }
+    res = 1;
+    reader->sample = (pmw3901mb_log_sample_t *)malloc(sizeof(pmw3901mb_log_sample_t) * PMW3901MB_LOG_BLOCK_SAMPLES_MAX);
+    reader->block = (uint8_t *)malloc(PMW3901MB_LOG_BLOCK_HEADER_SIZE +
+                                      (size_t)PMW3901MB_LOG_BLOCK_SAMPLES_MAX * PMW3901MB_LOG_SAMPLE_SIZE_MAX);
+    if ((reader->sample == NULL) || (reader->block == NULL))
+    {
+        goto failed;
+    }
+    
+    return 0;
+    
+    failed:
+    (void)fclose(reader->fp);
+    free(reader->sample);
+    free(reader->block);
+    memset(reader, 0, sizeof(pmw3901mb_log_reader_t));
+    
+    return res;
+}
+
+/**
+ * @brief      load the next block
+ * @param[in]  *reader pointer to a log reader structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 2 end of the log
+ *             - 4 checksum error
+ * @note       none
+ */
+static uint8_t a_log_reader_next(pmw3901mb_log_reader_t *reader)
+{
+    uint8_t *h;
+    size_t payload_len;
+    size_t block_len;
+    size_t l;
+    uint8_t res;
+    
+    h = reader->block;
+    while (1)
+    {
+        reader->offset = (uint64_t)ftello(reader->fp);
+        l = fread(h, 1, PMW3901MB_LOG_BLOCK_HEADER_SIZE, reader->fp);
+        if (l == 0)
+        {
+            return 2;
+        }
+        if (l != PMW3901MB_LOG_BLOCK_HEADER_SIZE)
+        {
+            return 1;
+        }
+        if (a_log_get(h, 4) != PMW3901MB_LOG_FRAME_MAGIC)
+        {
+            break;
+        }
+        if (fseeko(reader->fp, (off_t)a_log_get(h + 4, 4), SEEK_CUR) != 0)             /* skip the frame */
+        {
+            return 1;
+        }
+        reader->frames++;
+    }
+    if (a_log_get(h, 4) != PMW3901MB_LOG_BLOCK_MAGIC)
+    {
+        return 1;
+    }
+    payload_len = (size_t)a_log_get(h + 4, 4);
+    if (payload_len > (size_t)PMW3901MB_LOG_BLOCK_SAMPLES_MAX * PMW3901MB_LOG_SAMPLE_SIZE_MAX)
+    {
+        return 1;
+    }
+    if (fread(h + PMW3901MB_LOG_BLOCK_HEADER_SIZE, 1, payload_len, reader->fp) != payload_len)
+    {
+        return 1;
+    }
+    res = pmw3901mb_log_decode_block(h, PMW3901MB_LOG_BLOCK_HEADER_SIZE + payload_len, reader->sample,
+                                     &reader->count, &block_len);
+    reader->pos = 0;
+    reader->blocks++;
+    if (res != 0)
+    {
+        reader->count = 0;
+        reader->bad_blocks++;
+    }
+    
+    return res;
+}
+
+/**
+ * @brief      read motion samples
+ * @param[in]  *reader pointer to a log reader structure
+ * @param[out] *motion pointer to a motion array
+ * @param[in]  n array length
+ * @param[out] *num pointer to a read samples buffer, 0 means the end of the log
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 4 checksum error
+ * @note       a block with a checksum error is skipped and counted in bad_blocks, the next read goes on,
+ *             frames are skipped and counted in frames
+ */
+uint8_t pmw3901mb_log_reader_read(pmw3901mb_log_reader_t *reader, pmw3901mb_motion_t *motion, uint32_t n, uint32_t *num)
+{
+    uint32_t i;
+    uint8_t res;
+    
+    if ((reader == NULL) || (reader->fp == NULL) || (num == NULL) || ((motion == NULL) && (n != 0)))
+    {
+        return 1;
+    }
+    for (i = 0; i < n; i++)
+    {
+        if (reader->pos == reader->count)
+        {
+            res = a_log_reader_next(reader);
+            if (res == 2)
+            {
+                break;
+            }
+            if (res != 0)
+            {
+                *num = i;
+                
+                return res;
+            }
+        }
+        pmw3901mb_log_sample_to_motion(&reader->sample[reader->pos], &motion[i]);
+        reader->pos++;
+    }
+    *num = i;
+    
+    return 0;
+}
+
+/**
+ * @brief      read the next block
+ * @param[in]  *reader pointer to a log reader structure
+ * @param[out] *count pointer to a sample number buffer, 0 means the end of the log
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 4 checksum error
+ * @note       the samples are left in reader->sample and reader->offset is the block offset,
+ *             the next pmw3901mb_log_reader_read starts at reader->pos
+ */
+uint8_t pmw3901mb_log_reader_read_block(pmw3901mb_log_reader_t *reader, uint16_t *count)
+{
+    uint8_t res;
+    
+    if ((reader == NULL) || (reader->fp == NULL) || (count == NULL))
+    {
+        return 1;
+    }
+    *count = 0;
+    res = a_log_reader_next(reader);
+    if (res == 2)
+    {
+        return 0;
+    }
+    *count = reader->count;
+    
+    return res;
+}
+
+/**
+ * @brief     seek to a block
+ * @param[in] *reader pointer to a log reader structure
+ * @param[in] offset block offset, a reader->offset seen before
+ * @return    status code
+ *            - 0 success
+ *            - 1 seek failed
+ * @note      the buffered samples are dropped
+ */
+uint8_t pmw3901mb_log_reader_seek(pmw3901mb_log_reader_t *reader, uint64_t offset)
+{
+    if ((reader == NULL) || (reader->fp == NULL))
+    {
+        return 1;
+    }
+    reader->count = 0;
+    reader->pos = 0;
+    if (fseeko(reader->fp, (off_t)offset, SEEK_SET) != 0)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     close a log reader
+ * @param[in] *reader pointer to a log reader structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t pmw3901mb_log_reader_close(pmw3901mb_log_reader_t *reader)
+{
+    if ((reader == NULL) || (reader->fp == NULL))
+    {
+        return 0;
+    }
+    (void)fclose(reader->fp);
+    free(reader->sample);
+    free(reader->block);
+    memset(reader, 0, sizeof(pmw3901mb_log_reader_t));
+    
+    return 0;
+}
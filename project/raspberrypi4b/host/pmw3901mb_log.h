@@ -0,0 +1,310 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_log.h
+ * @brief     pmw3901mb binary motion log header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef PMW3901MB_LOG_H
+#define PMW3901MB_LOG_H
+
+#include "driver_pmw3901mb.h"
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup pmw3901mb_log pmw3901mb log function
+ * @brief    pmw3901mb binary motion log modules
+ * @ingroup  pmw3901mb_driver
+ * @{
+ */
+
+/**
+ * @brief pmw3901mb log format definition
+ */
+#define PMW3901MB_LOG_MAGIC                  0x4C574D50        /**< "PMWL" in little endian */
+#define PMW3901MB_LOG_BLOCK_MAGIC            0x42574D50        /**< "PMWB" in little endian */
+#define PMW3901MB_LOG_FRAME_MAGIC            0x46574D50        /**< "PMWF" in little endian */
+#define PMW3901MB_LOG_VERSION                1                 /**< log version */
+#define PMW3901MB_LOG_HEADER_SIZE            16                /**< file header size */
+#define PMW3901MB_LOG_BLOCK_HEADER_SIZE      24                /**< block header size */
+#define PMW3901MB_LOG_BLOCK_SAMPLES_MAX      4096              /**< max samples in one block */
+#define PMW3901MB_LOG_BLOCK_SAMPLES_DEFAULT  1024              /**< default samples in one block */
+#define PMW3901MB_LOG_SAMPLE_SIZE_MAX        32                /**< max encoded bytes of one sample */
+#define PMW3901MB_LOG_FRAME_SIZE             (35 * 35)         /**< raw bytes of one frame */
+
+/**
+ * @brief pmw3901mb log sample structure definition
+ */
+typedef struct pmw3901mb_log_sample_s
+{
+    uint64_t timestamp_us;        /**< burst read timestamp in us */
+    int16_t delta_x;              /**< raw delta_x */
+    int16_t delta_y;              /**< raw delta_y */
+    uint16_t shutter;             /**< shutter upper register << 8 | shutter lower register */
+    uint8_t motion;               /**< motion register */
+    uint8_t squal;                /**< squal register */
+} pmw3901mb_log_sample_t;
+
+/**
+ * @brief pmw3901mb log writer structure definition
+ */
+typedef struct pmw3901mb_log_writer_s
+{
+    FILE *fp;                              /**< log file */
+    pmw3901mb_log_sample_t *sample;        /**< block samples */
+    uint8_t *block;                        /**< encoded block */
+    uint16_t block_samples;                /**< samples in one block */
+    uint16_t count;                        /**< buffered samples */
+    uint32_t blocks;                       /**< written blocks */
+    uint32_t frames;                       /**< written frames */
+    uint64_t samples;                      /**< written samples */
+    uint64_t bytes;                        /**< written bytes */
+} pmw3901mb_log_writer_t;
+
+/**
+ * @brief pmw3901mb log reader structure definition
+ */
+typedef struct pmw3901mb_log_reader_s
+{
+    FILE *fp;                              /**< log file */
+    pmw3901mb_log_sample_t *sample;        /**< block samples */
+    uint8_t *block;                        /**< encoded block */
+    uint16_t block_samples;                /**< samples in one block */
+    uint16_t count;                        /**< decoded samples */
+    uint16_t pos;                          /**< next sample */
+    uint64_t offset;                       /**< current block offset */
+    uint32_t blocks;                       /**< read blocks */
+    uint32_t bad_blocks;                   /**< blocks with a checksum error */
+    uint32_t frames;                       /**< skipped frames */
+} pmw3901mb_log_reader_t;
+
+/**
+ * @brief      convert a motion structure to a log sample
+ * @param[in]  *motion pointer to a motion structure
+ * @param[out] *sample pointer to a log sample structure
+ * @note       the sample is taken from the raw burst, so no motion and invalid samples are kept as read
+ */
+void pmw3901mb_log_motion_to_sample(const pmw3901mb_motion_t *motion, pmw3901mb_log_sample_t *sample);
+
+/**
+ * @brief      convert a log sample to a motion structure
+ * @param[in]  *sample pointer to a log sample structure
+ * @param[out] *motion pointer to a motion structure
+ * @note       the raw burst is rebuilt and decoded like the burst read,
+ *             observation, raw average, raw max and raw min are not logged and read as 0
+ */
+void pmw3901mb_log_sample_to_motion(const pmw3901mb_log_sample_t *sample, pmw3901mb_motion_t *motion);
+
+/**
+ * @brief      encode one block
+ * @param[in]  *sample pointer to a log sample array
+ * @param[in]  count sample number, 1 to PMW3901MB_LOG_BLOCK_SAMPLES_MAX
+ * @param[out] *block pointer to a block buffer with at least
+ *             PMW3901MB_LOG_BLOCK_HEADER_SIZE + count * PMW3901MB_LOG_SAMPLE_SIZE_MAX bytes
+ * @return     block length, 0 means count is invalid
+ * @note       the payload keeps the delta of delta timestamps, zigzag delta_x and delta_y,
+ *             then the motion, squal and shutter runs, all as varints
+ */
+uint32_t pmw3901mb_log_encode_block(const pmw3901mb_log_sample_t *sample, uint16_t count, uint8_t *block);
+
+/**
+ * @brief      decode one block
+ * @param[in]  *block pointer to a block buffer
+ * @param[in]  len buffer length
+ * @param[out] *sample pointer to a log sample array with PMW3901MB_LOG_BLOCK_SAMPLES_MAX entries
+ * @param[out] *count pointer to a sample number buffer
+ * @param[out] *block_len pointer to a block length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 block is truncated or invalid
+ *             - 4 checksum error
+ * @note       block_len is set when the header is valid, so a block with a checksum error can be skipped
+ */
+uint8_t pmw3901mb_log_decode_block(const uint8_t *block, size_t len, pmw3901mb_log_sample_t *sample,
+                                   uint16_t *count, size_t *block_len);
+
+/**
+ * @brief      encode one frame
+ * @param[in]  **frame pointer to a frame buffer
+ * @param[in]  timestamp_us frame timestamp in us
+ * @param[out] *block pointer to a block buffer with at least
+ *             PMW3901MB_LOG_BLOCK_HEADER_SIZE + PMW3901MB_LOG_FRAME_SIZE bytes
+ * @return     block length
+ * @note       the frame is kept raw, row by row
+ */
+uint32_t pmw3901mb_log_encode_frame(uint8_t frame[35][35], uint64_t timestamp_us, uint8_t *block);
+
+/**
+ * @brief      decode one frame
+ * @param[in]  *block pointer to a block buffer
+ * @param[in]  len buffer length
+ * @param[out] **frame pointer to a frame pointer, it points into the block
+ * @param[out] *timestamp_us pointer to a timestamp buffer
+ * @param[out] *block_len pointer to a block length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 block is truncated or invalid
+ *             - 4 checksum error
+ * @note       nothing is copied, block_len is set when the header is valid
+ */
+uint8_t pmw3901mb_log_decode_frame(const uint8_t *block, size_t len, const uint8_t **frame,
+                                   uint64_t *timestamp_us, size_t *block_len);
+
+/**
+ * @brief     open a log for writing
+ * @param[in] *writer pointer to a log writer structure
+ * @param[in] *path pointer to a log file path
+ * @param[in] block_samples samples in one block, 0 means the default
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ * @note      none
+ */
+uint8_t pmw3901mb_log_writer_open(pmw3901mb_log_writer_t *writer, const char *path, uint16_t block_samples);
+
+/**
+ * @brief     write motion samples
+ * @param[in] *writer pointer to a log writer structure
+ * @param[in] *motion pointer to a motion array
+ * @param[in] n sample number
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      a block is written each time it is full
+ */
+uint8_t pmw3901mb_log_writer_write(pmw3901mb_log_writer_t *writer, const pmw3901mb_motion_t *motion, uint32_t n);
+
+/**
+ * @brief     write the buffered samples as a short block
+ * @param[in] *writer pointer to a log writer structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 flush failed
+ * @note      none
+ */
+uint8_t pmw3901mb_log_writer_flush(pmw3901mb_log_writer_t *writer);
+
+/**
+ * @brief     write a frame
+ * @param[in] *writer pointer to a log writer structure
+ * @param[in] **frame pointer to a frame buffer
+ * @param[in] timestamp_us frame timestamp in us
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the buffered samples are flushed first to keep the log in time order
+ */
+uint8_t pmw3901mb_log_writer_write_frame(pmw3901mb_log_writer_t *writer, uint8_t frame[35][35], uint64_t timestamp_us);
+
+/**
+ * @brief     flush and close a log writer
+ * @param[in] *writer pointer to a log writer structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 close failed
+ * @note      none
+ */
+uint8_t pmw3901mb_log_writer_close(pmw3901mb_log_writer_t *writer);
+
+/**
+ * @brief     open a log for reading
+ * @param[in] *reader pointer to a log reader structure
+ * @param[in] *path pointer to a log file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ *            - 4 not a log
+ * @note      none
+ */
+uint8_t pmw3901mb_log_reader_open(pmw3901mb_log_reader_t *reader, const char *path);
+
+/**
+ * @brief      read motion samples
+ * @param[in]  *reader pointer to a log reader structure
+ * @param[out] *motion pointer to a motion array
+ * @param[in]  n array length
+ * @param[out] *num pointer to a read samples buffer, 0 means the end of the log
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 4 checksum error
+ * @note       a block with a checksum error is skipped and counted in bad_blocks, the next read goes on,
+ *             frames are skipped and counted in frames
+ */
+uint8_t pmw3901mb_log_reader_read(pmw3901mb_log_reader_t *reader, pmw3901mb_motion_t *motion, uint32_t n, uint32_t *num);
+
+/**
+ * @brief      read the next block
+ * @param[in]  *reader pointer to a log reader structure
+ * @param[out] *count pointer to a sample number buffer, 0 means the end of the log
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 4 checksum error
+ * @note       the samples are left in reader->sample and reader->offset is the block offset,
+ *             the next pmw3901mb_log_reader_read starts at reader->pos
+ */
+uint8_t pmw3901mb_log_reader_read_block(pmw3901mb_log_reader_t *reader, uint16_t *count);
+
+/**
+ * @brief     seek to a block
+ * @param[in] *reader pointer to a log reader structure
+ * @param[in] offset block offset, a reader->offset seen before
+ * @return    status code
+ *            - 0 success
+ *            - 1 seek failed
+ * @note      the buffered samples are dropped
+ */
+uint8_t pmw3901mb_log_reader_seek(pmw3901mb_log_reader_t *reader, uint64_t offset);
+
+/**
+ * @brief     close a log reader
+ * @param[in] *reader pointer to a log reader structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t pmw3901mb_log_reader_close(pmw3901mb_log_reader_t *reader);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
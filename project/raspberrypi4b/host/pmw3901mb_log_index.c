@@ -0,0 +1,626 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_log_index.c
+ * @brief     pmw3901mb motion log index source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "pmw3901mb_log_index.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief     write a little endian value
+ * @param[in] *p pointer to a data buffer
+ * @param[in] v written value
+ * @param[in] len value bytes
+ * @note      none
+ */
+static void a_index_put(uint8_t *p, uint64_t v, uint8_t len)
+{
+    uint8_t i;
+    
+    for (i = 0; i < len; i++)
+    {
+        p[i] = (uint8_t)(v >> (i * 8));
+    }
+}
+
+/**
+ * @brief     read a little endian value
+ * @param[in] *p pointer to a data buffer
+ * @param[in] len value bytes
+ * @return    read value
+ * @note      none
+ */
+static uint64_t a_index_get(const uint8_t *p, uint8_t len)
+{
+    uint64_t v;
+    uint8_t i;
+    
+    v = 0;
+    for (i = 0; i < len; i++)
+    {
+        v |= (uint64_t)p[i] << (i * 8);
+    }
+    
+    return v;
+}
+
+/**
+ * @brief     check a log sample
+ * @param[in] *sample pointer to a log sample
+ * @return    1 if the sample is valid
+ * @note      same rule as is_valid == 1 of the burst read
+ */
+static uint8_t a_index_valid(const pmw3901mb_log_sample_t *sample)
+{
+    return (uint8_t)(((sample->motion & (1 << 7)) != 0) && (sample->squal >= 0x19) && ((sample->shutter >> 8) != 0x1F));
+}
+
+/**
+ * @brief      get the log size
+ * @param[in]  *fp pointer to a log file
+ * @param[out] *bytes pointer to a size buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get failed
+ * @note       the file position is moved to the end
+ */
+static uint8_t a_index_log_bytes(FILE *fp, uint64_t *bytes)
+{
+    off_t size;
+    
+    if (fseeko(fp, 0, SEEK_END) != 0)
+    {
+        return 1;
+    }
+    size = ftello(fp);
+    if (size < 0)
+    {
+        return 1;
+    }
+    *bytes = (uint64_t)size;
+    
+    return 0;
+}
+
+/**
+ * @brief     load one indexed block into the reader
+ * @param[in] *index pointer to a log index structure
+ * @param[in] b entry index
+ * @return    status code
+ *            - 0 success
+ *            - 1 load failed
+ *            - 4 checksum error
+ * @note      none
+ */
+static uint8_t a_index_load_block(pmw3901mb_log_index_t *index, uint32_t b)
+{
+    uint16_t count;
+    uint8_t res;
+    
+    if (pmw3901mb_log_reader_seek(&index->reader, index->entry[b].offset) != 0)
+    {
+        return 1;
+    }
+    res = pmw3901mb_log_reader_read_block(&index->reader, &count);
+    if (res != 0)
+    {
+        return res;
+    }
+    if (count == 0)
+    {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      get the valid delta sums before a time
+ * @param[in]  *index pointer to a log index structure
+ * @param[in]  t timestamp in us
+ * @param[out] *sum_x pointer to a delta_x sum buffer
+ * @param[out] *sum_y pointer to a delta_y sum buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get failed
+ *             - 4 checksum error
+ * @note       sums the valid samples with timestamp < t
+ */
+static uint8_t a_index_prefix(pmw3901mb_log_index_t *index, uint64_t t, int64_t *sum_x, int64_t *sum_y)
+{
+    const pmw3901mb_log_index_entry_t *e;
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t mid;
+    uint16_t k;
+    uint8_t res;
+    
+    lo = 0;
+    hi = index->blocks;
+    while (lo < hi)                                                              /* count the blocks starting before t */
+    {
+        mid = lo + (hi - lo) / 2;
+        if (index->entry[mid].t_first < t)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if (lo == 0)                                                                 /* t is before the log */
+    {
+        *sum_x = 0;
+        *sum_y = 0;
+        
+        return 0;
+    }
+    e = &index->entry[lo - 1];
+    if (t > e->t_last)                                                           /* t is between two blocks */
+    {
+        *sum_x = (lo < index->blocks) ? index->entry[lo].sum_x : index->sum_x;
+        *sum_y = (lo < index->blocks) ? index->entry[lo].sum_y : index->sum_y;
+        
+        return 0;
+    }
+    res = a_index_load_block(index, lo - 1);                                     /* t is inside the block */
+    if (res != 0)
+    {
+        return res;
+    }
+    *sum_x = e->sum_x;
+    *sum_y = e->sum_y;
+    for (k = 0; (k < index->reader.count) && (index->reader.sample[k].timestamp_us < t); k++)
+    {
+        if (a_index_valid(&index->reader.sample[k]) != 0)
+        {
+            *sum_x += index->reader.sample[k].delta_x;
+            *sum_y += index->reader.sample[k].delta_y;
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     build an index by scanning a log
+ * @param[in] *index pointer to a log index structure
+ * @param[in] *path pointer to a log file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 build failed
+ *            - 4 not a log
+ * @note      blocks with a checksum error are left out and counted in bad_blocks
+ */
+uint8_t pmw3901mb_log_index_build(pmw3901mb_log_index_t *index, const char *path)
+{
+    pmw3901mb_log_index_entry_t *entry;
+    pmw3901mb_log_index_entry_t *e;
+    uint32_t cap;
+    uint16_t count;
+    uint16_t k;
+    uint8_t res;
+    
+    if ((index == NULL) || (path == NULL))
+    {
+        return 1;
+    }
+    memset(index, 0, sizeof(pmw3901mb_log_index_t));
+    res = pmw3901mb_log_reader_open(&index->reader, path);
+    if (res != 0)
+    {
+        return res;
+    }
+    cap = 0;
+    while (1)                                                                    /* scan all blocks */
+    {
+        res = pmw3901mb_log_reader_read_block(&index->reader, &count);
+        if (res == 4)                                                            /* leave out the bad block */
+        {
+            index->bad_blocks++;
+            
+            continue;
+        }
+        if (res != 0)
+        {
+            goto failed;
+        }
+        if (count == 0)                                                          /* end of the log */
+        {
+            break;
+        }
+        if (index->blocks == cap)                                                /* grow the entries */
+        {
+            cap = (cap == 0) ? 64 : cap * 2;
+            entry = (pmw3901mb_log_index_entry_t *)realloc(index->entry, sizeof(pmw3901mb_log_index_entry_t) * cap);
+            if (entry == NULL)
+            {
+                goto failed;
+            }
+            index->entry = entry;
+        }
+        e = &index->entry[index->blocks];
+        e->offset = index->reader.offset;
+        e->t_first = index->reader.sample[0].timestamp_us;
+        e->t_last = index->reader.sample[count - 1].timestamp_us;
+        e->sample = index->samples;
+        e->sum_x = index->sum_x;
+        e->sum_y = index->sum_y;
+        for (k = 0; k < count; k++)
+        {
+            if (a_index_valid(&index->reader.sample[k]) != 0)
+            {
+                index->sum_x += index->reader.sample[k].delta_x;
+                index->sum_y += index->reader.sample[k].delta_y;
+            }
+        }
+        index->samples += count;
+        index->blocks++;
+    }
+    if (a_index_log_bytes(index->reader.fp, &index->log_bytes) != 0)
+    {
+        goto failed;
+    }
+    
+    return 0;
+    
+    failed:
+    (void)pmw3901mb_log_index_close(index);
+    
+    return 1;
+}
+
+/**
+ * @brief     save an index
+ * @param[in] *index pointer to a log index structure
+ * @param[in] *path pointer to an index file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 save failed
+ * @note      none
+ */
+uint8_t pmw3901mb_log_index_save(pmw3901mb_log_index_t *index, const char *path)
+{
+    uint8_t buf[PMW3901MB_LOG_INDEX_HEADER_SIZE];
+    const pmw3901mb_log_index_entry_t *e;
+    FILE *fp;
+    uint32_t i;
+    uint8_t res;
+    
+    if ((index == NULL) || (index->reader.fp == NULL) || (path == NULL))
+    {
+        return 1;
+    }
+    fp = fopen(path, "wb");
+    if (fp == NULL)
+    {
+        return 1;
+    }
+    memset(buf, 0, sizeof(buf));
+    a_index_put(buf + 0, PMW3901MB_LOG_INDEX_MAGIC, 4);
+    buf[4] = PMW3901MB_LOG_INDEX_VERSION;
+    buf[5] = PMW3901MB_LOG_INDEX_ENTRY_SIZE;
+    a_index_put(buf + 8, index->blocks, 4);
+    a_index_put(buf + 12, index->bad_blocks, 4);
+    a_index_put(buf + 16, index->log_bytes, 8);
+    a_index_put(buf + 24, index->samples, 8);
+    a_index_put(buf + 32, (uint64_t)index->sum_x, 8);
+    a_index_put(buf + 40, (uint64_t)index->sum_y, 8);
+    res = (fwrite(buf, 1, PMW3901MB_LOG_INDEX_HEADER_SIZE, fp) != PMW3901MB_LOG_INDEX_HEADER_SIZE);
+    for (i = 0; (i < index->blocks) && (res == 0); i++)
+    {
+        e = &index->entry[i];
+        a_index_put(buf + 0, e->offset, 8);
+        a_index_put(buf + 8, e->t_first, 8);
+        a_index_put(buf + 16, e->t_last, 8);
+        a_index_put(buf + 24, e->sample, 8);
+        a_index_put(buf + 32, (uint64_t)e->sum_x, 8);
+        a_index_put(buf + 40, (uint64_t)e->sum_y, 8);
+        res = (fwrite(buf, 1, PMW3901MB_LOG_INDEX_ENTRY_SIZE, fp) != PMW3901MB_LOG_INDEX_ENTRY_SIZE);
+    }
+    if (fclose(fp) != 0)
+    {
+        res = 1;
+    }
+    
+    return res;
+}
+
+/**
+ * @brief     load an index
+ * @param[in] *index pointer to a log index structure
+ * @param[in] *path pointer to a log file path
+ * @param[in] *index_path pointer to an index file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 load failed
+ *            - 4 not an index or the index is stale
+ * @note      the index is stale when the log size has changed since it was built
+ */
+uint8_t pmw3901mb_log_index_load(pmw3901mb_log_index_t *index, const char *path, const char *index_path)
+{
+    uint8_t buf[PMW3901MB_LOG_INDEX_HEADER_SIZE];
+    pmw3901mb_log_index_entry_t *e;
+    uint64_t log_bytes;
+    FILE *fp;
+    uint32_t i;
+    uint8_t res;
+    
+    if ((index == NULL) || (path == NULL) || (index_path == NULL))
+    {
+        return 1;
+    }
+    memset(index, 0, sizeof(pmw3901mb_log_index_t));
+    fp = fopen(index_path, "rb");
+    if (fp == NULL)
+    {
+        return 1;
+    }
+    res = pmw3901mb_log_reader_open(&index->reader, path);
+    if (res != 0)
+    {
+        (void)fclose(fp);
+        
+        return res;
+    }
+    
+    /* header */
+    res = 4;
+    if (fread(buf, 1, PMW3901MB_LOG_INDEX_HEADER_SIZE, fp) != PMW3901MB_LOG_INDEX_HEADER_SIZE)
+    {
+        goto failed;
+    }
+    if ((a_index_get(buf, 4) != PMW3901MB_LOG_INDEX_MAGIC) || (buf[4] != PMW3901MB_LOG_INDEX_VERSION) ||
+        (buf[5] != PMW3901MB_LOG_INDEX_ENTRY_SIZE))
+    {
+        goto failed;
+    }
+    index->blocks = (uint32_t)a_index_get(buf + 8, 4);
+    index->bad_blocks = (uint32_t)a_index_get(buf + 12, 4);
+    index->log_bytes = a_index_get(buf + 16, 8);
+    index->samples = a_index_get(buf + 24, 8);
+    index->sum_x = (int64_t)a_index_get(buf + 32, 8);
+    index->sum_y = (int64_t)a_index_get(buf + 40, 8);
+    if ((a_index_log_bytes(index->reader.fp, &log_bytes) != 0) || (log_bytes != index->log_bytes) ||
+        ((uint64_t)index->blocks * PMW3901MB_LOG_BLOCK_HEADER_SIZE > log_bytes))
+    {
+        goto failed;
+    }
+    
+    /* entries */
+    index->entry = (pmw3901mb_log_index_entry_t *)malloc(sizeof(pmw3901mb_log_index_entry_t) *
+                                                         ((index->blocks != 0) ? index->blocks : 1));
+    if (index->entry == NULL)
+    {
+        res = 1;
+        
+        goto failed;
+    }
+    for (i = 0; i < index->blocks; i++)
+    {
+        if (fread(buf, 1, PMW3901MB_LOG_INDEX_ENTRY_SIZE, fp) != PMW3901MB_LOG_INDEX_ENTRY_SIZE)
+        {
+            goto failed;
+        }
+        e = &index->entry[i];
+        e->offset = a_index_get(buf + 0, 8);
+        e->t_first = a_index_get(buf + 8, 8);
+        e->t_last = a_index_get(buf + 16, 8);
+        e->sample = a_index_get(buf + 24, 8);
+        e->sum_x = (int64_t)a_index_get(buf + 32, 8);
+        e->sum_y = (int64_t)a_index_get(buf + 40, 8);
+    }
+    (void)fclose(fp);
+    
+    return 0;
+    
+    failed:
+    (void)fclose(fp);
+    (void)pmw3901mb_log_index_close(index);
+    
+    return res;
+}
+
+/**
+ * @brief     open a log with its sidecar index
+ * @param[in] *index pointer to a log index structure
+ * @param[in] *path pointer to a log file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ *            - 4 not a log
+ * @note      the sidecar is path with PMW3901MB_LOG_INDEX_SUFFIX, it is built and saved when it is missing or stale
+ */
+uint8_t pmw3901mb_log_index_open(pmw3901mb_log_index_t *index, const char *path)
+{
+    char *index_path;
+    uint8_t res;
+    
+    if ((index == NULL) || (path == NULL))
+    {
+        return 1;
+    }
+    index_path = (char *)malloc(strlen(path) + sizeof(PMW3901MB_LOG_INDEX_SUFFIX));
+    if (index_path == NULL)
+    {
+        return 1;
+    }
+    strcpy(index_path, path);
+    strcat(index_path, PMW3901MB_LOG_INDEX_SUFFIX);
+    res = pmw3901mb_log_index_load(index, path, index_path);
+    if (res != 0)                                                                /* missing or stale */
+    {
+        res = pmw3901mb_log_index_build(index, path);
+        if (res == 0)
+        {
+            (void)pmw3901mb_log_index_save(index, index_path);                   /* a read only log still works */
+        }
+    }
+    free(index_path);
+    
+    return res;
+}
+
+/**
+ * @brief      seek to a time
+ * @param[in]  *index pointer to a log index structure
+ * @param[in]  t timestamp in us
+ * @param[out] *sample pointer to a sample number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 seek failed
+ *             - 4 checksum error
+ * @note       the next pmw3901mb_log_reader_read on index->reader returns the first sample at or after t,
+ *             sample is its number in the log and equals samples when t is after the end
+ */
+uint8_t pmw3901mb_log_index_seek(pmw3901mb_log_index_t *index, uint64_t t, uint64_t *sample)
+{
+    uint32_t lo;
+    uint32_t hi;
+    uint32_t mid;
+    uint16_t k;
+    uint8_t res;
+    
+    if ((index == NULL) || (index->reader.fp == NULL) || (sample == NULL))
+    {
+        return 1;
+    }
+    lo = 0;
+    hi = index->blocks;
+    while (lo < hi)                                                              /* first block ending at or after t */
+    {
+        mid = lo + (hi - lo) / 2;
+        if (index->entry[mid].t_last < t)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if (lo == index->blocks)                                                     /* t is after the log */
+    {
+        *sample = index->samples;
+        
+        return pmw3901mb_log_reader_seek(&index->reader, index->log_bytes);
+    }
+    res = a_index_load_block(index, lo);
+    if (res != 0)
+    {
+        return res;
+    }
+    
+    /* first sample at or after t */
+    k = 0;
+    while ((k < index->reader.count) && (index->reader.sample[k].timestamp_us < t))
+    {
+        k++;
+    }
+    index->reader.pos = k;
+    *sample = index->entry[lo].sample + k;
+    
+    return 0;
+}
+
+/**
+ * @brief      get the displacement in a time window
+ * @param[in]  *index pointer to a log index structure
+ * @param[in]  t0 window start in us
+ * @param[in]  t1 window end in us
+ * @param[out] *delta_x pointer to a raw delta_x sum buffer
+ * @param[out] *delta_y pointer to a raw delta_y sum buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get failed
+ *             - 4 checksum error
+ * @note       sums the valid samples with t0 <= timestamp < t1, at most the two boundary blocks are decoded
+ */
+uint8_t pmw3901mb_log_index_displacement(pmw3901mb_log_index_t *index, uint64_t t0, uint64_t t1,
+                                         int64_t *delta_x, int64_t *delta_y)
+{
+    int64_t x0;
+    int64_t y0;
+    int64_t x1;
+    int64_t y1;
+    uint8_t res;
+    
+    if ((index == NULL) || (index->reader.fp == NULL) || (delta_x == NULL) || (delta_y == NULL) || (t1 < t0))
+    {
+        return 1;
+    }
+    res = a_index_prefix(index, t0, &x0, &y0);
+    if (res != 0)
+    {
+        return res;
+    }
+    res = a_index_prefix(index, t1, &x1, &y1);
+    if (res != 0)
+    {
+        return res;
+    }
+    *delta_x = x1 - x0;
+    *delta_y = y1 - y0;
+    
+    return 0;
+}
+
+/**
+ * @brief     close a log index
+ * @param[in] *index pointer to a log index structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t pmw3901mb_log_index_close(pmw3901mb_log_index_t *index)
+{
+    if (index == NULL)
+    {
+        return 0;
+    }
+    (void)pmw3901mb_log_reader_close(&index->reader);
+    free(index->entry);
+    memset(index, 0, sizeof(pmw3901mb_log_index_t));
+    
+    return 0;
+}
@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_log_index.h
+ * @brief     pmw3901mb motion log index header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef PMW3901MB_LOG_INDEX_H
+#define PMW3901MB_LOG_INDEX_H
+
+#include "pmw3901mb_log.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup pmw3901mb_log_index pmw3901mb log index function
+ * @brief    pmw3901mb motion log index modules
+ * @ingroup  pmw3901mb_driver
+ * @{
+ */
+
+/**
+ * @brief pmw3901mb log index format definition
+ */
+#define PMW3901MB_LOG_INDEX_MAGIC          0x494C4D50        /**< "PMLI" in little endian */
+#define PMW3901MB_LOG_INDEX_VERSION        1                 /**< index version */
+#define PMW3901MB_LOG_INDEX_HEADER_SIZE    48                /**< index file header size */
+#define PMW3901MB_LOG_INDEX_ENTRY_SIZE     48                /**< index file entry size */
+#define PMW3901MB_LOG_INDEX_SUFFIX         ".idx"            /**< sidecar index suffix */
+
+/**
+ * @brief pmw3901mb log index entry structure definition
+ */
+typedef struct pmw3901mb_log_index_entry_s
+{
+    uint64_t offset;         /**< block offset in the log */
+    uint64_t t_first;        /**< first timestamp in the block */
+    uint64_t t_last;         /**< last timestamp in the block */
+    uint64_t sample;         /**< samples before the block */
+    int64_t sum_x;           /**< valid delta_x sum before the block */
+    int64_t sum_y;           /**< valid delta_y sum before the block */
+} pmw3901mb_log_index_entry_t;
+
+/**
+ * @brief pmw3901mb log index structure definition
+ */
+typedef struct pmw3901mb_log_index_s
+{
+    pmw3901mb_log_reader_t reader;               /**< log reader */
+    pmw3901mb_log_index_entry_t *entry;          /**< block entries */
+    uint32_t blocks;                             /**< indexed blocks */
+    uint32_t bad_blocks;                         /**< blocks with a checksum error */
+    uint64_t log_bytes;                          /**< log size */
+    uint64_t samples;                            /**< indexed samples */
+    int64_t sum_x;                               /**< valid delta_x sum of the log */
+    int64_t sum_y;                               /**< valid delta_y sum of the log */
+} pmw3901mb_log_index_t;
+
+/**
+ * @brief     build an index by scanning a log
+ * @param[in] *index pointer to a log index structure
+ * @param[in] *path pointer to a log file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 build failed
+ *            - 4 not a log
+ * @note      blocks with a checksum error are left out and counted in bad_blocks
+ */
+uint8_t pmw3901mb_log_index_build(pmw3901mb_log_index_t *index, const char *path);
+
+/**
+ * @brief     save an index
+ * @param[in] *index pointer to a log index structure
+ * @param[in] *path pointer to an index file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 save failed
+ * @note      none
+ */
+uint8_t pmw3901mb_log_index_save(pmw3901mb_log_index_t *index, const char *path);
+
+/**
+ * @brief     load an index
+ * @param[in] *index pointer to a log index structure
+ * @param[in] *path pointer to a log file path
+ * @param[in] *index_path pointer to an index file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 load failed
+ *            - 4 not an index or the index is stale
+ * @note      the index is stale when the log size has changed since it was built
+ */
+uint8_t pmw3901mb_log_index_load(pmw3901mb_log_index_t *index, const char *path, const char *index_path);
+
+/**
+ * @brief     open a log with its sidecar index
+ * @param[in] *index pointer to a log index structure
+ * @param[in] *path pointer to a log file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 open failed
+ *            - 4 not a log
+ * @note      the sidecar is path with PMW3901MB_LOG_INDEX_SUFFIX, it is built and saved when it is missing or stale
+ */
+uint8_t pmw3901mb_log_index_open(pmw3901mb_log_index_t *index, const char *path);
+
+/**
+ * @brief      seek to a time
+ * @param[in]  *index pointer to a log index structure
+ * @param[in]  t timestamp in us
+ * @param[out] *sample pointer to a sample number buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 seek failed
+ *             - 4 checksum error
+ * @note       the next pmw3901mb_log_reader_read on index->reader returns the first sample at or after t,
+ *             sample is its number in the log and equals samples when t is after the end
+ */
+uint8_t pmw3901mb_log_index_seek(pmw3901mb_log_index_t *index, uint64_t t, uint64_t *sample);
+
+/**
+ * @brief      get the displacement in a time window
+ * @param[in]  *index pointer to a log index structure
+ * @param[in]  t0 window start in us
+ * @param[in]  t1 window end in us
+ * @param[out] *delta_x pointer to a raw delta_x sum buffer
+ * @param[out] *delta_y pointer to a raw delta_y sum buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get failed
+ *             - 4 checksum error
+ * @note       sums the valid samples with t0 <= timestamp < t1, at most the two boundary blocks are decoded
+ */
+uint8_t pmw3901mb_log_index_displacement(pmw3901mb_log_index_t *index, uint64_t t0, uint64_t t1,
+                                         int64_t *delta_x, int64_t *delta_y);
+
+/**
+ * @brief     close a log index
+ * @param[in] *index pointer to a log index structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t pmw3901mb_log_index_close(pmw3901mb_log_index_t *index);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
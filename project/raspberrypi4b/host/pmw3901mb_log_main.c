@@ -0,0 +1,289 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_log_main.c
+ * @brief     pmw3901mb motion log reader source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+#include "pmw3901mb_log_index.h"
+#include "pmw3901mb_log_mmap.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static pmw3901mb_motion_t gs_motion[256];        /**< read buffer */
+
+/**
+ * @brief     print the frames of a log
+ * @param[in] *path pointer to a log file path
+ * @param[in] csv bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 print failed
+ * @note      the frames are read in place from the mapped log
+ */
+static int a_print_frames(const char *path, int csv)
+{
+    pmw3901mb_log_mmap_t map;
+    const uint8_t *frame;
+    uint64_t timestamp_us;
+    uint32_t i;
+    uint8_t res;
+    
+    res = pmw3901mb_log_mmap_open(&map, path, PMW3901MB_LOG_MMAP_ADVICE_SEQUENTIAL);
+    if (res != 0)
+    {
+        fprintf(stderr, "pmw3901mb_log: %s %s.\n", (res == 4) ? "unknown log format" : "can't open", path);
+        
+        return 1;
+    }
+    while (1)                                                                               /* read all frames */
+    {
+        res = pmw3901mb_log_mmap_next_frame(&map, &frame, &timestamp_us);
+        if (res == 4)                                                                       /* skip the bad frame */
+        {
+            fprintf(stderr, "pmw3901mb_log: frame %u checksum error.\n", map.frames - 1);
+            
+            continue;
+        }
+        if ((res != 0) || (frame == NULL))                                                  /* end of the log */
+        {
+            break;
+        }
+        if (csv != 0)
+        {
+            printf("%llu", (unsigned long long)timestamp_us);
+            for (i = 0; i < PMW3901MB_LOG_FRAME_SIZE; i++)
+            {
+                printf(",%u", frame[i]);
+            }
+            printf("\n");
+        }
+        else
+        {
+            printf("frame %u at %llu us.\n", map.frames - 1, (unsigned long long)timestamp_us);
+            for (i = 0; i < PMW3901MB_LOG_FRAME_SIZE; i++)
+            {
+                printf("0x%02X%s", frame[i], ((i % 35) == 34) ? "\n" : " ");
+            }
+        }
+    }
+    (void)pmw3901mb_log_mmap_close(&map);
+    
+    return (res == 0) ? 0 : 1;
+}
+
+/**
+ * @brief     main function
+ * @param[in] argc arg numbers
+ * @param[in] **argv arg address
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      none
+ */
+int main(int argc, char **argv)
+{
+    pmw3901mb_log_index_t index;
+    uint64_t samples;
+    uint64_t valid;
+    uint64_t first;
+    uint64_t last;
+    uint64_t from;
+    uint64_t to;
+    uint64_t start;
+    int64_t sum_x;
+    int64_t sum_y;
+    int64_t delta_x;
+    int64_t delta_y;
+    uint32_t blocks;
+    uint32_t bad_blocks;
+    uint32_t skipped;
+    uint32_t num;
+    uint32_t i;
+    uint8_t res;
+    int window;
+    int frames;
+    int done;
+    int csv;
+    int k;
+    
+    csv = 0;
+    window = 0;
+    frames = 0;
+    from = 0;
+    to = UINT64_MAX;
+    for (k = 2; k < argc; k++)
+    {
+        if (strcmp(argv[k], "--csv") == 0)
+        {
+            csv = 1;
+        }
+        else if (strcmp(argv[k], "--frames") == 0)
+        {
+            frames = 1;
+        }
+        else if (strncmp(argv[k], "--from=", 7) == 0)
+        {
+            from = strtoull(argv[k] + 7, NULL, 10);
+            window = 1;
+        }
+        else if (strncmp(argv[k], "--to=", 5) == 0)
+        {
+            to = strtoull(argv[k] + 5, NULL, 10);
+            window = 1;
+        }
+        else
+        {
+            break;
+        }
+    }
+    if ((argc < 2) || (k != argc) || (to < from) || ((frames != 0) && (window != 0)))
+    {
+        fprintf(stderr, "usage: pmw3901mb_log <log file> [--csv] [--from=<us>] [--to=<us>]\n");
+        fprintf(stderr, "       pmw3901mb_log <log file> --frames [--csv]\n");
+        fprintf(stderr, "       --from and --to read the window through the sidecar index, it is built when missing.\n");
+        
+        return 1;
+    }
+    if (frames != 0)
+    {
+        return a_print_frames(argv[1], csv);
+    }
+    memset(&index, 0, sizeof(pmw3901mb_log_index_t));
+    if (window != 0)
+    {
+        res = pmw3901mb_log_index_open(&index, argv[1]);
+    }
+    else
+    {
+        res = pmw3901mb_log_reader_open(&index.reader, argv[1]);
+    }
+    if (res != 0)
+    {
+        fprintf(stderr, "pmw3901mb_log: %s %s.\n", (res == 4) ? "unknown log format" : "can't open", argv[1]);
+        
+        return 1;
+    }
+    delta_x = 0;
+    delta_y = 0;
+    start = 0;
+    blocks = 0;
+    bad_blocks = 0;
+    skipped = 0;
+    if (window != 0)                                                                        /* jump to the window */
+    {
+        res = pmw3901mb_log_index_displacement(&index, from, to, &delta_x, &delta_y);
+        blocks = index.reader.blocks;
+        bad_blocks = index.reader.bad_blocks;
+        skipped = index.reader.frames;
+        if (res == 0)
+        {
+            res = pmw3901mb_log_index_seek(&index, from, &start);
+        }
+        if (res != 0)
+        {
+            fprintf(stderr, "pmw3901mb_log: seek to %llu us failed.\n", (unsigned long long)from);
+            (void)pmw3901mb_log_index_close(&index);
+            
+            return 1;
+        }
+    }
+    if (csv != 0)
+    {
+        printf("timestamp_us,motion,delta_x,delta_y,squal,shutter,valid\n");
+    }
+    samples = 0;
+    valid = 0;
+    first = 0;
+    last = 0;
+    sum_x = 0;
+    sum_y = 0;
+    done = 0;
+    while (done == 0)                                                                       /* read all blocks */
+    {
+        res = pmw3901mb_log_reader_read(&index.reader, gs_motion, 256, &num);
+        for (i = 0; i < num; i++)
+        {
+            if (gs_motion[i].timestamp_us >= to)                                            /* end of the window */
+            {
+                done = 1;
+                
+                break;
+            }
+            if (samples == 0)
+            {
+                first = gs_motion[i].timestamp_us;
+            }
+            last = gs_motion[i].timestamp_us;
+            samples++;
+            if (gs_motion[i].is_valid == 1)
+            {
+                valid++;
+                sum_x += gs_motion[i].delta_x;
+                sum_y += gs_motion[i].delta_y;
+            }
+            if (csv != 0)
+            {
+                printf("%llu,0x%02X,%d,%d,%u,%u,%u\n", (unsigned long long)gs_motion[i].timestamp_us,
+                       gs_motion[i].raw[0], (int16_t)(gs_motion[i].raw[2] | (gs_motion[i].raw[3] << 8)),
+                       (int16_t)(gs_motion[i].raw[4] | (gs_motion[i].raw[5] << 8)), gs_motion[i].raw[6],
+                       (uint32_t)((gs_motion[i].raw[10] << 8) | gs_motion[i].raw[11]), gs_motion[i].is_valid);
+            }
+        }
+        if (res == 4)                                                                       /* skip the bad block */
+        {
+            fprintf(stderr, "pmw3901mb_log: block %u checksum error.\n", index.reader.blocks - 1);
+            
+            continue;
+        }
+        if ((res != 0) || (num == 0))                                                       /* end of the log */
+        {
+            break;
+        }
+    }
+    if (csv == 0)
+    {
+        printf("%llu samples, %llu valid, %u blocks, %u bad blocks, %u frames.\n", (unsigned long long)samples,
+               (unsigned long long)valid, index.reader.blocks - blocks, index.reader.bad_blocks - bad_blocks,
+               index.reader.frames - skipped);
+        printf("duration %llu us, sum delta_x %lld, sum delta_y %lld.\n", (unsigned long long)(last - first),
+               (long long)sum_x, (long long)sum_y);
+        if (window != 0)
+        {
+            printf("window starts at sample %llu, index delta_x %lld, index delta_y %lld.\n",
+                   (unsigned long long)start, (long long)delta_x, (long long)delta_y);
+        }
+    }
+    (void)pmw3901mb_log_index_close(&index);
+    
+    return (res == 0) ? 0 : 1;
+}
@@ -0,0 +1,445 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_log_mmap.c
+ * @brief     pmw3901mb motion log mmap reader source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "pmw3901mb_log_mmap.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief     read a little endian value
+ * @param[in] *p pointer to a data buffer
+ * @param[in] len value bytes
+ * @return    read value
+ * @note      none
+ */
+static uint64_t a_mmap_get(const uint8_t *p, uint8_t len)
+{
+    uint64_t v;
+    uint8_t i;
+    
+    v = 0;
+    for (i = 0; i < len; i++)
+    {
+        v |= (uint64_t)p[i] << (i * 8);
+    }
+    
+    return v;
+}
+
+/**
+ * @brief     prefetch ahead of a cursor
+ * @param[in] *map pointer to a log mmap structure
+ * @param[in] offset cursor offset
+ * @note      with the sequential advice the next window is requested once the cursor is half way into the last one
+ */
+static void a_mmap_prefetch(pmw3901mb_log_mmap_t *map, uint64_t offset)
+{
+    uint64_t len;
+    
+    if (map->advice != PMW3901MB_LOG_MMAP_ADVICE_SEQUENTIAL)
+    {
+        return;
+    }
+    while ((map->prefetch < map->len) && (offset + PMW3901MB_LOG_MMAP_PREFETCH_BYTES / 2 >= map->prefetch))
+    {
+        len = map->len - map->prefetch;
+        len = (len > PMW3901MB_LOG_MMAP_PREFETCH_BYTES) ? PMW3901MB_LOG_MMAP_PREFETCH_BYTES : len;
+        (void)posix_madvise((void *)(map->base + map->prefetch), (size_t)len, POSIX_MADV_WILLNEED);
+        map->prefetch += len;
+    }
+}
+
+/**
+ * @brief      step over one block
+ * @param[in]  *map pointer to a log mmap structure
+ * @param[in]  *offset pointer to a cursor, it is moved after the block
+ * @param[out] **block pointer to a block pointer
+ * @param[out] *len pointer to a block length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 block is truncated or unknown
+ *             - 2 end of the log
+ * @note       none
+ */
+static uint8_t a_mmap_step(pmw3901mb_log_mmap_t *map, uint64_t *offset, const uint8_t **block, uint64_t *len)
+{
+    const uint8_t *p;
+    uint64_t magic;
+    uint64_t l;
+    
+    if (*offset == map->len)
+    {
+        return 2;
+    }
+    if (map->len - *offset < PMW3901MB_LOG_BLOCK_HEADER_SIZE)
+    {
+        return 1;
+    }
+    p = map->base + *offset;
+    magic = a_mmap_get(p, 4);
+    l = PMW3901MB_LOG_BLOCK_HEADER_SIZE + a_mmap_get(p + 4, 4);
+    if (((magic != PMW3901MB_LOG_BLOCK_MAGIC) && (magic != PMW3901MB_LOG_FRAME_MAGIC)) || (map->len - *offset < l))
+    {
+        return 1;
+    }
+    a_mmap_prefetch(map, *offset);
+    *block = p;
+    *len = l;
+    *offset += l;
+    
+    return 0;
+}
+
+/**
+ * @brief     decode the next sample block
+ * @param[in] *map pointer to a log mmap structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 read failed
+ *            - 2 end of the log
+ *            - 4 checksum error
+ * @note      none
+ */
+static uint8_t a_mmap_load(pmw3901mb_log_mmap_t *map)
+{
+    const uint8_t *block;
+    uint64_t len;
+    size_t block_len;
+    uint8_t res;
+    
+    map->count = 0;
+    map->pos = 0;
+    do
+    {
+        res = a_mmap_step(map, &map->offset, &block, &len);
+        if (res != 0)
+        {
+            return res;
+        }
+    } while (a_mmap_get(block, 4) != PMW3901MB_LOG_BLOCK_MAGIC);                /* pass over the frames */
+    map->blocks++;
+    res = pmw3901mb_log_decode_block(block, (size_t)len, map->sample, &map->count, &block_len);
+    if (res != 0)
+    {
+        map->count = 0;
+        map->bad_blocks++;
+    }
+    
+    return res;
+}
+
+/**
+ * @brief     map a log
+ * @param[in] *map pointer to a log mmap structure
+ * @param[in] *path pointer to a log file path
+ * @param[in] advice access advice
+ * @return    status code
+ *            - 0 success
+ *            - 1 map failed
+ *            - 4 not a log
+ * @note      none
+ */
+uint8_t pmw3901mb_log_mmap_open(pmw3901mb_log_mmap_t *map, const char *path, pmw3901mb_log_mmap_advice_t advice)
+{
+    struct stat st;
+    void *base;
+    uint16_t block_samples;
+    uint8_t res;
+    
+    if ((map == NULL) || (path == NULL))
+    {
+        return 1;
+    }
+    memset(map, 0, sizeof(pmw3901mb_log_mmap_t));
+    map->fd = open(path, O_RDONLY);
+    if (map->fd < 0)
+    {
+        return 1;
+    }
+    res = 1;
+    if (fstat(map->fd, &st) != 0)
+    {
+        goto failed;
+    }
+    res = 4;
+    if ((uint64_t)st.st_size < PMW3901MB_LOG_HEADER_SIZE)
+    {
+        goto failed;
+    }
+    res = 1;
+    map->len = (uint64_t)st.st_size;
+    if (map->len != (uint64_t)(size_t)map->len)                                  /* too large for the address space */
+    {
+        goto failed;
+    }
+    base = mmap(NULL, (size_t)map->len, PROT_READ, MAP_SHARED, map->fd, 0);
+    if (base == MAP_FAILED)
+    {
+        goto failed;
+    }
+    map->base = (const uint8_t *)base;
+    
+    /* file header */
+    res = 4;
+    block_samples = (uint16_t)a_mmap_get(map->base + 6, 2);
+    if ((a_mmap_get(map->base, 4) != PMW3901MB_LOG_MAGIC) || (map->base[4] != PMW3901MB_LOG_VERSION) ||
+        (map->base[5] < PMW3901MB_LOG_HEADER_SIZE) || (map->base[5] > map->len) || (block_samples == 0) ||
+        (block_samples > PMW3901MB_LOG_BLOCK_SAMPLES_MAX))
+    {
+        goto failed;
+    }
+    res = 1;
+    map->sample = (pmw3901mb_log_sample_t *)malloc(sizeof(pmw3901mb_log_sample_t) * PMW3901MB_LOG_BLOCK_SAMPLES_MAX);
+    if (map->sample == NULL)
+    {
+        goto failed;
+    }
+    
+    /* access advice */
+    map->advice = (uint8_t)advice;
+    if (advice == PMW3901MB_LOG_MMAP_ADVICE_SEQUENTIAL)
+    {
+        (void)posix_madvise(base, (size_t)map->len, POSIX_MADV_SEQUENTIAL);
+    }
+    else if (advice == PMW3901MB_LOG_MMAP_ADVICE_RANDOM)
+    {
+        (void)posix_madvise(base, (size_t)map->len, POSIX_MADV_RANDOM);
+    }
+    (void)pmw3901mb_log_mmap_rewind(map);
+    
+    return 0;
+    
+    failed:
+    (void)pmw3901mb_log_mmap_close(map);
+    
+    return res;
+}
+
+/**
+ * @brief      get the next sample block
+ * @param[in]  *map pointer to a log mmap structure
+ * @param[out] **sample pointer to a sample array pointer
+ * @param[out] *count pointer to a sample number buffer, 0 means the end of the log
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 4 checksum error
+ * @note       the block is decoded straight from the mapping into map->sample, it stays valid until the next call,
+ *             frames are passed over and a block with a checksum error is skipped by the next call
+ */
+uint8_t pmw3901mb_log_mmap_next_block(pmw3901mb_log_mmap_t *map, const pmw3901mb_log_sample_t **sample, uint16_t *count)
+{
+    uint8_t res;
+    
+    if ((map == NULL) || (map->base == NULL) || (sample == NULL) || (count == NULL))
+    {
+        return 1;
+    }
+    *sample = map->sample;
+    *count = 0;
+    res = a_mmap_load(map);
+    if (res == 2)
+    {
+        return 0;
+    }
+    *count = map->count;
+    map->pos = map->count;
+    
+    return res;
+}
+
+/**
+ * @brief      get the next sample
+ * @param[in]  *map pointer to a log mmap structure
+ * @param[out] **sample pointer to a sample pointer, NULL means the end of the log
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 4 checksum error
+ * @note       the sample stays valid until the next block is decoded
+ */
+uint8_t pmw3901mb_log_mmap_next_sample(pmw3901mb_log_mmap_t *map, const pmw3901mb_log_sample_t **sample)
+{
+    uint8_t res;
+    
+    if ((map == NULL) || (map->base == NULL) || (sample == NULL))
+    {
+        return 1;
+    }
+    *sample = NULL;
+    if (map->pos == map->count)
+    {
+        res = a_mmap_load(map);
+        if (res == 2)
+        {
+            return 0;
+        }
+        if (res != 0)
+        {
+            return res;
+        }
+    }
+    *sample = &map->sample[map->pos];
+    map->pos++;
+    
+    return 0;
+}
+
+/**
+ * @brief      get the next frame
+ * @param[in]  *map pointer to a log mmap structure
+ * @param[out] **frame pointer to a frame pointer, NULL means the end of the log
+ * @param[out] *timestamp_us pointer to a timestamp buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 4 checksum error
+ * @note       frame points into the mapping, 35 rows of 35 pixels, it stays valid until the log is closed,
+ *             the frame cursor is independent of the sample cursor
+ */
+uint8_t pmw3901mb_log_mmap_next_frame(pmw3901mb_log_mmap_t *map, const uint8_t **frame, uint64_t *timestamp_us)
+{
+    const uint8_t *block;
+    uint64_t len;
+    size_t block_len;
+    uint8_t res;
+    
+    if ((map == NULL) || (map->base == NULL) || (frame == NULL) || (timestamp_us == NULL))
+    {
+        return 1;
+    }
+    *frame = NULL;
+    do
+    {
+        res = a_mmap_step(map, &map->frame_offset, &block, &len);
+        if (res == 2)
+        {
+            return 0;
+        }
+        if (res != 0)
+        {
+            return res;
+        }
+    } while (a_mmap_get(block, 4) != PMW3901MB_LOG_FRAME_MAGIC);                /* pass over the sample blocks */
+    map->frames++;
+    
+    return pmw3901mb_log_decode_frame(block, (size_t)len, frame, timestamp_us, &block_len);
+}
+
+/**
+ * @brief     move the sample cursor to a block
+ * @param[in] *map pointer to a log mmap structure
+ * @param[in] offset block offset, from a log index entry or a reader
+ * @return    status code
+ *            - 0 success
+ *            - 1 seek failed
+ * @note      the sequential prefetch restarts at the offset
+ */
+uint8_t pmw3901mb_log_mmap_seek(pmw3901mb_log_mmap_t *map, uint64_t offset)
+{
+    if ((map == NULL) || (map->base == NULL) || (offset < map->base[5]) || (offset > map->len))
+    {
+        return 1;
+    }
+    map->offset = offset;
+    map->count = 0;
+    map->pos = 0;
+    map->prefetch = offset - offset % PMW3901MB_LOG_MMAP_PREFETCH_BYTES;
+    
+    return 0;
+}
+
+/**
+ * @brief     move both cursors to the first block
+ * @param[in] *map pointer to a log mmap structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 rewind failed
+ * @note      none
+ */
+uint8_t pmw3901mb_log_mmap_rewind(pmw3901mb_log_mmap_t *map)
+{
+    if ((map == NULL) || (map->base == NULL))
+    {
+        return 1;
+    }
+    map->offset = map->base[5];
+    map->frame_offset = map->base[5];
+    map->count = 0;
+    map->pos = 0;
+    map->prefetch = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief     unmap a log
+ * @param[in] *map pointer to a log mmap structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t pmw3901mb_log_mmap_close(pmw3901mb_log_mmap_t *map)
+{
+    if (map == NULL)
+    {
+        return 0;
+    }
+    if (map->base != NULL)
+    {
+        (void)munmap((void *)map->base, (size_t)map->len);
+    }
+    if (map->fd >= 0)
+    {
+        (void)close(map->fd);
+    }
+    free(map->sample);
+    memset(map, 0, sizeof(pmw3901mb_log_mmap_t));
+    map->fd = -1;
+    
+    return 0;
+}
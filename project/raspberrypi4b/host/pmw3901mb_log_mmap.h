@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_log_mmap.h
+ * @brief     pmw3901mb motion log mmap reader header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef PMW3901MB_LOG_MMAP_H
+#define PMW3901MB_LOG_MMAP_H
+
+#include "pmw3901mb_log.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup pmw3901mb_log_mmap pmw3901mb log mmap function
+ * @brief    pmw3901mb motion log mmap reader modules
+ * @ingroup  pmw3901mb_driver
+ * @{
+ */
+
+/**
+ * @brief pmw3901mb log mmap prefetch definition
+ */
+#define PMW3901MB_LOG_MMAP_PREFETCH_BYTES    (4 * 1024 * 1024)        /**< sequential prefetch window */
+
+/**
+ * @brief pmw3901mb log mmap advice enumeration definition
+ */
+typedef enum
+{
+    PMW3901MB_LOG_MMAP_ADVICE_NORMAL     = 0x00,        /**< kernel default read ahead */
+    PMW3901MB_LOG_MMAP_ADVICE_SEQUENTIAL = 0x01,        /**< sequential access and prefetch ahead of the cursor */
+    PMW3901MB_LOG_MMAP_ADVICE_RANDOM     = 0x02,        /**< random access, no read ahead */
+} pmw3901mb_log_mmap_advice_t;
+
+/**
+ * @brief pmw3901mb log mmap structure definition
+ */
+typedef struct pmw3901mb_log_mmap_s
+{
+    const uint8_t *base;                   /**< mapped log */
+    uint64_t len;                          /**< log size */
+    uint64_t offset;                       /**< next sample block offset */
+    uint64_t frame_offset;                 /**< next frame offset */
+    uint64_t prefetch;                     /**< prefetched up to this offset */
+    pmw3901mb_log_sample_t *sample;        /**< current block samples */
+    uint16_t count;                        /**< decoded samples */
+    uint16_t pos;                          /**< next sample */
+    uint32_t blocks;                       /**< read blocks */
+    uint32_t bad_blocks;                   /**< blocks with a checksum error */
+    uint32_t frames;                       /**< read frames */
+    uint8_t advice;                        /**< access advice */
+    int fd;                                /**< log file */
+} pmw3901mb_log_mmap_t;
+
+/**
+ * @brief     map a log
+ * @param[in] *map pointer to a log mmap structure
+ * @param[in] *path pointer to a log file path
+ * @param[in] advice access advice
+ * @return    status code
+ *            - 0 success
+ *            - 1 map failed
+ *            - 4 not a log
+ * @note      none
+ */
+uint8_t pmw3901mb_log_mmap_open(pmw3901mb_log_mmap_t *map, const char *path, pmw3901mb_log_mmap_advice_t advice);
+
+/**
+ * @brief      get the next sample block
+ * @param[in]  *map pointer to a log mmap structure
+ * @param[out] **sample pointer to a sample array pointer
+ * @param[out] *count pointer to a sample number buffer, 0 means the end of the log
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 4 checksum error
+ * @note       the block is decoded straight from the mapping into map->sample, it stays valid until the next call,
+ *             frames are passed over and a block with a checksum error is skipped by the next call
+ */
+uint8_t pmw3901mb_log_mmap_next_block(pmw3901mb_log_mmap_t *map, const pmw3901mb_log_sample_t **sample, uint16_t *count);
+
+/**
+ * @brief      get the next sample
+ * @param[in]  *map pointer to a log mmap structure
+ * @param[out] **sample pointer to a sample pointer, NULL means the end of the log
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 4 checksum error
+ * @note       the sample stays valid until the next block is decoded
+ */
+uint8_t pmw3901mb_log_mmap_next_sample(pmw3901mb_log_mmap_t *map, const pmw3901mb_log_sample_t **sample);
+
+/**
+ * @brief      get the next frame
+ * @param[in]  *map pointer to a log mmap structure
+ * @param[out] **frame pointer to a frame pointer, NULL means the end of the log
+ * @param[out] *timestamp_us pointer to a timestamp buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ *             - 4 checksum error
+ * @note       frame points into the mapping, 35 rows of 35 pixels, it stays valid until the log is closed,
+ *             the frame cursor is independent of the sample cursor
+ */
+uint8_t pmw3901mb_log_mmap_next_frame(pmw3901mb_log_mmap_t *map, const uint8_t **frame, uint64_t *timestamp_us);
+
+/**
+ * @brief     move the sample cursor to a block
+ * @param[in] *map pointer to a log mmap structure
+ * @param[in] offset block offset, from a log index entry or a reader
+ * @return    status code
+ *            - 0 success
+ *            - 1 seek failed
+ * @note      the sequential prefetch restarts at the offset
+ */
+uint8_t pmw3901mb_log_mmap_seek(pmw3901mb_log_mmap_t *map, uint64_t offset);
+
+/**
+ * @brief     move both cursors to the first block
+ * @param[in] *map pointer to a log mmap structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 rewind failed
+ * @note      none
+ */
+uint8_t pmw3901mb_log_mmap_rewind(pmw3901mb_log_mmap_t *map);
+
+/**
+ * @brief     unmap a log
+ * @param[in] *map pointer to a log mmap structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t pmw3901mb_log_mmap_close(pmw3901mb_log_mmap_t *map);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,460 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_replay.c
+ * @brief     pmw3901mb spi replay backend source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "pmw3901mb_replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief replay record structure definition
+ */
+typedef struct replay_record_s
+{
+    uint8_t reg;                  /**< register address, bit 7 is set for a write */
+    uint8_t result;               /**< recorded spi result */
+    uint16_t len;                 /**< transfer length */
+    uint16_t payload_len;         /**< recorded payload length */
+    const uint8_t *payload;       /**< recorded payload */
+} replay_record_t;
+
+/**
+ * @brief replay variables definition
+ */
+static uint8_t *gs_dump = NULL;                   /**< dump buffer */
+static replay_record_t *gs_record = NULL;         /**< record array */
+static uint32_t gs_num = 0;                       /**< record number */
+static uint32_t gs_cursor = 0;                    /**< next record */
+static uint32_t gs_skipped = 0;                   /**< skipped records */
+static uint32_t gs_missed = 0;                    /**< missed transfers */
+
+/**
+ * @brief     read a little endian uint32
+ * @param[in] *p pointer to a data buffer
+ * @return    read value
+ * @note      none
+ */
+static uint32_t a_replay_read_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief     find the next record of a transfer
+ * @param[in] reg register address, bit 7 is set for a write
+ * @return    record pointer, NULL means not found
+ * @note      the search wraps at the end of the trace so a short trace can be looped
+ */
+static const replay_record_t *a_replay_find(uint8_t reg)
+{
+    uint32_t i;
+    uint32_t index;
+    
+    for (i = 0; i < gs_num; i++)                         /* search all the records once */
+    {
+        index = (gs_cursor + i) % gs_num;                /* get the index */
+        if (gs_record[index].reg == reg)                 /* check the register */
+        {
+            gs_skipped += i;                             /* add the skipped records */
+            gs_cursor = (index + 1) % gs_num;            /* set the next record */
+            
+            return &gs_record[index];                    /* return the record */
+        }
+    }
+    gs_missed++;                                         /* missed++ */
+    
+    return NULL;                                         /* not found */
+}
+
+/**
+ * @brief  replay spi init
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+static uint8_t a_replay_spi_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  replay spi deinit
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+static uint8_t a_replay_spi_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief      replay spi read
+ * @param[in]  reg register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of data buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 read failed
+ * @note       the bytes after the recorded payload are read as 0
+ */
+static uint8_t a_replay_spi_read(uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    const replay_record_t *record;
+    uint16_t num;
+    
+    record = a_replay_find(reg & 0x7F);                                        /* find the read */
+    if (record == NULL)                                                        /* check the record */
+    {
+        memset(buf, 0, len);                                                   /* clear the buffer */
+        
+        return 1;                                                              /* return error */
+    }
+    num = (len < record->payload_len) ? len : record->payload_len;             /* get the copied length */
+    memcpy(buf, record->payload, num);                                         /* copy the payload */
+    memset(buf + num, 0, len - num);                                           /* clear the rest */
+    
+    return record->result;                                                     /* return the recorded result */
+}
+
+/**
+ * @brief     replay spi write
+ * @param[in] reg register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of data buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 write failed
+ * @note      the written data is not compared
+ */
+static uint8_t a_replay_spi_write(uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    const replay_record_t *record;
+    
+    (void)buf;
+    (void)len;
+    record = a_replay_find(reg | 0x80);                                        /* find the write */
+    if (record == NULL)                                                        /* check the record */
+    {
+        return 1;                                                              /* return error */
+    }
+    
+    return record->result;                                                     /* return the recorded result */
+}
+
+/**
+ * @brief  replay reset gpio init
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+static uint8_t a_replay_reset_gpio_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  replay reset gpio deinit
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+static uint8_t a_replay_reset_gpio_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     replay reset gpio write
+ * @param[in] value written value
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+static uint8_t a_replay_reset_gpio_write(uint8_t value)
+{
+    (void)value;
+    
+    return 0;
+}
+
+/**
+ * @brief     replay delay ms
+ * @param[in] ms time
+ * @note      the delay is skipped
+ */
+static void a_replay_delay_ms(uint32_t ms)
+{
+    (void)ms;
+}
+
+/**
+ * @brief     replay delay us
+ * @param[in] us time
+ * @note      the delay is skipped
+ */
+static void a_replay_delay_us(uint32_t us)
+{
+    (void)us;
+}
+
+/**
+ * @brief     replay print format data
+ * @param[in] fmt format data
+ * @note      the driver messages are dropped
+ */
+static void a_replay_debug_print(const char *const fmt, ...)
+{
+    (void)fmt;
+}
+
+/**
+ * @brief     load a binary trace dump
+ * @param[in] *path pointer to a dump file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 load failed
+ * @note      the dump is written from pmw3901mb_trace_dump
+ */
+uint8_t pmw3901mb_replay_load(const char *path)
+{
+    FILE *fp;
+    long size;
+    uint32_t i;
+    uint32_t num;
+    uint8_t payload_max;
+    size_t offset;
+    
+    (void)pmw3901mb_replay_free();                                                       /* free the last trace */
+    fp = fopen(path, "rb");                                                              /* open the file */
+    if (fp == NULL)
+    {
+        return 1;
+    }
+    if ((fseek(fp, 0, SEEK_END) != 0) || ((size = ftell(fp)) < PMW3901MB_TRACE_DUMP_HEADER_SIZE) ||
+        (fseek(fp, 0, SEEK_SET) != 0))                                                   /* get the size */
+    {
+        fclose(fp);
+        
+        return 1;
+    }
+    gs_dump = (uint8_t *)malloc((size_t)size);                                           /* malloc the dump */
+    if ((gs_dump == NULL) || (fread(gs_dump, 1, (size_t)size, fp) != (size_t)size))      /* read the dump */
+    {
+        fclose(fp);
+        (void)pmw3901mb_replay_free();
+        
+        return 1;
+    }
+    fclose(fp);
+    
+    if ((a_replay_read_u32(gs_dump) != PMW3901MB_TRACE_DUMP_MAGIC) ||
+        (gs_dump[4] != PMW3901MB_TRACE_DUMP_VERSION))                                    /* check the format */
+    {
+        (void)pmw3901mb_replay_free();
+        
+        return 1;
+    }
+    payload_max = gs_dump[5];                                                            /* get payload max */
+    num = a_replay_read_u32(gs_dump + 8);                                                /* get num */
+    if (num == 0)                                                                        /* check num */
+    {
+        (void)pmw3901mb_replay_free();
+        
+        return 1;
+    }
+    gs_record = (replay_record_t *)malloc(sizeof(replay_record_t) * num);                /* malloc the records */
+    if (gs_record == NULL)
+    {
+        (void)pmw3901mb_replay_free();
+        
+        return 1;
+    }
+    offset = PMW3901MB_TRACE_DUMP_HEADER_SIZE;                                           /* skip the header */
+    for (i = 0; i < num; i++)                                                            /* parse all */
+    {
+        if (offset + PMW3901MB_TRACE_DUMP_RECORD_SIZE > (size_t)size)                    /* check length */
+        {
+            (void)pmw3901mb_replay_free();
+            
+            return 1;
+        }
+        gs_record[i].reg = gs_dump[offset + 4];                                          /* set reg */
+        gs_record[i].result = gs_dump[offset + 5];                                       /* set result */
+        gs_record[i].len = (uint16_t)(gs_dump[offset + 6] | (gs_dump[offset + 7] << 8)); /* set len */
+        gs_record[i].payload_len = (gs_record[i].len < payload_max) ? gs_record[i].len :
+                                   payload_max;                                          /* set payload length */
+        gs_record[i].payload = gs_dump + offset + PMW3901MB_TRACE_DUMP_RECORD_SIZE;      /* set payload */
+        offset += PMW3901MB_TRACE_DUMP_RECORD_SIZE + gs_record[i].payload_len;           /* next record */
+        if (offset > (size_t)size)                                                       /* check length */
+        {
+            (void)pmw3901mb_replay_free();
+            
+            return 1;
+        }
+    }
+    gs_num = num;                                                                        /* set num */
+    
+    return pmw3901mb_replay_rewind();                                                    /* rewind */
+}
+
+/**
+ * @brief  free the loaded trace
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+uint8_t pmw3901mb_replay_free(void)
+{
+    free(gs_record);
+    free(gs_dump);
+    gs_record = NULL;
+    gs_dump = NULL;
+    gs_num = 0;
+    
+    return pmw3901mb_replay_rewind();
+}
+
+/**
+ * @brief  rewind the replay to the first record
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+uint8_t pmw3901mb_replay_rewind(void)
+{
+    gs_cursor = 0;
+    gs_skipped = 0;
+    gs_missed = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief         link the replay backend to a handle
+ * @param[in,out] *handle pointer to a pmw3901mb handle structure
+ * @return        status code
+ *                - 0 success
+ *                - 1 link failed
+ * @note          the handle is cleared first, all the delays are skipped
+ */
+uint8_t pmw3901mb_replay_link(pmw3901mb_handle_t *handle)
+{
+    if (handle == NULL)
+    {
+        return 1;
+    }
+    
+    DRIVER_PMW3901MB_LINK_INIT(handle, pmw3901mb_handle_t);
+    DRIVER_PMW3901MB_LINK_SPI_INIT(handle, a_replay_spi_init);
+    DRIVER_PMW3901MB_LINK_SPI_DEINIT(handle, a_replay_spi_deinit);
+    DRIVER_PMW3901MB_LINK_SPI_READ(handle, a_replay_spi_read);
+    DRIVER_PMW3901MB_LINK_SPI_WRITE(handle, a_replay_spi_write);
+    DRIVER_PMW3901MB_LINK_RESET_GPIO_INIT(handle, a_replay_reset_gpio_init);
+    DRIVER_PMW3901MB_LINK_RESET_GPIO_DEINIT(handle, a_replay_reset_gpio_deinit);
+    DRIVER_PMW3901MB_LINK_RESET_GPIO_WRITE(handle, a_replay_reset_gpio_write);
+    DRIVER_PMW3901MB_LINK_DELAY_MS(handle, a_replay_delay_ms);
+    DRIVER_PMW3901MB_LINK_DELAY_US(handle, a_replay_delay_us);
+    DRIVER_PMW3901MB_LINK_DEBUG_PRINT(handle, a_replay_debug_print);
+    
+    return 0;
+}
+
+/**
+ * @brief      get the replay mismatch counters
+ * @param[out] *skipped pointer to a skipped records buffer
+ * @param[out] *missed pointer to a missed transfers buffer
+ * @return     status code
+ *             - 0 success
+ * @note       skipped counts the records jumped over to find the requested transfer,
+ *             missed counts the transfers that are not in the trace
+ */
+uint8_t pmw3901mb_replay_get_mismatch(uint32_t *skipped, uint32_t *missed)
+{
+    *skipped = gs_skipped;
+    *missed = gs_missed;
+    
+    return 0;
+}
+
+/**
+ * @brief     save the trace ring of a handle as a binary dump
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] *path pointer to a dump file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 save failed
+ * @note      it runs on the target to record the trace that is replayed on the host
+ */
+uint8_t pmw3901mb_replay_save(pmw3901mb_handle_t *handle, const char *path)
+{
+    FILE *fp;
+    uint8_t *buf;
+    uint32_t len;
+    uint8_t res;
+    
+    res = pmw3901mb_trace_dump(handle, NULL, 0, &len);                                   /* get the dump length */
+    if (res != 5)                                                                        /* check the result */
+    {
+        return 1;
+    }
+    buf = (uint8_t *)malloc(len);                                                        /* malloc the dump */
+    if (buf == NULL)
+    {
+        return 1;
+    }
+    if (pmw3901mb_trace_dump(handle, buf, len, &len) != 0)                               /* dump the trace */
+    {
+        free(buf);
+        
+        return 1;
+    }
+    fp = fopen(path, "wb");                                                              /* open the file */
+    if (fp == NULL)
+    {
+        free(buf);
+        
+        return 1;
+    }
+    res = (fwrite(buf, 1, len, fp) == len) ? 0 : 1;                                      /* write the dump */
+    if (fclose(fp) != 0)
+    {
+        res = 1;
+    }
+    free(buf);
+    
+    return res;
+}
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_replay.h
+ * @brief     pmw3901mb spi replay backend header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef PMW3901MB_REPLAY_H
+#define PMW3901MB_REPLAY_H
+
+#include "driver_pmw3901mb.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup pmw3901mb_replay pmw3901mb replay function
+ * @brief    pmw3901mb replay function modules
+ * @ingroup  pmw3901mb_driver
+ * @{
+ */
+
+/**
+ * @brief     load a binary trace dump
+ * @param[in] *path pointer to a dump file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 load failed
+ * @note      the dump is written from pmw3901mb_trace_dump
+ */
+uint8_t pmw3901mb_replay_load(const char *path);
+
+/**
+ * @brief  free the loaded trace
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+uint8_t pmw3901mb_replay_free(void);
+
+/**
+ * @brief  rewind the replay to the first record
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+uint8_t pmw3901mb_replay_rewind(void);
+
+/**
+ * @brief         link the replay backend to a handle
+ * @param[in,out] *handle pointer to a pmw3901mb handle structure
+ * @return        status code
+ *                - 0 success
+ *                - 1 link failed
+ * @note          the handle is cleared first, all the delays are skipped
+ */
+uint8_t pmw3901mb_replay_link(pmw3901mb_handle_t *handle);
+
+/**
+ * @brief      get the replay mismatch counters
+ * @param[out] *skipped pointer to a skipped records buffer
+ * @param[out] *missed pointer to a missed transfers buffer
+ * @return     status code
+ *             - 0 success
+ * @note       skipped counts the records jumped over to find the requested transfer,
+ *             missed counts the transfers that are not in the trace
+ */
+uint8_t pmw3901mb_replay_get_mismatch(uint32_t *skipped, uint32_t *missed);
+
+/**
+ * @brief     save the trace ring of a handle as a binary dump
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] *path pointer to a dump file path
+ * @return    status code
+ *            - 0 success
+ *            - 1 save failed
+ * @note      it runs on the target to record the trace that is replayed on the host
+ */
+uint8_t pmw3901mb_replay_save(pmw3901mb_handle_t *handle, const char *path);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
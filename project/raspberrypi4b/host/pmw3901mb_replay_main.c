@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_replay_main.c
+ * @brief     pmw3901mb spi replay runner source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "pmw3901mb_replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief  get the monotonic time
+ * @return time in ns
+ * @note   none
+ */
+static uint64_t a_now_ns(void)
+{
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief     main function
+ * @param[in] argc arg numbers
+ * @param[in] **argv arg address
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      none
+ */
+int main(int argc, char **argv)
+{
+    static uint8_t frame[35][35];
+    pmw3901mb_handle_t handle;
+    pmw3901mb_motion_t motion;
+    uint32_t times;
+    uint32_t i;
+    uint32_t skipped;
+    uint32_t missed;
+    uint64_t start;
+    uint64_t ns;
+    int get_frame;
+    int k;
+    
+    times = 1000;
+    get_frame = 0;
+    for (k = 2; k < argc; k++)
+    {
+        if (strncmp(argv[k], "--times=", 8) == 0)
+        {
+            times = (uint32_t)strtoul(argv[k] + 8, NULL, 10);
+        }
+        else if (strcmp(argv[k], "--frame") == 0)
+        {
+            get_frame = 1;
+        }
+        else
+        {
+            argc = 0;
+        }
+    }
+    if ((argc < 2) || (times == 0))
+    {
+        fprintf(stderr, "usage: pmw3901mb_replay <dump file> [--frame] [--times=<num>]\n");
+        
+        return 1;
+    }
+    if (pmw3901mb_replay_load(argv[1]) != 0)
+    {
+        fprintf(stderr, "pmw3901mb_replay: can't load %s.\n", argv[1]);
+        
+        return 1;
+    }
+    (void)pmw3901mb_replay_link(&handle);
+    
+    start = a_now_ns();
+    if (pmw3901mb_init(&handle) != 0)
+    {
+        fprintf(stderr, "pmw3901mb_replay: init failed.\n");
+        (void)pmw3901mb_replay_free();
+        
+        return 1;
+    }
+    ns = a_now_ns() - start;
+    printf("init: %llu ns.\n", (unsigned long long)ns);
+    
+    start = a_now_ns();
+    for (i = 0; i < times; i++)
+    {
+        if (((get_frame != 0) ? pmw3901mb_get_frame(&handle, frame) : pmw3901mb_burst_read(&handle, &motion)) != 0)
+        {
+            fprintf(stderr, "pmw3901mb_replay: %s %u failed.\n", (get_frame != 0) ? "get_frame" : "burst_read", i);
+            (void)pmw3901mb_deinit(&handle);
+            (void)pmw3901mb_replay_free();
+            
+            return 1;
+        }
+    }
+    ns = a_now_ns() - start;
+    printf("%s: %u times, %.1f ns per call.\n", (get_frame != 0) ? "get_frame" : "burst_read", times, (double)ns / times);
+    
+    (void)pmw3901mb_replay_get_mismatch(&skipped, &missed);
+    printf("skipped %u records, missed %u transfers.\n", skipped, missed);
+    (void)pmw3901mb_deinit(&handle);
+    (void)pmw3901mb_replay_free();
+    
+    return 0;
+}
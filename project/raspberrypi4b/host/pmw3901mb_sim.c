@@ -0,0 +1,891 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_sim.c
+ * @brief     pmw3901mb behavioural simulator source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "pmw3901mb_sim.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief sim register definition
+ */
+#define SIM_BANK_NUM                 0x20        /**< simulated register banks */
+#define SIM_REG_MOTION               0x02        /**< motion register */
+#define SIM_REG_OBSERVATION          0x15        /**< observation register */
+#define SIM_REG_MOTION_BURST         0x16        /**< motion burst register */
+#define SIM_REG_POWER_UP_RESET       0x3A        /**< power up reset register */
+#define SIM_REG_SHUTDOWN             0x3B        /**< shutdown register */
+#define SIM_REG_RAW_DATA_GRAB        0x58        /**< raw data grab register */
+#define SIM_REG_RAW_DATA_GRAB_STATUS 0x59        /**< raw data grab status register */
+#define SIM_REG_BANK_SELECT          0x7F        /**< bank select register */
+
+/**
+ * @brief sim grab state definition
+ */
+#define SIM_GRAB_IDLE                0x00        /**< no grab */
+#define SIM_GRAB_ARMED               0x01        /**< wait for the next frame */
+#define SIM_GRAB_READ                0x02        /**< pixels are read out */
+
+/**
+ * @brief sim variables definition
+ */
+static const pmw3901mb_sim_config_t *gs_config = NULL;        /**< config */
+static uint8_t gs_print = 1;                                  /**< print enable */
+static uint64_t gs_time_ns;                                   /**< virtual time */
+static uint8_t gs_powered;                                    /**< power state */
+static uint8_t gs_bank;                                       /**< selected bank */
+static uint8_t gs_reg[SIM_BANK_NUM][0x80];                    /**< register file */
+static uint32_t gs_segment;                                   /**< current trajectory segment */
+static uint64_t gs_segment_start_us;                          /**< current segment start time */
+static double gs_segment_x;                                   /**< x at the segment start */
+static double gs_segment_y;                                   /**< y at the segment start */
+static int64_t gs_frame;                                      /**< last simulated frame */
+static int32_t gs_x;                                          /**< x at the last frame in counts */
+static int32_t gs_y;                                          /**< y at the last frame in counts */
+static int32_t gs_reported_x;                                 /**< reported x in counts */
+static int32_t gs_reported_y;                                 /**< reported y in counts */
+static int16_t gs_latch_x;                                    /**< latched delta x */
+static int16_t gs_latch_y;                                    /**< latched delta y */
+static uint8_t gs_observation;                                /**< observation register */
+static uint8_t gs_squal;                                      /**< surface quality */
+static uint8_t gs_sum;                                        /**< raw data average */
+static uint8_t gs_max;                                        /**< raw data max */
+static uint8_t gs_min;                                        /**< raw data min */
+static uint8_t gs_handshake_fail;                             /**< remaining failed handshake reads */
+static uint8_t gs_grab_state;                                 /**< grab state */
+static uint64_t gs_grab_ready_us;                             /**< grab ready time */
+static uint16_t gs_grab_pixel;                                /**< next grab pixel */
+static uint8_t gs_grab_high;                                  /**< bool value, 1 sends the lower bits next */
+static uint8_t gs_grab[35 * 35];                              /**< grabbed frame */
+static uint64_t gs_ready_ns;                                  /**< earliest time of the next command */
+static pmw3901mb_sim_bus_t gs_bus;                            /**< bus counters */
+
+/**
+ * @brief     run the bus timing of a transaction
+ * @param[in] write bool value
+ * @param[in] len data length
+ * @param[in] call bool value, 1 pays the call overhead
+ * @note      the address byte, tsrad of a read and the tsww or tsrw gap are modelled
+ */
+static void a_sim_bus(uint8_t write, uint16_t len, uint8_t call)
+{
+    uint64_t busy;
+    
+    if (call != 0)                                                                          /* spi call */
+    {
+        gs_time_ns += gs_config->call_ns;
+        gs_bus.calls++;
+    }
+    if (gs_time_ns < gs_ready_ns)                                                           /* wait the gap */
+    {
+        gs_bus.stall_ns += gs_ready_ns - gs_time_ns;
+        gs_time_ns = gs_ready_ns;
+    }
+    busy = gs_config->cs_ns + ((uint64_t)(len + 1) * 8 * 1000000000ULL) / gs_config->spi_hz;
+    if (write == 0)                                                                         /* read */
+    {
+        busy += (uint64_t)gs_config->tsrad_us * 1000;
+    }
+    gs_time_ns += busy;
+    gs_bus.busy_ns += busy;
+    gs_bus.transactions++;
+    gs_bus.bytes += len + 1;
+    gs_ready_ns = gs_time_ns + (uint64_t)((write != 0) ? gs_config->tsww_us : gs_config->tsrw_us) * 1000;
+}
+
+/**
+ * @brief     built-in surface texture
+ * @param[in] x x in counts
+ * @param[in] y y in counts
+ * @return    pixel value
+ * @note      a hashed 2 x 2 count checker gives a good surface quality
+ */
+static uint8_t a_sim_texture(int32_t x, int32_t y)
+{
+    uint32_t h;
+    
+    h = ((uint32_t)(x >> 1) * 0x9E3779B1U) ^ ((uint32_t)(y >> 1) * 0x85EBCA77U);
+    h ^= h >> 15;
+    h *= 0x2C1B3C6DU;
+    h ^= h >> 12;
+    
+    return (uint8_t)(0x20 + (h % 0xC0));
+}
+
+/**
+ * @brief     get a texture pixel
+ * @param[in] x x in counts
+ * @param[in] y y in counts
+ * @return    pixel value
+ * @note      none
+ */
+static uint8_t a_sim_pixel(int32_t x, int32_t y)
+{
+    if (gs_config->texture != NULL)
+    {
+        return gs_config->texture(x, y);
+    }
+    
+    return a_sim_texture(x, y);
+}
+
+/**
+ * @brief      get the surface position
+ * @param[in]  t_us time in us
+ * @param[out] *x pointer to an x buffer
+ * @param[out] *y pointer to a y buffer
+ * @note       the time must not go back, the segment is cached
+ */
+static void a_sim_position(uint64_t t_us, double *x, double *y)
+{
+    const pmw3901mb_sim_waypoint_t *seg;
+    double dt;
+    
+    if ((gs_config->trajectory == NULL) || (gs_segment >= gs_config->trajectory_len))       /* still */
+    {
+        *x = gs_segment_x;
+        *y = gs_segment_y;
+        
+        return;
+    }
+    seg = &gs_config->trajectory[gs_segment];
+    while (t_us >= gs_segment_start_us + seg->duration_us)                                  /* pass the ended segments */
+    {
+        gs_segment_x += (double)seg->vx * seg->duration_us / 1000000.0;
+        gs_segment_y += (double)seg->vy * seg->duration_us / 1000000.0;
+        gs_segment_start_us += seg->duration_us;
+        gs_segment++;
+        if (gs_segment >= gs_config->trajectory_len)                                        /* check the end */
+        {
+            if ((gs_config->trajectory_loop == 0) || (gs_segment_start_us == 0))
+            {
+                *x = gs_segment_x;
+                *y = gs_segment_y;
+                
+                return;
+            }
+            gs_segment = 0;
+        }
+        seg = &gs_config->trajectory[gs_segment];
+    }
+    dt = (double)(t_us - gs_segment_start_us) / 1000000.0;
+    *x = gs_segment_x + seg->vx * dt;
+    *y = gs_segment_y + seg->vy * dt;
+}
+
+/**
+ * @brief  run the frames up to the virtual time
+ * @note   the surface statistics are sampled once per frame
+ */
+static void a_sim_update(void)
+{
+    int64_t frame;
+    double x;
+    double y;
+    int32_t i;
+    uint32_t sum;
+    uint8_t v;
+    
+    frame = (int64_t)(gs_time_ns / 1000 / gs_config->frame_us);                             /* get the frame */
+    if ((frame == gs_frame) || (gs_powered == 0))                                           /* check the frame */
+    {
+        return;
+    }
+    gs_frame = frame;
+    a_sim_position((uint64_t)frame * gs_config->frame_us, &x, &y);                          /* get the position */
+    gs_x = (int32_t)floor(x);
+    gs_y = (int32_t)floor(y);
+    gs_observation = 0xBF;                                                                  /* frames are running */
+    
+    sum = 0;
+    gs_max = 0x00;
+    gs_min = 0xFF;
+    for (i = 0; i < 16; i++)                                                                /* sample the surface */
+    {
+        v = a_sim_pixel(gs_x + (i & 3) * 8 - 12, gs_y + (i >> 2) * 8 - 12);
+        sum += v;
+        gs_max = (v > gs_max) ? v : gs_max;
+        gs_min = (v < gs_min) ? v : gs_min;
+    }
+    gs_sum = (uint8_t)(sum / 16 / 2);                                                       /* raw data sum is average / 2 */
+    gs_squal = (uint8_t)((gs_max - gs_min) / 2);                                            /* contrast gives the quality */
+}
+
+/**
+ * @brief  latch the motion
+ * @return motion register
+ * @note   none
+ */
+static uint8_t a_sim_latch(void)
+{
+    int32_t dx;
+    int32_t dy;
+    
+    dx = gs_x - gs_reported_x;
+    dy = gs_y - gs_reported_y;
+    dx = (dx > 32767) ? 32767 : ((dx < -32768) ? -32768 : dx);
+    dy = (dy > 32767) ? 32767 : ((dy < -32768) ? -32768 : dy);
+    gs_reported_x += dx;
+    gs_reported_y += dy;
+    gs_latch_x = (int16_t)dx;
+    gs_latch_y = (int16_t)dy;
+    
+    return ((dx != 0) || (dy != 0)) ? 0x80 : 0x00;
+}
+
+/**
+ * @brief  reset the register file
+ * @note   none
+ */
+static void a_sim_reset(void)
+{
+    memset(gs_reg, 0, sizeof(gs_reg));
+    gs_bank = 0;
+    gs_reg[0x0E][0x47] = 0x08;                                                              /* optimum sequence handshake */
+    gs_reg[0x0E][0x67] = 0x80;                                                              /* chip variant */
+    gs_reg[0x0E][0x70] = 0x1E;                                                              /* c1 */
+    gs_reg[0x0E][0x71] = 0x64;                                                              /* c2 */
+    gs_handshake_fail = gs_config->handshake_fail;                                          /* the handshake fails first */
+    gs_reported_x = gs_x;
+    gs_reported_y = gs_y;
+    gs_latch_x = 0;
+    gs_latch_y = 0;
+    gs_observation = 0x00;
+    gs_grab_state = SIM_GRAB_IDLE;
+    gs_frame = -1;
+}
+
+/**
+ * @brief     read a register
+ * @param[in] reg register address
+ * @return    register value
+ * @note      none
+ */
+static uint8_t a_sim_read_reg(uint8_t reg)
+{
+    uint8_t v;
+    
+    if (gs_powered == 0)                                                                    /* shutdown */
+    {
+        return 0x00;
+    }
+    if ((gs_bank == 0x0E) && (reg == 0x47) && (gs_handshake_fail != 0))                    /* handshake is not ready */
+    {
+        gs_handshake_fail--;
+        
+        return 0x00;
+    }
+    if (gs_bank != 0)                                                                       /* other banks */
+    {
+        return (reg == SIM_REG_BANK_SELECT) ? gs_bank : gs_reg[gs_bank % SIM_BANK_NUM][reg];
+    }
+    switch (reg)
+    {
+        case 0x00 :
+        {
+            return 0x49;                                                                    /* product id */
+        }
+        case 0x01 :
+        {
+            return 0x00;                                                                    /* revision id */
+        }
+        case SIM_REG_MOTION :
+        {
+            return a_sim_latch();                                                           /* latch the motion */
+        }
+        case 0x03 :
+        {
+            return (uint8_t)((uint16_t)gs_latch_x & 0xFF);
+        }
+        case 0x04 :
+        {
+            return (uint8_t)((uint16_t)gs_latch_x >> 8);
+        }
+        case 0x05 :
+        {
+            return (uint8_t)((uint16_t)gs_latch_y & 0xFF);
+        }
+        case 0x06 :
+        {
+            return (uint8_t)((uint16_t)gs_latch_y >> 8);
+        }
+        case 0x07 :
+        {
+            return gs_squal;
+        }
+        case 0x08 :
+        {
+            return gs_sum;
+        }
+        case 0x09 :
+        {
+            return gs_max;
+        }
+        case 0x0A :
+        {
+            return gs_min;
+        }
+        case 0x0B :
+        {
+            return (uint8_t)(gs_config->shutter & 0xFF);
+        }
+        case 0x0C :
+        {
+            return (uint8_t)((gs_config->shutter >> 8) & 0x1F);
+        }
+        case SIM_REG_OBSERVATION :
+        {
+            return gs_observation;
+        }
+        case SIM_REG_RAW_DATA_GRAB :
+        {
+            if ((gs_grab_state == SIM_GRAB_ARMED) && (gs_time_ns / 1000 >= gs_grab_ready_us))
+            {
+                gs_grab_state = SIM_GRAB_READ;                                              /* the frame is ready */
+            }
+            if (gs_grab_state != SIM_GRAB_READ)
+            {
+                return 0x00;                                                                /* no data */
+            }
+            v = gs_grab[gs_grab_pixel];
+            if (gs_grab_high == 0)
+            {
+                gs_grab_high = 1;
+                
+                return (uint8_t)(0x40 | (v >> 2));                                          /* upper 6 bits */
+            }
+            gs_grab_high = 0;
+            gs_grab_pixel++;
+            if (gs_grab_pixel == 35 * 35)                                                   /* check the end */
+            {
+                gs_grab_state = SIM_GRAB_IDLE;
+            }
+            
+            return (uint8_t)(0x80 | ((v & 0x3) << 2));                                      /* lower 2 bits */
+        }
+        case SIM_REG_RAW_DATA_GRAB_STATUS :
+        {
+            return ((gs_grab_state == SIM_GRAB_READ) ||
+                    ((gs_grab_state == SIM_GRAB_ARMED) && (gs_time_ns / 1000 >= gs_grab_ready_us))) ? 0xC0 : 0x00;
+        }
+        case 0x5F :
+        {
+            return 0xB6;                                                                    /* inverse product id */
+        }
+        case SIM_REG_BANK_SELECT :
+        {
+            return gs_bank;
+        }
+        default :
+        {
+            return gs_reg[0][reg];
+        }
+    }
+}
+
+/**
+ * @brief      get the default config
+ * @param[out] *config pointer to a config structure
+ * @return     status code
+ *             - 0 success
+ * @note       none
+ */
+uint8_t pmw3901mb_sim_get_default_config(pmw3901mb_sim_config_t *config)
+{
+    memset(config, 0, sizeof(pmw3901mb_sim_config_t));
+    config->frame_us = PMW3901MB_SIM_DEFAULT_FRAME_US;
+    config->spi_hz = PMW3901MB_SIM_DEFAULT_SPI_HZ;
+    config->cs_ns = PMW3901MB_SIM_DEFAULT_CS_NS;
+    config->call_ns = PMW3901MB_SIM_DEFAULT_CALL_NS;
+    config->tsrad_us = PMW3901MB_SIM_DEFAULT_TSRAD_US;
+    config->tsww_us = PMW3901MB_SIM_DEFAULT_TSWW_US;
+    config->tsrw_us = PMW3901MB_SIM_DEFAULT_TSRW_US;
+    config->shutter = PMW3901MB_SIM_DEFAULT_SHUTTER;
+    
+    return 0;
+}
+
+/**
+ * @brief     reset the model and the virtual time
+ * @param[in] *config pointer to a config structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 config is invalid
+ * @note      the config is referenced, not copied
+ */
+uint8_t pmw3901mb_sim_init(const pmw3901mb_sim_config_t *config)
+{
+    if ((config == NULL) || (config->frame_us == 0) || (config->spi_hz == 0) ||
+        ((config->trajectory != NULL) && (config->trajectory_len == 0)))
+    {
+        return 1;
+    }
+    
+    gs_config = config;
+    gs_time_ns = 0;
+    gs_segment = 0;
+    gs_segment_start_us = 0;
+    gs_segment_x = 0.0;
+    gs_segment_y = 0.0;
+    gs_x = 0;
+    gs_y = 0;
+    gs_powered = 1;
+    gs_ready_ns = 0;
+    memset(&gs_bus, 0, sizeof(gs_bus));
+    a_sim_reset();
+    
+    return 0;
+}
+
+/**
+ * @brief  sim spi init
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+static uint8_t a_sim_spi_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  sim spi deinit
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+static uint8_t a_sim_spi_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  sim reset gpio init
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+static uint8_t a_sim_reset_gpio_init(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  sim reset gpio deinit
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+static uint8_t a_sim_reset_gpio_deinit(void)
+{
+    return 0;
+}
+
+/**
+ * @brief     sim delay ms
+ * @param[in] ms time
+ * @note      none
+ */
+static void a_sim_delay_ms(uint32_t ms)
+{
+    pmw3901mb_sim_delay_us(ms * 1000);
+}
+
+/**
+ * @brief         link the simulator to a handle
+ * @param[in,out] *handle pointer to a pmw3901mb handle structure
+ * @return        status code
+ *                - 0 success
+ *                - 1 link failed
+ * @note          the handle is cleared first
+ */
+uint8_t pmw3901mb_sim_link(pmw3901mb_handle_t *handle)
+{
+    if (handle == NULL)
+    {
+        return 1;
+    }
+    
+    DRIVER_PMW3901MB_LINK_INIT(handle, pmw3901mb_handle_t);
+    DRIVER_PMW3901MB_LINK_SPI_INIT(handle, a_sim_spi_init);
+    DRIVER_PMW3901MB_LINK_SPI_DEINIT(handle, a_sim_spi_deinit);
+    DRIVER_PMW3901MB_LINK_SPI_READ(handle, pmw3901mb_sim_spi_read);
+    DRIVER_PMW3901MB_LINK_SPI_WRITE(handle, pmw3901mb_sim_spi_write);
+    if ((gs_config != NULL) && (gs_config->batch != 0))
+    {
+        DRIVER_PMW3901MB_LINK_SPI_TRANSFER_BATCH(handle, pmw3901mb_sim_spi_transfer_batch);
+    }
+    DRIVER_PMW3901MB_LINK_RESET_GPIO_INIT(handle, a_sim_reset_gpio_init);
+    DRIVER_PMW3901MB_LINK_RESET_GPIO_DEINIT(handle, a_sim_reset_gpio_deinit);
+    DRIVER_PMW3901MB_LINK_RESET_GPIO_WRITE(handle, pmw3901mb_sim_reset_gpio_write);
+    DRIVER_PMW3901MB_LINK_DELAY_MS(handle, a_sim_delay_ms);
+    DRIVER_PMW3901MB_LINK_DELAY_US(handle, pmw3901mb_sim_delay_us);
+    DRIVER_PMW3901MB_LINK_GET_TIMESTAMP_US(handle, pmw3901mb_sim_get_timestamp_us);
+    DRIVER_PMW3901MB_LINK_DEBUG_PRINT(handle, pmw3901mb_sim_debug_print);
+    
+    return 0;
+}
+
+/**
+ * @brief      read the model
+ * @param[in]  reg register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of data buffer
+ * @return     status code
+ *             - 0 success
+ * @note       none
+ */
+static uint8_t a_sim_read(uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint16_t i;
+    
+    reg &= 0x7F;
+    a_sim_update();                                                                         /* run the frames */
+    if ((reg == SIM_REG_MOTION_BURST) && (gs_bank == 0) && (gs_powered != 0))               /* motion burst */
+    {
+        uint8_t burst[12];
+        
+        burst[0] = a_sim_latch();
+        burst[1] = gs_observation;
+        burst[2] = (uint8_t)((uint16_t)gs_latch_x & 0xFF);
+        burst[3] = (uint8_t)((uint16_t)gs_latch_x >> 8);
+        burst[4] = (uint8_t)((uint16_t)gs_latch_y & 0xFF);
+        burst[5] = (uint8_t)((uint16_t)gs_latch_y >> 8);
+        burst[6] = gs_squal;
+        burst[7] = gs_sum;
+        burst[8] = gs_max;
+        burst[9] = gs_min;
+        burst[10] = (uint8_t)((gs_config->shutter >> 8) & 0x1F);
+        burst[11] = (uint8_t)(gs_config->shutter & 0xFF);
+        for (i = 0; i < len; i++)
+        {
+            buf[i] = (i < 12) ? burst[i] : 0x00;
+        }
+        
+        return 0;
+    }
+    for (i = 0; i < len; i++)
+    {
+        buf[i] = a_sim_read_reg(reg);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     write the model
+ * @param[in] reg register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of data buffer
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+static uint8_t a_sim_write(uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    uint8_t value;
+    int32_t i;
+    
+    reg &= 0x7F;
+    if (len == 0)
+    {
+        return 0;
+    }
+    value = buf[len - 1];
+    a_sim_update();                                                                         /* run the frames */
+    if (reg == SIM_REG_POWER_UP_RESET)                                                      /* power up reset */
+    {
+        if (value == 0x5A)
+        {
+            gs_powered = 1;
+            a_sim_reset();
+        }
+        
+        return 0;
+    }
+    if (gs_powered == 0)                                                                    /* shutdown */
+    {
+        return 0;
+    }
+    if (reg == SIM_REG_BANK_SELECT)                                                         /* bank select */
+    {
+        gs_bank = value;
+        
+        return 0;
+    }
+    if (gs_bank != 0)                                                                       /* other banks */
+    {
+        gs_reg[gs_bank % SIM_BANK_NUM][reg] = value;
+        
+        return 0;
+    }
+    if (reg == SIM_REG_SHUTDOWN)                                                            /* shutdown */
+    {
+        if (value == 0xB6)
+        {
+            gs_powered = 0;
+        }
+    }
+    else if (reg == SIM_REG_OBSERVATION)                                                    /* clear observation */
+    {
+        gs_observation = value;
+    }
+    else if (reg == SIM_REG_RAW_DATA_GRAB)                                                  /* arm the grab */
+    {
+        for (i = 0; i < 35 * 35; i++)                                                       /* grab the surface */
+        {
+            gs_grab[i] = a_sim_pixel(gs_x + (i % 35) - 17, gs_y + (i / 35) - 17);
+        }
+        gs_grab_state = SIM_GRAB_ARMED;
+        gs_grab_ready_us = gs_time_ns / 1000 + gs_config->frame_us;
+        gs_grab_pixel = 0;
+        gs_grab_high = 0;
+    }
+    else if (reg != SIM_REG_MOTION)                                                         /* the motion write is ignored */
+    {
+        gs_reg[0][reg] = value;
+    }
+    else
+    {
+        /* nothing */
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief      simulator spi read
+ * @param[in]  reg register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of data buffer
+ * @return     status code
+ *             - 0 success
+ * @note       none
+ */
+uint8_t pmw3901mb_sim_spi_read(uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    a_sim_bus(0, len, 1);                                                                   /* bus time */
+    
+    return a_sim_read(reg, buf, len);                                                       /* read */
+}
+
+/**
+ * @brief     simulator spi write
+ * @param[in] reg register address with bit 7 set
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of data buffer
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t pmw3901mb_sim_spi_write(uint8_t reg, uint8_t *buf, uint16_t len)
+{
+    a_sim_bus(1, len, 1);                                                                   /* bus time */
+    
+    return a_sim_write(reg, buf, len);                                                      /* write */
+}
+
+/**
+ * @brief         simulator spi transfer batch
+ * @param[in,out] *transfer pointer to a transfer array
+ * @param[in]     num transfer number
+ * @return        status code
+ *                - 0 success
+ * @note          the call overhead is paid once, the chip select and the gaps for every transfer
+ */
+uint8_t pmw3901mb_sim_spi_transfer_batch(pmw3901mb_transfer_t *transfer, uint16_t num)
+{
+    uint16_t i;
+    
+    for (i = 0; i < num; i++)
+    {
+        if ((transfer[i].reg & 0x80) != 0)                                                  /* write */
+        {
+            a_sim_bus(1, transfer[i].len, (uint8_t)(i == 0));
+            (void)a_sim_write(transfer[i].reg, transfer[i].buf, transfer[i].len);
+        }
+        else
+        {
+            a_sim_bus(0, transfer[i].len, (uint8_t)(i == 0));
+            (void)a_sim_read(transfer[i].reg, transfer[i].buf, transfer[i].len);
+        }
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     simulator reset gpio write
+ * @param[in] value written value
+ * @return    status code
+ *            - 0 success
+ * @note      a low level resets the model
+ */
+uint8_t pmw3901mb_sim_reset_gpio_write(uint8_t value)
+{
+    if (value == 0)
+    {
+        gs_powered = 0;
+        a_sim_reset();
+    }
+    else
+    {
+        gs_powered = 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     advance the virtual time
+ * @param[in] us time in us
+ * @note      none
+ */
+void pmw3901mb_sim_delay_us(uint32_t us)
+{
+    gs_time_ns += (uint64_t)us * 1000;
+}
+
+/**
+ * @brief  get the virtual time
+ * @return time in us
+ * @note   none
+ */
+uint64_t pmw3901mb_sim_get_timestamp_us(void)
+{
+    return gs_time_ns / 1000;
+}
+
+/**
+ * @brief      get the bus counters
+ * @param[out] *bus pointer to a bus structure
+ * @return     status code
+ *             - 0 success
+ * @note       none
+ */
+uint8_t pmw3901mb_sim_get_bus(pmw3901mb_sim_bus_t *bus)
+{
+    *bus = gs_bus;
+    
+    return 0;
+}
+
+/**
+ * @brief  clear the bus counters
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+uint8_t pmw3901mb_sim_clear_bus(void)
+{
+    memset(&gs_bus, 0, sizeof(gs_bus));
+    
+    return 0;
+}
+
+/**
+ * @brief      get a register from the register file
+ * @param[in]  bank register bank
+ * @param[in]  reg register address
+ * @param[out] *value pointer to a value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 bank or reg is invalid
+ * @note       the file is read without the bus, so the bus counters and the read side effects are kept
+ */
+uint8_t pmw3901mb_sim_get_reg(uint8_t bank, uint8_t reg, uint8_t *value)
+{
+    if ((bank >= SIM_BANK_NUM) || (reg >= 0x80) || (value == NULL))
+    {
+        return 1;
+    }
+    
+    *value = gs_reg[bank][reg];
+    
+    return 0;
+}
+
+/**
+ * @brief  get the motion pin
+ * @return 1 if the motion pin is asserted, else 0
+ * @note   the pin is asserted while unread motion is accumulated
+ */
+uint8_t pmw3901mb_sim_get_motion_pin(void)
+{
+    a_sim_update();
+    
+    return ((gs_powered != 0) && ((gs_x != gs_reported_x) || (gs_y != gs_reported_y))) ? 1 : 0;
+}
+
+/**
+ * @brief     set the debug print
+ * @param[in] enable bool value
+ * @note      the print is enabled after start
+ */
+void pmw3901mb_sim_set_print(uint8_t enable)
+{
+    gs_print = enable;
+}
+
+/**
+ * @brief     simulator print format data
+ * @param[in] fmt format data
+ * @note      none
+ */
+void pmw3901mb_sim_debug_print(const char *const fmt, ...)
+{
+    va_list args;
+    
+    va_start(args, fmt);
+    pmw3901mb_sim_debug_vprint(fmt, args);
+    va_end(args);
+}
+
+/**
+ * @brief     simulator print format data with a va_list
+ * @param[in] fmt format data
+ * @param[in] args argument list
+ * @note      none
+ */
+void pmw3901mb_sim_debug_vprint(const char *const fmt, va_list args)
+{
+    if (gs_print == 0)
+    {
+        return;
+    }
+    (void)vprintf(fmt, args);
+}
@@ -0,0 +1,259 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_sim.h
+ * @brief     pmw3901mb behavioural simulator header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef PMW3901MB_SIM_H
+#define PMW3901MB_SIM_H
+
+#include "driver_pmw3901mb.h"
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup pmw3901mb_sim pmw3901mb simulator function
+ * @brief    pmw3901mb simulator function modules
+ * @ingroup  pmw3901mb_driver
+ * @{
+ */
+
+/**
+ * @brief pmw3901mb sim default definition
+ */
+#define PMW3901MB_SIM_DEFAULT_FRAME_US        8264        /**< about 121 frames per second */
+#define PMW3901MB_SIM_DEFAULT_SPI_HZ          2000000     /**< 2 MHz spi clock */
+#define PMW3901MB_SIM_DEFAULT_CS_NS           500         /**< chip select setup and hold of one transaction */
+#define PMW3901MB_SIM_DEFAULT_CALL_NS         8000        /**< syscall or hal cost of one spi call */
+#define PMW3901MB_SIM_DEFAULT_TSRAD_US        35          /**< read address to data time */
+#define PMW3901MB_SIM_DEFAULT_TSWW_US         45          /**< write to next command time */
+#define PMW3901MB_SIM_DEFAULT_TSRW_US         20          /**< read to next command time */
+#define PMW3901MB_SIM_DEFAULT_SHUTTER         0x0100      /**< default shutter */
+
+/**
+ * @brief pmw3901mb sim waypoint structure definition
+ */
+typedef struct pmw3901mb_sim_waypoint_s
+{
+    uint32_t duration_us;        /**< segment duration in us */
+    float vx;                    /**< x velocity in counts per second */
+    float vy;                    /**< y velocity in counts per second */
+} pmw3901mb_sim_waypoint_t;
+
+/**
+ * @brief pmw3901mb sim config structure definition
+ */
+typedef struct pmw3901mb_sim_config_s
+{
+    const pmw3901mb_sim_waypoint_t *trajectory;        /**< trajectory segments, NULL keeps the surface still */
+    uint32_t trajectory_len;                           /**< trajectory segment number */
+    uint8_t trajectory_loop;                           /**< bool value, 1 repeats the trajectory */
+    uint8_t (*texture)(int32_t x, int32_t y);          /**< surface texture in counts, NULL uses the built-in texture */
+    uint32_t frame_us;                                 /**< sensor frame period in us */
+    uint32_t spi_hz;                                   /**< spi clock */
+    uint32_t cs_ns;                                    /**< chip select overhead of one transaction in ns */
+    uint32_t call_ns;                                  /**< syscall or hal overhead of one spi call in ns */
+    uint32_t tsrad_us;                                 /**< read address to data time in us */
+    uint32_t tsww_us;                                  /**< write to next command time in us */
+    uint32_t tsrw_us;                                  /**< read to next command time in us */
+    uint8_t batch;                                     /**< bool value, 1 links the batch hook */
+    uint16_t shutter;                                  /**< reported shutter */
+    uint8_t handshake_fail;                            /**< reads of the bank 0x0E 0x47 handshake that fail after a reset */
+} pmw3901mb_sim_config_t;
+
+/**
+ * @brief pmw3901mb sim bus structure definition
+ */
+typedef struct pmw3901mb_sim_bus_s
+{
+    uint32_t calls;              /**< spi calls, a batch is one call */
+    uint32_t transactions;       /**< chip select cycles */
+    uint32_t bytes;              /**< clocked bytes including the address bytes */
+    uint64_t busy_ns;            /**< time the bus is held, only one device can use it */
+    uint64_t stall_ns;           /**< time waited for tsww or tsrw, other devices can use the bus */
+} pmw3901mb_sim_bus_t;
+
+/**
+ * @brief      get the default config
+ * @param[out] *config pointer to a config structure
+ * @return     status code
+ *             - 0 success
+ * @note       none
+ */
+uint8_t pmw3901mb_sim_get_default_config(pmw3901mb_sim_config_t *config);
+
+/**
+ * @brief     reset the model and the virtual time
+ * @param[in] *config pointer to a config structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 config is invalid
+ * @note      the config is referenced, not copied
+ */
+uint8_t pmw3901mb_sim_init(const pmw3901mb_sim_config_t *config);
+
+/**
+ * @brief         link the simulator to a handle
+ * @param[in,out] *handle pointer to a pmw3901mb handle structure
+ * @return        status code
+ *                - 0 success
+ *                - 1 link failed
+ * @note          the handle is cleared first
+ */
+uint8_t pmw3901mb_sim_link(pmw3901mb_handle_t *handle);
+
+/**
+ * @brief      simulator spi read
+ * @param[in]  reg register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len length of data buffer
+ * @return     status code
+ *             - 0 success
+ * @note       none
+ */
+uint8_t pmw3901mb_sim_spi_read(uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief         simulator spi transfer batch
+ * @param[in,out] *transfer pointer to a transfer array
+ * @param[in]     num transfer number
+ * @return        status code
+ *                - 0 success
+ * @note          the call overhead is paid once, the chip select and the gaps for every transfer
+ */
+uint8_t pmw3901mb_sim_spi_transfer_batch(pmw3901mb_transfer_t *transfer, uint16_t num);
+
+/**
+ * @brief     simulator spi write
+ * @param[in] reg register address with bit 7 set
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len length of data buffer
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t pmw3901mb_sim_spi_write(uint8_t reg, uint8_t *buf, uint16_t len);
+
+/**
+ * @brief     simulator reset gpio write
+ * @param[in] value written value
+ * @return    status code
+ *            - 0 success
+ * @note      a low level resets the model
+ */
+uint8_t pmw3901mb_sim_reset_gpio_write(uint8_t value);
+
+/**
+ * @brief     advance the virtual time
+ * @param[in] us time in us
+ * @note      none
+ */
+void pmw3901mb_sim_delay_us(uint32_t us);
+
+/**
+ * @brief  get the virtual time
+ * @return time in us
+ * @note   none
+ */
+uint64_t pmw3901mb_sim_get_timestamp_us(void);
+
+/**
+ * @brief      get the bus counters
+ * @param[out] *bus pointer to a bus structure
+ * @return     status code
+ *             - 0 success
+ * @note       none
+ */
+uint8_t pmw3901mb_sim_get_bus(pmw3901mb_sim_bus_t *bus);
+
+/**
+ * @brief  clear the bus counters
+ * @return status code
+ *         - 0 success
+ * @note   none
+ */
+uint8_t pmw3901mb_sim_clear_bus(void);
+
+/**
+ * @brief      get a register from the register file
+ * @param[in]  bank register bank
+ * @param[in]  reg register address
+ * @param[out] *value pointer to a value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 bank or reg is invalid
+ * @note       the file is read without the bus, so the bus counters and the read side effects are kept
+ */
+uint8_t pmw3901mb_sim_get_reg(uint8_t bank, uint8_t reg, uint8_t *value);
+
+/**
+ * @brief  get the motion pin
+ * @return 1 if the motion pin is asserted, else 0
+ * @note   the pin is asserted while unread motion is accumulated
+ */
+uint8_t pmw3901mb_sim_get_motion_pin(void);
+
+/**
+ * @brief     set the debug print
+ * @param[in] enable bool value
+ * @note      the print is enabled after start
+ */
+void pmw3901mb_sim_set_print(uint8_t enable);
+
+/**
+ * @brief     simulator print format data
+ * @param[in] fmt format data
+ * @note      none
+ */
+void pmw3901mb_sim_debug_print(const char *const fmt, ...);
+
+/**
+ * @brief     simulator print format data with a va_list
+ * @param[in] fmt format data
+ * @param[in] args argument list
+ * @note      none
+ */
+void pmw3901mb_sim_debug_vprint(const char *const fmt, va_list args);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,304 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_sim_main.c
+ * @brief     pmw3901mb simulator runner source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_pmw3901mb_interrupt_test.h"
+#include "driver_pmw3901mb_frame_test.h"
+#include "driver_pmw3901mb_read_test.h"
+#include "driver_pmw3901mb_register_test.h"
+#include "pmw3901mb_sim.h"
+#include "pmw3901mb_sim_test.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief global var definition
+ */
+uint8_t (*g_gpio_irq)(float m) = NULL;        /**< gpio irq function address */
+
+/**
+ * @brief trajectory definition
+ */
+static const pmw3901mb_sim_waypoint_t gsc_line[] =
+{
+    {1000000, 300.0f, 150.0f},
+};
+static const pmw3901mb_sim_waypoint_t gsc_square[] =
+{
+    {250000, 400.0f, 0.0f},
+    {250000, 0.0f, 400.0f},
+    {250000, -400.0f, 0.0f},
+    {250000, 0.0f, -400.0f},
+};
+
+/**
+ * @brief     flat surface texture
+ * @param[in] x x in counts
+ * @param[in] y y in counts
+ * @return    pixel value
+ * @note      it has no features, the sensor reports a low surface quality
+ */
+static uint8_t a_texture_flat(int32_t x, int32_t y)
+{
+    (void)x;
+    (void)y;
+    
+    return 0x80;
+}
+
+/**
+ * @brief  get the monotonic time
+ * @return time in ns
+ * @note   none
+ */
+static uint64_t a_now_ns(void)
+{
+    struct timespec ts;
+    
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief     run the burst read bench
+ * @param[in] samples sample number
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      none
+ */
+static uint8_t a_bench(uint32_t samples)
+{
+    pmw3901mb_handle_t handle;
+    pmw3901mb_motion_t motion;
+    uint64_t start;
+    uint64_t ns;
+    uint32_t i;
+    uint32_t valid;
+    
+    (void)pmw3901mb_sim_link(&handle);
+    if ((pmw3901mb_init(&handle) != 0) || (pmw3901mb_power_up(&handle) != 0) ||
+        (pmw3901mb_set_optimum_performance(&handle) != 0))
+    {
+        return 1;
+    }
+    valid = 0;
+    start = a_now_ns();
+    for (i = 0; i < samples; i++)
+    {
+        if (pmw3901mb_burst_read(&handle, &motion) != 0)
+        {
+            (void)pmw3901mb_deinit(&handle);
+            
+            return 1;
+        }
+        valid += (motion.is_valid == 1);
+    }
+    ns = a_now_ns() - start;
+    printf("burst_read: %u samples, %u valid, %.0f samples per second, %.3f s virtual time.\n",
+           samples, valid, (double)samples * 1e9 / (double)(ns ? ns : 1),
+           (double)pmw3901mb_sim_get_timestamp_us() / 1e6);
+    (void)pmw3901mb_deinit(&handle);
+    
+    return 0;
+}
+
+/**
+ * @brief     main function
+ * @param[in] argc arg numbers
+ * @param[in] **argv arg address
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      none
+ */
+int main(int argc, char **argv)
+{
+    pmw3901mb_sim_config_t config;
+    const char *test;
+    uint32_t times;
+    uint32_t samples;
+    float height;
+    uint64_t start;
+    uint64_t ns;
+    uint8_t res;
+    int i;
+    
+    (void)pmw3901mb_sim_get_default_config(&config);
+    config.trajectory = gsc_line;
+    config.trajectory_len = sizeof(gsc_line) / sizeof(gsc_line[0]);
+    config.trajectory_loop = 1;
+    test = NULL;
+    times = 3;
+    samples = 0;
+    height = 1.0f;
+    for (i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+        {
+            test = argv[++i];
+        }
+        else if (strncmp(argv[i], "--test=", 7) == 0)
+        {
+            test = argv[i] + 7;
+        }
+        else if (strncmp(argv[i], "--bench=", 8) == 0)
+        {
+            samples = (uint32_t)strtoul(argv[i] + 8, NULL, 10);
+        }
+        else if (strncmp(argv[i], "--times=", 8) == 0)
+        {
+            times = (uint32_t)strtoul(argv[i] + 8, NULL, 10);
+        }
+        else if (strncmp(argv[i], "--height=", 9) == 0)
+        {
+            height = (float)atof(argv[i] + 9);
+        }
+        else if (strcmp(argv[i], "--trajectory=still") == 0)
+        {
+            config.trajectory = NULL;
+            config.trajectory_len = 0;
+        }
+        else if (strcmp(argv[i], "--trajectory=line") == 0)
+        {
+            config.trajectory = gsc_line;
+            config.trajectory_len = sizeof(gsc_line) / sizeof(gsc_line[0]);
+        }
+        else if (strcmp(argv[i], "--trajectory=square") == 0)
+        {
+            config.trajectory = gsc_square;
+            config.trajectory_len = sizeof(gsc_square) / sizeof(gsc_square[0]);
+        }
+        else if (strcmp(argv[i], "--texture=flat") == 0)
+        {
+            config.texture = a_texture_flat;
+        }
+        else if (strcmp(argv[i], "--quiet") == 0)
+        {
+            pmw3901mb_sim_set_print(0);
+        }
+        else
+        {
+            test = NULL;
+            samples = 0;
+            break;
+        }
+    }
+    if (((test == NULL) && (samples == 0)) || (pmw3901mb_sim_init(&config) != 0))
+    {
+        printf("Usage:\n");
+        printf("  pmw3901mb_sim (-t reg | --test=reg)\n");
+        printf("  pmw3901mb_sim (-t read | --test=read) [--height=<m>] [--times=<num>]\n");
+        printf("  pmw3901mb_sim (-t frame | --test=frame) [--times=<num>]\n");
+        printf("  pmw3901mb_sim (-t int | --test=int) [--times=<num>]\n");
+        printf("  pmw3901mb_sim (-t frame_step | --test=frame_step)\n");
+        printf("  pmw3901mb_sim (-t boot | --test=boot)\n");
+        printf("  pmw3901mb_sim (-t odometry | --test=odometry)\n");
+        printf("  pmw3901mb_sim (-t shadow | --test=shadow)\n");
+        printf("  pmw3901mb_sim (-t resume | --test=resume)\n");
+        printf("  pmw3901mb_sim (-t trace | --test=trace)\n");
+        printf("  pmw3901mb_sim --bench=<samples>\n");
+        printf("\n");
+        printf("Options:\n");
+        printf("      --quiet                 Drop the driver and test output.\n");
+        printf("      --texture=flat          Use a surface without features.\n");
+        printf("      --trajectory=<still | line | square>\n");
+        printf("                              Set the surface motion.([default: line])\n");
+        
+        return 1;
+    }
+    
+    start = a_now_ns();
+    if (samples != 0)
+    {
+        res = a_bench(samples);
+    }
+    else if (strcmp(test, "reg") == 0)
+    {
+        res = pmw3901mb_register_test();
+    }
+    else if (strcmp(test, "read") == 0)
+    {
+        res = pmw3901mb_read_test(height, times);
+    }
+    else if (strcmp(test, "frame") == 0)
+    {
+        res = pmw3901mb_frame_test(times);
+    }
+    else if (strcmp(test, "int") == 0)
+    {
+        g_gpio_irq = pmw3901mb_interrupt_test_irq_handler;
+        res = pmw3901mb_interrupt_test(times);
+        g_gpio_irq = NULL;
+    }
+    else if (strcmp(test, "frame_step") == 0)
+    {
+        res = pmw3901mb_sim_test_frame_step();
+    }
+    else if (strcmp(test, "boot") == 0)
+    {
+        res = pmw3901mb_sim_test_boot();
+    }
+    else if (strcmp(test, "odometry") == 0)
+    {
+        res = pmw3901mb_sim_test_odometry();
+    }
+    else if (strcmp(test, "shadow") == 0)
+    {
+        res = pmw3901mb_sim_test_shadow();
+    }
+    else if (strcmp(test, "resume") == 0)
+    {
+        res = pmw3901mb_sim_test_resume();
+    }
+    else if (strcmp(test, "trace") == 0)
+    {
+        res = pmw3901mb_sim_test_trace();
+    }
+    else
+    {
+        printf("pmw3901mb_sim: unknown test %s.\n", test);
+        
+        return 1;
+    }
+    ns = a_now_ns() - start;
+    printf("pmw3901mb_sim: %s in %.3f ms wall time, %.3f s virtual time.\n", (res == 0) ? "passed" : "failed",
+           (double)ns / 1e6, (double)pmw3901mb_sim_get_timestamp_us() / 1e6);
+    
+    return (res == 0) ? 0 : 1;
+}
@@ -0,0 +1,968 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_sim_test.c
+ * @brief     pmw3901mb simulator test source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "pmw3901mb_sim_test.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief sim test frame step budget definition
+ */
+#define SIM_TEST_FRAME_BUDGET        64          /**< register reads of one frame step */
+#define SIM_TEST_FRAME_POLL_US       250         /**< wait before the next frame step without progress */
+#define SIM_TEST_FRAME_STEP_MAX      10000       /**< max frame steps */
+
+/**
+ * @brief sim test trace size definition
+ */
+#define SIM_TEST_TRACE_SIZE          512         /**< entries of one trace ring */
+
+/**
+ * @brief sim test trace wrap definition
+ */
+#define SIM_TEST_TRACE_WRAP_SIZE     3           /**< entries of the wrap trace ring, not a power of 2 */
+#define SIM_TEST_TRACE_WRAP_COUNT    0xFFFFFFFEU /**< transfer count before the wrap */
+
+/**
+ * @brief sim test register file definition
+ */
+#define SIM_TEST_BANK_NUM            0x20        /**< simulated register banks */
+
+/**
+ * @brief sim test odometry definition
+ */
+#define SIM_TEST_ODOMETRY_PERIOD_US  2000        /**< odometry read period */
+#define SIM_TEST_ODOMETRY_END_US     1100000     /**< odometry run time, after the trajectory end */
+
+/**
+ * @brief sim test odometry trajectory definition
+ */
+static const pmw3901mb_sim_waypoint_t gsc_odometry[] =
+{
+    {500000, 400.0f, -200.0f},
+    {500000, -100.0f, 300.0f},
+};
+
+static pmw3901mb_handle_t gs_handle;             /**< pmw3901mb handle */
+static pmw3901mb_sim_config_t gs_config;         /**< sim config */
+static uint8_t gs_frame[35][35];                 /**< blocking frame */
+static uint8_t gs_frame_step[35][35];            /**< non-blocking frame */
+static pmw3901mb_trace_t gs_trace;               /**< trace */
+static pmw3901mb_trace_t gs_trace_boot;          /**< boot trace */
+static pmw3901mb_trace_entry_t gs_entry[SIM_TEST_TRACE_SIZE];         /**< trace entry */
+static pmw3901mb_trace_entry_t gs_entry_boot[SIM_TEST_TRACE_SIZE];    /**< boot trace entry */
+static pmw3901mb_shadow_t gs_shadow[PMW3901MB_SHADOW_MAX];            /**< shadow registers */
+static pmw3901mb_sequence_t gs_image[PMW3901MB_IMAGE_MAX];            /**< resume image */
+static uint8_t gs_reg[SIM_TEST_BANK_NUM][0x80];                       /**< register file after the full init */
+
+/**
+ * @brief     start the model and bring up the chip
+ * @param[in] optimum bool value, 1 runs set optimum performance
+ * @return    status code
+ *            - 0 success
+ *            - 1 start failed
+ * @note      the config must be set before
+ */
+static uint8_t a_sim_test_start(uint8_t optimum)
+{
+    if (pmw3901mb_sim_init(&gs_config) != 0)
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: sim init failed.\n");
+        
+        return 1;
+    }
+    (void)pmw3901mb_sim_link(&gs_handle);
+    if (pmw3901mb_init(&gs_handle) != 0)
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: init failed.\n");
+        
+        return 1;
+    }
+    if (pmw3901mb_power_up(&gs_handle) != 0)
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: power up failed.\n");
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if ((optimum != 0) && (pmw3901mb_set_optimum_performance(&gs_handle) != 0))
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: set optimum performance failed.\n");
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  non-blocking frame read test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the surface is kept still and the frame of frame_begin and frame_step
+ *         must be the same as the frame of get_frame, with and without the batch hook
+ */
+uint8_t pmw3901mb_sim_test_frame_step(void)
+{
+    pmw3901mb_frame_status_t status;
+    uint16_t pixel;
+    uint16_t last;
+    uint32_t steps;
+    uint8_t batch;
+    
+    pmw3901mb_sim_debug_print("pmw3901mb: start frame step test.\n");
+    for (batch = 0; batch < 2; batch++)
+    {
+        (void)pmw3901mb_sim_get_default_config(&gs_config);
+        gs_config.batch = batch;
+        if (a_sim_test_start(0) != 0)
+        {
+            return 1;
+        }
+        if (pmw3901mb_start_frame_capture(&gs_handle) != 0)
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: start frame capture failed.\n");
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+        memset(gs_frame, 0, sizeof(gs_frame));
+        if (pmw3901mb_get_frame(&gs_handle, gs_frame) != 0)
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: get frame failed.\n");
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+        
+        memset(gs_frame_step, 0, sizeof(gs_frame_step));
+        if (pmw3901mb_frame_begin(&gs_handle, gs_frame_step) != 0)
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: frame begin failed.\n");
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+        last = 0;
+        status = PMW3901MB_FRAME_STATUS_WAIT;
+        for (steps = 0; (status != PMW3901MB_FRAME_STATUS_DONE) && (steps < SIM_TEST_FRAME_STEP_MAX); steps++)
+        {
+            if (pmw3901mb_frame_step(&gs_handle, SIM_TEST_FRAME_BUDGET, &status, &pixel) != 0)
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: frame step failed.\n");
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+            if ((pixel < last) || (pixel - last > SIM_TEST_FRAME_BUDGET))
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: frame step pixel %d after %d is out of the budget.\n", pixel, last);
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+            if ((status == PMW3901MB_FRAME_STATUS_WAIT) || (pixel == last))
+            {
+                pmw3901mb_sim_delay_us(SIM_TEST_FRAME_POLL_US);
+            }
+            last = pixel;
+        }
+        if ((status != PMW3901MB_FRAME_STATUS_DONE) || (pixel != 35 * 35))
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: frame step is not done after %d steps.\n", steps);
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+        if (memcmp(gs_frame, gs_frame_step, sizeof(gs_frame)) != 0)
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: frame step differs from get frame.\n");
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+        pmw3901mb_sim_debug_print("pmw3901mb: batch %d frame step matches get frame in %d steps.\n", batch, steps);
+        (void)pmw3901mb_stop_frame_capture(&gs_handle);
+        (void)pmw3901mb_deinit(&gs_handle);
+    }
+    pmw3901mb_sim_debug_print("pmw3901mb: finish frame step test.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  non-blocking boot test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the spi trace of boot_begin and boot_step must be the same as the one of init, power up and
+ *         set optimum performance, also when the 0x47 handshake needs retries, the gaps between the
+ *         transfers must be the same after the power up reset, power up pulses the reset once more,
+ *         the 0x43 command is written once and only the 0x47 read is polled inside the 100 ms retry delay,
+ *         without delay_us both paths wait the whole retry delay and write the 0x43 command on every retry,
+ *         the gaps are not compared then because the blocking path rounds the short waits up to ms
+ */
+uint8_t pmw3901mb_sim_test_boot(void)
+{
+    pmw3901mb_boot_status_t status;
+    uint32_t wait_us;
+    uint32_t steps;
+    uint32_t handshake;
+    uint32_t command;
+    uint32_t i;
+    uint8_t batch;
+    uint8_t fine;
+    uint8_t mode;
+    uint8_t fail;
+    
+    pmw3901mb_sim_debug_print("pmw3901mb: start boot test.\n");
+    for (fail = 0; fail < 4; fail += 2)
+    {
+        for (mode = 0; mode < 3; mode++)
+        {
+            /* without batch, with batch and without batch and delay_us */
+            batch = (mode == 1) ? 1 : 0;
+            fine = (mode != 2) ? 1 : 0;
+            
+            /* blocking */
+            (void)pmw3901mb_sim_get_default_config(&gs_config);
+            gs_config.batch = batch;
+            gs_config.handshake_fail = fail;
+            (void)pmw3901mb_sim_init(&gs_config);
+            (void)pmw3901mb_sim_link(&gs_handle);
+            if (fine == 0)
+            {
+                DRIVER_PMW3901MB_LINK_DELAY_US(&gs_handle, NULL);
+            }
+            (void)pmw3901mb_set_trace(&gs_handle, &gs_trace, gs_entry, SIM_TEST_TRACE_SIZE);
+            if ((pmw3901mb_init(&gs_handle) != 0) || (pmw3901mb_power_up(&gs_handle) != 0) ||
+                (pmw3901mb_set_optimum_performance(&gs_handle) != 0))
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: blocking boot failed.\n");
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            /* non-blocking */
+            (void)pmw3901mb_sim_init(&gs_config);
+            (void)pmw3901mb_sim_link(&gs_handle);
+            if (fine == 0)
+            {
+                DRIVER_PMW3901MB_LINK_DELAY_US(&gs_handle, NULL);
+            }
+            (void)pmw3901mb_set_trace(&gs_handle, &gs_trace_boot, gs_entry_boot, SIM_TEST_TRACE_SIZE);
+            if (pmw3901mb_boot_begin(&gs_handle, &wait_us) != 0)
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: boot begin failed.\n");
+                
+                return 1;
+            }
+            status = PMW3901MB_BOOT_STATUS_BUSY;
+            for (steps = 0; status != PMW3901MB_BOOT_STATUS_DONE; steps++)
+            {
+                pmw3901mb_sim_delay_us(wait_us);
+                if (pmw3901mb_boot_step(&gs_handle, &wait_us, &status) != 0)
+                {
+                    pmw3901mb_sim_debug_print("pmw3901mb: boot step failed.\n");
+                    
+                    return 1;
+                }
+            }
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            /* compare */
+            if ((gs_trace.count != gs_trace_boot.count) || (gs_trace.count > SIM_TEST_TRACE_SIZE))
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: boot has %d transfers and blocking boot has %d.\n",
+                                          gs_trace_boot.count, gs_trace.count);
+                
+                return 1;
+            }
+            handshake = 0;
+            command = 0;
+            for (i = 0; i < gs_trace.count; i++)
+            {
+                if (((fine != 0) && (i > 1) && (gs_entry[i].timestamp_us - gs_entry[i - 1].timestamp_us !=
+                                 gs_entry_boot[i].timestamp_us - gs_entry_boot[i - 1].timestamp_us)) ||
+                    (gs_entry[i].reg != gs_entry_boot[i].reg) ||
+                    (gs_entry[i].result != gs_entry_boot[i].result) ||
+                    (gs_entry[i].len != gs_entry_boot[i].len) ||
+                    (memcmp(gs_entry[i].payload, gs_entry_boot[i].payload, sizeof(gs_entry[i].payload)) != 0))
+                {
+                    pmw3901mb_sim_debug_print("pmw3901mb: boot transfer %d reg 0x%02X at %d us differs from "
+                                              "reg 0x%02X at %d us.\n", i,
+                                              gs_entry_boot[i].reg, gs_entry_boot[i].timestamp_us,
+                                              gs_entry[i].reg, gs_entry[i].timestamp_us);
+                    
+                    return 1;
+                }
+                if (gs_entry[i].reg == 0x47)
+                {
+                    handshake++;
+                }
+                if ((gs_entry[i].reg == (0x80 | 0x43)) && (gs_entry[i].payload[0] == 0x10))
+                {
+                    command++;
+                }
+            }
+            if (command != ((fine != 0) ? 1 : (uint32_t)fail + 1))
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: handshake command is written %d times, expect %d.\n",
+                                          command, (fine != 0) ? 1 : fail + 1);
+                
+                return 1;
+            }
+            if (handshake != (uint32_t)fail + 1)
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: handshake is read %d times, expect %d.\n", handshake, fail + 1);
+                
+                return 1;
+            }
+            pmw3901mb_sim_debug_print("pmw3901mb: batch %d delay_us %d handshake fail %d boot matches blocking boot, "
+                                      "%d transfers in %d steps.\n", batch, fine, fail, gs_trace.count, steps);
+        }
+    }
+    pmw3901mb_sim_debug_print("pmw3901mb: finish boot test.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  odometry test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the surface runs a two segment trajectory, the height changes at the segment end,
+ *         the position and the displacement since the checkpoint must match the read deltas
+ *         and the trajectory, the q16 conversion must match the float one and saturate
+ */
+uint8_t pmw3901mb_sim_test_odometry(void)
+{
+    static const int32_t height_q16[2] = {0x10000, 0x28000};
+    static const int16_t raw[4] = {32767, -32768, 1000, -7};
+    pmw3901mb_motion_t motion;
+    int64_t x;
+    int64_t y;
+    int64_t expect_x;
+    int64_t expect_y;
+    int64_t count_x[2];
+    int64_t count_y[2];
+    int32_t scale[2];
+    int32_t cm_q16[4];
+    uint32_t invalid;
+    uint8_t phase;
+    uint8_t i;
+    float cm;
+    
+    pmw3901mb_sim_debug_print("pmw3901mb: start odometry test.\n");
+    (void)pmw3901mb_sim_get_default_config(&gs_config);
+    gs_config.trajectory = gsc_odometry;
+    gs_config.trajectory_len = sizeof(gsc_odometry) / sizeof(gsc_odometry[0]);
+    gs_config.trajectory_loop = 0;
+    if (a_sim_test_start(1) != 0)
+    {
+        return 1;
+    }
+    
+    /* the q16 scale must match the float conversion */
+    for (phase = 0; phase < 2; phase++)
+    {
+        if (pmw3901mb_get_delta_scale_q16(&gs_handle, height_q16[phase], &scale[phase]) != 0)
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: get delta scale q16 failed.\n");
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+        (void)pmw3901mb_delta_raw_to_delta_cm(&gs_handle, 1000, (float)height_q16[phase] / 65536.0f, &cm);
+        if (fabs((double)scale[phase] * 1000.0 / 65536.0 - cm) > 1000.0 / 65536.0)
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: q16 scale %d differs from the float %f cm per 1000 counts.\n",
+                                      scale[phase], cm);
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    
+    /* integrate the trajectory, the height changes with the segment */
+    if (pmw3901mb_odometry_reset(&gs_handle, height_q16[0]) != 0)
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: odometry reset failed.\n");
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    memset(count_x, 0, sizeof(count_x));
+    memset(count_y, 0, sizeof(count_y));
+    invalid = 0;
+    phase = 0;
+    while (pmw3901mb_sim_get_timestamp_us() < SIM_TEST_ODOMETRY_END_US)
+    {
+        if ((phase == 0) && (pmw3901mb_sim_get_timestamp_us() >= gsc_odometry[0].duration_us))
+        {
+            phase = 1;
+            if ((pmw3901mb_odometry_set_checkpoint(&gs_handle) != 0) ||
+                (pmw3901mb_odometry_set_height(&gs_handle, height_q16[1]) != 0))
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: odometry checkpoint failed.\n");
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+        }
+        if (pmw3901mb_odometry_burst_read(&gs_handle, &motion) != 0)
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: odometry burst read failed.\n");
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+        if (motion.is_valid == 1)
+        {
+            count_x[phase] += motion.delta_x;
+            count_y[phase] += motion.delta_y;
+        }
+        else if (motion.is_valid == 2)
+        {
+            invalid++;
+        }
+        else
+        {
+            /* no motion */
+        }
+        pmw3901mb_sim_delay_us(SIM_TEST_ODOMETRY_PERIOD_US);
+    }
+    
+    /* the read deltas must add up to the trajectory */
+    if ((invalid != 0) || (count_x[0] + count_x[1] != 150) || (count_y[0] + count_y[1] != 50))
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: read %lld, %lld counts with %d invalid samples, expect 150, 50.\n",
+                                  (long long)(count_x[0] + count_x[1]), (long long)(count_y[0] + count_y[1]), invalid);
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* the position integrates both heights */
+    (void)pmw3901mb_odometry_get_position(&gs_handle, &x, &y);
+    expect_x = count_x[0] * scale[0] + count_x[1] * scale[1];
+    expect_y = count_y[0] * scale[0] + count_y[1] * scale[1];
+    if ((x != expect_x) || (y != expect_y))
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: position %lld, %lld differs from %lld, %lld.\n",
+                                  (long long)x, (long long)y, (long long)expect_x, (long long)expect_y);
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* the checkpoint keeps only the second segment */
+    (void)pmw3901mb_odometry_get_since_checkpoint(&gs_handle, &x, &y);
+    if ((x != count_x[1] * scale[1]) || (y != count_y[1] * scale[1]) || (count_x[1] >= 0) || (count_y[1] <= 0))
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: since checkpoint %lld, %lld differs from %lld, %lld.\n",
+                                  (long long)x, (long long)y,
+                                  (long long)(count_x[1] * scale[1]), (long long)(count_y[1] * scale[1]));
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    pmw3901mb_sim_debug_print("pmw3901mb: odometry %0.3f cm, %0.3f cm, since checkpoint %0.3f cm, %0.3f cm.\n",
+                              (double)expect_x / 65536.0, (double)expect_y / 65536.0,
+                              (double)x / 65536.0, (double)y / 65536.0);
+    
+    /* the invalid samples are not integrated */
+    (void)pmw3901mb_odometry_get_position(&gs_handle, &expect_x, &expect_y);
+    motion.delta_x = 1000;
+    motion.delta_y = -1000;
+    motion.is_valid = 0;
+    (void)pmw3901mb_odometry_update(&gs_handle, &motion);
+    (void)pmw3901mb_odometry_get_position(&gs_handle, &x, &y);
+    if ((x != expect_x) || (y != expect_y))
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: invalid sample is integrated.\n");
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    
+    /* the q16 conversion saturates at 8 m and not at 4 m, the scale rounding is half a lsb per count */
+    if (pmw3901mb_delta_raw_to_delta_cm_q16(&gs_handle, raw, 8 * 0x10000, cm_q16, 4) != 0)
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: delta raw to delta cm q16 failed.\n");
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    (void)pmw3901mb_get_delta_scale_q16(&gs_handle, 8 * 0x10000, &scale[0]);
+    if ((cm_q16[0] != INT32_MAX) || (cm_q16[1] != INT32_MIN) ||
+        (cm_q16[2] != 1000 * scale[0]) || (cm_q16[3] != -7 * scale[0]))
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: q16 saturation at 8 m is wrong.\n");
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    (void)pmw3901mb_delta_raw_to_delta_cm_q16(&gs_handle, raw, 4 * 0x10000, cm_q16, 4);
+    for (i = 0; i < 4; i++)
+    {
+        (void)pmw3901mb_delta_raw_to_delta_cm(&gs_handle, raw[i], 4.0f, &cm);
+        if ((cm_q16[i] == INT32_MAX) || (cm_q16[i] == INT32_MIN) ||
+            (fabs((double)cm_q16[i] / 65536.0 - cm) > (fabs((double)raw[i]) + 1.0) / 65536.0 + 0.01))
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: q16 %0.4f cm differs from the float %0.4f cm at 4 m.\n",
+                                      (double)cm_q16[i] / 65536.0, cm);
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+    }
+    if (pmw3901mb_get_delta_scale_q16(&gs_handle, -1, &scale[0]) != 1)
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: negative height is accepted.\n");
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    (void)pmw3901mb_deinit(&gs_handle);
+    pmw3901mb_sim_debug_print("pmw3901mb: finish odometry test.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  shadow test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the bus transactions of init, power up, set optimum performance and a frame capture
+ *         start and stop are counted without and with the shadow, the sequences already select
+ *         each bank once before the writes of the bank, so the shadow only drops one bank select
+ *         that repeats the known bank, measured 102 to 101 transactions for the init and 19 to 18
+ *         for the frame capture, the 576 bytes of the register tables are not worth it on their own
+ */
+uint8_t pmw3901mb_sim_test_shadow(void)
+{
+    static const uint32_t init_transactions[2] = {102, 101};
+    static const uint32_t frame_transactions[2] = {19, 18};
+    pmw3901mb_sim_bus_t bus;
+    uint8_t value;
+    uint8_t enable;
+    
+    pmw3901mb_sim_debug_print("pmw3901mb: start shadow test.\n");
+    for (enable = 0; enable < 2; enable++)
+    {
+        (void)pmw3901mb_sim_get_default_config(&gs_config);
+        if (pmw3901mb_sim_init(&gs_config) != 0)
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: sim init failed.\n");
+            
+            return 1;
+        }
+        (void)pmw3901mb_sim_link(&gs_handle);
+        if ((pmw3901mb_set_shadow(&gs_handle, enable) != 0) ||
+            (pmw3901mb_set_shadow_buffer(&gs_handle, gs_shadow, PMW3901MB_SHADOW_MAX) != 0))
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: set shadow failed.\n");
+            
+            return 1;
+        }
+        (void)pmw3901mb_sim_clear_bus();
+        if ((pmw3901mb_init(&gs_handle) != 0) || (pmw3901mb_power_up(&gs_handle) != 0) ||
+            (pmw3901mb_set_optimum_performance(&gs_handle) != 0))
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: init failed.\n");
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+        (void)pmw3901mb_sim_get_bus(&bus);
+        pmw3901mb_sim_debug_print("pmw3901mb: shadow %d init %d transactions.\n", enable, bus.transactions);
+        if (bus.transactions != init_transactions[enable])
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: init transactions are %d, expect %d.\n",
+                                      bus.transactions, init_transactions[enable]);
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+        
+        /* the shadow keeps the last optimum value, without it nothing is kept */
+        if (enable != 0)
+        {
+            if ((pmw3901mb_get_shadow_reg(&gs_handle, 0x00, 0x40, &value) != 0) || (value != 0x80))
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: shadow register is wrong.\n");
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+        }
+        else
+        {
+            if (pmw3901mb_get_shadow_reg(&gs_handle, 0x00, 0x40, &value) == 0)
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: disabled shadow keeps a register.\n");
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+        }
+        
+        (void)pmw3901mb_sim_clear_bus();
+        if ((pmw3901mb_start_frame_capture(&gs_handle) != 0) || (pmw3901mb_stop_frame_capture(&gs_handle) != 0))
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: frame capture failed.\n");
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+        (void)pmw3901mb_sim_get_bus(&bus);
+        pmw3901mb_sim_debug_print("pmw3901mb: shadow %d frame capture %d transactions.\n", enable, bus.transactions);
+        if (bus.transactions != frame_transactions[enable])
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: frame capture transactions are %d, expect %d.\n",
+                                      bus.transactions, frame_transactions[enable]);
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+        (void)pmw3901mb_deinit(&gs_handle);
+    }
+    pmw3901mb_sim_debug_print("pmw3901mb: finish shadow test.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief      compare the writes of two trace ranges
+ * @param[in]  a first entry of the first range
+ * @param[in]  a_end end of the first range
+ * @param[in]  b first entry of the second range
+ * @param[in]  b_end end of the second range
+ * @param[out] *handshake pointer to a 0x47 read number buffer of the second range
+ * @return     status code
+ *             - 0 success
+ *             - 1 the writes differ
+ * @note       the reads of the resolved branches are skipped, the trace must not wrap
+ */
+static uint8_t a_sim_test_compare_writes(uint32_t a, uint32_t a_end, uint32_t b, uint32_t b_end, uint32_t *handshake)
+{
+    *handshake = 0;
+    while (1)
+    {
+        while ((a < a_end) && ((gs_entry[a].reg & 0x80) == 0))
+        {
+            a++;
+        }
+        while ((b < b_end) && ((gs_entry[b].reg & 0x80) == 0))
+        {
+            if (gs_entry[b].reg == 0x47)
+            {
+                (*handshake)++;
+            }
+            b++;
+        }
+        if ((a == a_end) || (b == b_end))
+        {
+            break;
+        }
+        if ((gs_entry[a].reg != gs_entry[b].reg) || (gs_entry[a].payload[0] != gs_entry[b].payload[0]))
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: resume write %d reg 0x%02X = 0x%02X differs from "
+                                      "write %d reg 0x%02X = 0x%02X.\n", b, gs_entry[b].reg & 0x7F,
+                                      gs_entry[b].payload[0], a, gs_entry[a].reg & 0x7F, gs_entry[a].payload[0]);
+            
+            return 1;
+        }
+        a++;
+        b++;
+    }
+    if ((a != a_end) || (b != b_end))
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: resume writes number differs.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief  resume test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   after a full init the chip is reset and resumed from the image, the resume must write the
+ *         registers in the order of set optimum performance with the 10 ms wait and poll the 0x47
+ *         handshake again, the register file must be the same as the one of the full init,
+ *         an image buffer that is too small must fail set optimum performance and leave no image
+ */
+uint8_t pmw3901mb_sim_test_resume(void)
+{
+    uint32_t a;
+    uint32_t a_end;
+    uint32_t b;
+    uint32_t handshake;
+    uint32_t diff;
+    uint64_t t;
+    uint8_t value;
+    uint8_t batch;
+    uint8_t fail;
+    uint16_t bank;
+    uint16_t reg;
+    
+    pmw3901mb_sim_debug_print("pmw3901mb: start resume test.\n");
+    for (fail = 0; fail < 4; fail += 2)
+    {
+        for (batch = 0; batch < 2; batch++)
+        {
+            /* full init */
+            (void)pmw3901mb_sim_get_default_config(&gs_config);
+            gs_config.batch = batch;
+            gs_config.handshake_fail = fail;
+            (void)pmw3901mb_sim_init(&gs_config);
+            (void)pmw3901mb_sim_link(&gs_handle);
+            (void)pmw3901mb_set_trace(&gs_handle, &gs_trace, gs_entry, SIM_TEST_TRACE_SIZE);
+            (void)pmw3901mb_set_resume_buffer(&gs_handle, gs_image, PMW3901MB_IMAGE_MAX);
+            if ((pmw3901mb_init(&gs_handle) != 0) || (pmw3901mb_power_up(&gs_handle) != 0))
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: init failed.\n");
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+            a = gs_trace.count;
+            if (pmw3901mb_set_optimum_performance(&gs_handle) != 0)
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: set optimum performance failed.\n");
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+            a_end = gs_trace.count;
+            for (bank = 0; bank < SIM_TEST_BANK_NUM; bank++)
+            {
+                for (reg = 0; reg < 0x80; reg++)
+                {
+                    (void)pmw3901mb_sim_get_reg((uint8_t)bank, (uint8_t)reg, &gs_reg[bank][reg]);
+                }
+            }
+            
+            /* reset the chip, the optimum registers are lost */
+            if (pmw3901mb_power_up(&gs_handle) != 0)
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: power up failed.\n");
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+            diff = 0;
+            for (bank = 0; bank < SIM_TEST_BANK_NUM; bank++)
+            {
+                for (reg = 0; reg < 0x80; reg++)
+                {
+                    (void)pmw3901mb_sim_get_reg((uint8_t)bank, (uint8_t)reg, &value);
+                    diff += (value != gs_reg[bank][reg]) ? 1 : 0;
+                }
+            }
+            if (diff == 0)
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: reset keeps the optimum registers.\n");
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+            
+            /* resume, power up is 1 write and 5 motion reads */
+            b = gs_trace.count;
+            t = pmw3901mb_sim_get_timestamp_us();
+            if (pmw3901mb_resume(&gs_handle) != 0)
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: resume failed.\n");
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+            t = pmw3901mb_sim_get_timestamp_us() - t;
+            if ((gs_trace.count > SIM_TEST_TRACE_SIZE) ||
+                (a_sim_test_compare_writes(a, a_end, b + 6, gs_trace.count, &handshake) != 0))
+            {
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+            if (handshake != (uint32_t)fail + 1)
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: resume reads the handshake %d times, expect %d.\n",
+                                          handshake, fail + 1);
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+            if (t < 10000)
+            {
+                pmw3901mb_sim_debug_print("pmw3901mb: resume takes %d us without the 10 ms wait.\n", (uint32_t)t);
+                (void)pmw3901mb_deinit(&gs_handle);
+                
+                return 1;
+            }
+            for (bank = 0; bank < SIM_TEST_BANK_NUM; bank++)
+            {
+                for (reg = 0; reg < 0x80; reg++)
+                {
+                    (void)pmw3901mb_sim_get_reg((uint8_t)bank, (uint8_t)reg, &value);
+                    if (value != gs_reg[bank][reg])
+                    {
+                        pmw3901mb_sim_debug_print("pmw3901mb: bank 0x%02X reg 0x%02X is 0x%02X, expect 0x%02X.\n",
+                                                  bank, reg, value, gs_reg[bank][reg]);
+                        (void)pmw3901mb_deinit(&gs_handle);
+                        
+                        return 1;
+                    }
+                }
+            }
+            pmw3901mb_sim_debug_print("pmw3901mb: batch %d handshake fail %d resume matches the full init, "
+                                      "%d image records, %d transfers.\n", batch, fail,
+                                      gs_handle.image_num, gs_trace.count - b);
+            (void)pmw3901mb_deinit(&gs_handle);
+        }
+    }
+    
+    /* the image doesn't fit */
+    (void)pmw3901mb_sim_get_default_config(&gs_config);
+    if (pmw3901mb_sim_init(&gs_config) != 0)
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: sim init failed.\n");
+        
+        return 1;
+    }
+    (void)pmw3901mb_sim_link(&gs_handle);
+    (void)pmw3901mb_set_resume_buffer(&gs_handle, gs_image, 8);
+    if ((pmw3901mb_init(&gs_handle) != 0) || (pmw3901mb_power_up(&gs_handle) != 0) ||
+        (pmw3901mb_set_optimum_performance(&gs_handle) != 4) || (pmw3901mb_resume(&gs_handle) != 4))
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: full image is not rejected.\n");
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    (void)pmw3901mb_deinit(&gs_handle);
+    pmw3901mb_sim_debug_print("pmw3901mb: finish resume test.\n");
+    
+    return 0;
+}
+
+/**
+ * @brief  trace test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   a 3 entries ring records 4 register reads while the transfer count wraps at 2^32,
+ *         the dump must hold the last 3 reads from the oldest to the newest
+ */
+uint8_t pmw3901mb_sim_test_trace(void)
+{
+    static const uint8_t reg[4] = {0x00, 0x01, 0x5F, 0x00};
+    uint8_t buf[PMW3901MB_TRACE_DUMP_HEADER_SIZE + SIM_TEST_TRACE_WRAP_SIZE * (PMW3901MB_TRACE_DUMP_RECORD_SIZE + 1)];
+    uint8_t id;
+    uint8_t *p;
+    uint32_t len;
+    uint32_t num;
+    uint32_t dropped;
+    uint32_t i;
+    
+    pmw3901mb_sim_debug_print("pmw3901mb: start trace test.\n");
+    (void)pmw3901mb_sim_get_default_config(&gs_config);
+    if (a_sim_test_start(0) != 0)
+    {
+        return 1;
+    }
+    (void)pmw3901mb_set_trace(&gs_handle, &gs_trace, gs_entry, SIM_TEST_TRACE_WRAP_SIZE);
+    gs_trace.count = SIM_TEST_TRACE_WRAP_COUNT;
+    if ((pmw3901mb_get_product_id(&gs_handle, &id) != 0) ||
+        (pmw3901mb_get_revision_id(&gs_handle, &id) != 0) ||
+        (pmw3901mb_get_inverse_product_id(&gs_handle, &id) != 0) ||
+        (pmw3901mb_get_product_id(&gs_handle, &id) != 0))
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: read id failed.\n");
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    if (pmw3901mb_trace_dump(&gs_handle, buf, sizeof(buf), &len) != 0)
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: trace dump failed.\n");
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    num = (uint32_t)buf[8] | ((uint32_t)buf[9] << 8) | ((uint32_t)buf[10] << 16) | ((uint32_t)buf[11] << 24);
+    dropped = (uint32_t)buf[12] | ((uint32_t)buf[13] << 8) | ((uint32_t)buf[14] << 16) | ((uint32_t)buf[15] << 24);
+    if ((num != SIM_TEST_TRACE_WRAP_SIZE) || (dropped != (uint32_t)(SIM_TEST_TRACE_WRAP_COUNT + 4 - SIM_TEST_TRACE_WRAP_SIZE)))
+    {
+        pmw3901mb_sim_debug_print("pmw3901mb: trace dump has %u records and %u dropped, expect %u and %u.\n",
+                                  num, dropped, SIM_TEST_TRACE_WRAP_SIZE,
+                                  (uint32_t)(SIM_TEST_TRACE_WRAP_COUNT + 4 - SIM_TEST_TRACE_WRAP_SIZE));
+        (void)pmw3901mb_deinit(&gs_handle);
+        
+        return 1;
+    }
+    p = &buf[PMW3901MB_TRACE_DUMP_HEADER_SIZE];
+    for (i = 0; i < num; i++)
+    {
+        if ((p[4] != reg[i + 1]) || (p[6] != 1))
+        {
+            pmw3901mb_sim_debug_print("pmw3901mb: trace record %u is reg 0x%02X, expect 0x%02X.\n",
+                                      i, p[4], reg[i + 1]);
+            (void)pmw3901mb_deinit(&gs_handle);
+            
+            return 1;
+        }
+        p += PMW3901MB_TRACE_DUMP_RECORD_SIZE + 1;
+    }
+    (void)pmw3901mb_set_trace(&gs_handle, NULL, NULL, 0);
+    (void)pmw3901mb_deinit(&gs_handle);
+    pmw3901mb_sim_debug_print("pmw3901mb: finish trace test.\n");
+    
+    return 0;
+}
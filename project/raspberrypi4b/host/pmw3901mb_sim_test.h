@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_sim_test.h
+ * @brief     pmw3901mb simulator test header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef PMW3901MB_SIM_TEST_H
+#define PMW3901MB_SIM_TEST_H
+
+#include "pmw3901mb_sim.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup pmw3901mb_sim_test pmw3901mb simulator test function
+ * @brief    pmw3901mb simulator test modules
+ * @ingroup  pmw3901mb_sim
+ * @{
+ */
+
+/**
+ * @brief  non-blocking frame read test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the surface is kept still and the frame of frame_begin and frame_step
+ *         must be the same as the frame of get_frame, with and without the batch hook
+ */
+uint8_t pmw3901mb_sim_test_frame_step(void);
+
+/**
+ * @brief  non-blocking boot test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the spi trace of boot_begin and boot_step must be the same as the one of init, power up and
+ *         set optimum performance, also when the 0x47 handshake needs retries, the gaps between the
+ *         transfers must be the same after the power up reset, power up pulses the reset once more
+ */
+uint8_t pmw3901mb_sim_test_boot(void);
+
+/**
+ * @brief  odometry test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the surface runs a two segment trajectory, the height changes at the segment end,
+ *         the position and the displacement since the checkpoint must match the read deltas
+ *         and the trajectory, the q16 conversion must match the float one and saturate
+ */
+uint8_t pmw3901mb_sim_test_odometry(void);
+
+/**
+ * @brief  shadow test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the bus transactions of init and a frame capture start and stop are counted
+ *         without and with the shadow, the shadow buffer must keep the optimum registers
+ */
+uint8_t pmw3901mb_sim_test_shadow(void);
+
+/**
+ * @brief  resume test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   the resume after a chip reset must write the registers in the order of the full init,
+ *         poll the handshake again and leave the same register file, a full image must fail
+ */
+uint8_t pmw3901mb_sim_test_resume(void);
+
+/**
+ * @brief  trace test
+ * @return status code
+ *         - 0 success
+ *         - 1 test failed
+ * @note   a trace ring with a size that is not a power of 2 must keep the newest transfers
+ *         in order while the transfer count wraps at 2^32
+ */
+uint8_t pmw3901mb_sim_test_trace(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,417 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_soa.c
+ * @brief     pmw3901mb structure of arrays sample buffer source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "pmw3901mb_soa.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(PMW3901MB_SOA_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SOA_SSSE3
+#include <tmmintrin.h>
+#elif !defined(PMW3901MB_SOA_NO_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+#define SOA_NEON
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief soa variables definition
+ */
+static uint8_t gs_simd = 1;        /**< simd enable */
+
+/**
+ * @brief     round a column size up to 16 bytes
+ * @param[in] len column size
+ * @return    rounded size
+ * @note      none
+ */
+static size_t a_soa_round(size_t len)
+{
+    return (len + 15) & ~(size_t)15;
+}
+
+/**
+ * @brief     decode one raw burst
+ * @param[in] *soa pointer to a soa structure
+ * @param[in] j column index
+ * @param[in] *r pointer to a raw burst
+ * @note      the columns are written for every sample, valid tells which ones count
+ */
+static void a_soa_decode_one(pmw3901mb_soa_t *soa, uint32_t j, const uint8_t *r)
+{
+    soa->delta_x[j] = (int16_t)(((uint16_t)r[3] << 8) | r[2]);
+    soa->delta_y[j] = (int16_t)(((uint16_t)r[5] << 8) | r[4]);
+    soa->shutter[j] = (uint16_t)((((uint16_t)r[10] & 0x1F) << 8) | r[11]);
+    soa->squal[j] = r[6];
+    if ((r[0] & (1 << 7)) == 0)
+    {
+        soa->valid[j] = 0;
+    }
+    else if ((r[6] < 0x19) || (r[10] == 0x1F))
+    {
+        soa->valid[j] = 2;
+    }
+    else
+    {
+        soa->valid[j] = 1;
+    }
+}
+
+#if defined(SOA_SSSE3)
+/**
+ * @brief     decode eight raw bursts with ssse3
+ * @param[in] *soa pointer to a soa structure
+ * @param[in] j column index
+ * @param[in] *r pointer to the raw bursts
+ * @note      each burst is loaded with 16 bytes, so 4 bytes after the eighth burst must be readable,
+ *            every burst is shuffled to dx, dy, shutter, squal | motion << 8 words and two bursts share
+ *            one register, then the words are transposed into the columns
+ */
+__attribute__((target("ssse3")))
+static void a_soa_decode8_ssse3(pmw3901mb_soa_t *soa, uint32_t j, const uint8_t *r)
+{
+    const __m128i shuffle = _mm_setr_epi8(2, 3, 4, 5, 11, 10, 6, 0, -1, -1, -1, -1, -1, -1, -1, -1);
+    __m128i v0, v1, v2, v3;
+    __m128i t0, t1, t2, t3;
+    __m128i dx, dy, sh, sm;
+    __m128i motion, bad, valid, squal;
+    
+#define SOA_LOAD(k) _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(r + (k) * 12)), shuffle)
+    /* records 0 2, 1 3, 4 6 and 5 7 keep the transposed lanes in order */
+    v0 = _mm_unpacklo_epi64(SOA_LOAD(0), SOA_LOAD(2));
+    v1 = _mm_unpacklo_epi64(SOA_LOAD(1), SOA_LOAD(3));
+    v2 = _mm_unpacklo_epi64(SOA_LOAD(4), SOA_LOAD(6));
+    v3 = _mm_unpacklo_epi64(SOA_LOAD(5), SOA_LOAD(7));
+#undef SOA_LOAD
+    
+    /* transpose the words */
+    t0 = _mm_unpacklo_epi16(v0, v1);
+    t1 = _mm_unpackhi_epi16(v0, v1);
+    t2 = _mm_unpacklo_epi16(v2, v3);
+    t3 = _mm_unpackhi_epi16(v2, v3);
+    v0 = _mm_unpacklo_epi32(t0, t1);
+    v1 = _mm_unpackhi_epi32(t0, t1);
+    v2 = _mm_unpacklo_epi32(t2, t3);
+    v3 = _mm_unpackhi_epi32(t2, t3);
+    dx = _mm_unpacklo_epi64(v0, v2);
+    dy = _mm_unpackhi_epi64(v0, v2);
+    sh = _mm_unpacklo_epi64(v1, v3);
+    sm = _mm_unpackhi_epi64(v1, v3);
+    
+    /* motion flag, squal < 0x19 or shutter upper == 0x1F */
+    squal = _mm_and_si128(sm, _mm_set1_epi16(0x00FF));
+    motion = _mm_cmpeq_epi16(_mm_and_si128(sm, _mm_set1_epi16((short)0x8000)), _mm_set1_epi16((short)0x8000));
+    bad = _mm_or_si128(_mm_cmplt_epi16(squal, _mm_set1_epi16(0x19)),
+                       _mm_cmpeq_epi16(_mm_and_si128(sh, _mm_set1_epi16((short)0xFF00)), _mm_set1_epi16(0x1F00)));
+    valid = _mm_and_si128(motion, _mm_sub_epi16(_mm_set1_epi16(1), bad));
+    
+    _mm_storeu_si128((__m128i *)(soa->delta_x + j), dx);
+    _mm_storeu_si128((__m128i *)(soa->delta_y + j), dy);
+    _mm_storeu_si128((__m128i *)(soa->shutter + j), _mm_and_si128(sh, _mm_set1_epi16(0x1FFF)));
+    _mm_storel_epi64((__m128i *)(soa->squal + j), _mm_packus_epi16(squal, squal));
+    _mm_storel_epi64((__m128i *)(soa->valid + j), _mm_packus_epi16(valid, valid));
+}
+
+/**
+ * @brief  check the ssse3 support
+ * @return bool value
+ * @note   none
+ */
+static uint8_t a_soa_simd_supported(void)
+{
+    return (uint8_t)(__builtin_cpu_supports("ssse3") != 0);
+}
+#elif defined(SOA_NEON)
+/**
+ * @brief     decode eight raw bursts with neon
+ * @param[in] *soa pointer to a soa structure
+ * @param[in] j column index
+ * @param[in] *r pointer to the raw bursts
+ * @note      four bursts are one 48 bytes table, the lookups put dx, dy, shutter and squal | motion << 8
+ *            words of the four bursts side by side
+ */
+static void a_soa_decode8_neon(pmw3901mb_soa_t *soa, uint32_t j, const uint8_t *r)
+{
+    static const uint8_t idx_a[16] = {2, 3, 14, 15, 26, 27, 38, 39, 4, 5, 16, 17, 28, 29, 40, 41};
+    static const uint8_t idx_b[16] = {11, 10, 23, 22, 35, 34, 47, 46, 6, 0, 18, 12, 30, 24, 42, 36};
+    uint8x16x3_t t;
+    uint16x8_t a0, b0, a1, b1;
+    uint16x8_t dx, dy, sh, sm;
+    uint16x8_t squal, motion, bad, valid;
+    
+    t.val[0] = vld1q_u8(r);
+    t.val[1] = vld1q_u8(r + 16);
+    t.val[2] = vld1q_u8(r + 32);
+    a0 = vreinterpretq_u16_u8(vqtbl3q_u8(t, vld1q_u8(idx_a)));
+    b0 = vreinterpretq_u16_u8(vqtbl3q_u8(t, vld1q_u8(idx_b)));
+    t.val[0] = vld1q_u8(r + 48);
+    t.val[1] = vld1q_u8(r + 64);
+    t.val[2] = vld1q_u8(r + 80);
+    a1 = vreinterpretq_u16_u8(vqtbl3q_u8(t, vld1q_u8(idx_a)));
+    b1 = vreinterpretq_u16_u8(vqtbl3q_u8(t, vld1q_u8(idx_b)));
+    dx = vcombine_u16(vget_low_u16(a0), vget_low_u16(a1));
+    dy = vcombine_u16(vget_high_u16(a0), vget_high_u16(a1));
+    sh = vcombine_u16(vget_low_u16(b0), vget_low_u16(b1));
+    sm = vcombine_u16(vget_high_u16(b0), vget_high_u16(b1));
+    
+    /* motion flag, squal < 0x19 or shutter upper == 0x1F */
+    squal = vandq_u16(sm, vdupq_n_u16(0x00FF));
+    motion = vtstq_u16(sm, vdupq_n_u16(0x8000));
+    bad = vorrq_u16(vcltq_u16(squal, vdupq_n_u16(0x19)),
+                    vceqq_u16(vandq_u16(sh, vdupq_n_u16(0xFF00)), vdupq_n_u16(0x1F00)));
+    valid = vandq_u16(motion, vbslq_u16(bad, vdupq_n_u16(2), vdupq_n_u16(1)));
+    
+    vst1q_s16(soa->delta_x + j, vreinterpretq_s16_u16(dx));
+    vst1q_s16(soa->delta_y + j, vreinterpretq_s16_u16(dy));
+    vst1q_u16(soa->shutter + j, vandq_u16(sh, vdupq_n_u16(0x1FFF)));
+    vst1_u8(soa->squal + j, vmovn_u16(squal));
+    vst1_u8(soa->valid + j, vmovn_u16(valid));
+}
+
+/**
+ * @brief  check the neon support
+ * @return bool value
+ * @note   neon is always there on aarch64
+ */
+static uint8_t a_soa_simd_supported(void)
+{
+    return 1;
+}
+#endif
+
+/**
+ * @brief     init a soa buffer
+ * @param[in] *soa pointer to a soa structure
+ * @param[in] size column capacity
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      all the columns are allocated in one 16 bytes aligned block
+ */
+uint8_t pmw3901mb_soa_init(pmw3901mb_soa_t *soa, uint32_t size)
+{
+    uint8_t *block;
+    size_t ts_len;
+    size_t d_len;
+    size_t b_len;
+    
+    if ((soa == NULL) || (size == 0))
+    {
+        return 1;
+    }
+    
+    /* one block for all the columns */
+    ts_len = a_soa_round((size_t)size * sizeof(uint64_t));
+    d_len = a_soa_round((size_t)size * sizeof(int16_t));
+    b_len = a_soa_round((size_t)size);
+    block = (uint8_t *)malloc(ts_len + d_len * 3 + b_len * 2);
+    if (block == NULL)
+    {
+        return 1;
+    }
+    soa->timestamp_us = (uint64_t *)block;
+    soa->delta_x = (int16_t *)(block + ts_len);
+    soa->delta_y = (int16_t *)(block + ts_len + d_len);
+    soa->shutter = (uint16_t *)(block + ts_len + d_len * 2);
+    soa->squal = block + ts_len + d_len * 3;
+    soa->valid = block + ts_len + d_len * 3 + b_len;
+    soa->size = size;
+    soa->count = 0;
+    
+    return 0;
+}
+
+/**
+ * @brief     free a soa buffer
+ * @param[in] *soa pointer to a soa structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t pmw3901mb_soa_free(pmw3901mb_soa_t *soa)
+{
+    if (soa == NULL)
+    {
+        return 0;
+    }
+    free(soa->timestamp_us);
+    memset(soa, 0, sizeof(pmw3901mb_soa_t));
+    
+    return 0;
+}
+
+/**
+ * @brief     clear the decoded samples
+ * @param[in] *soa pointer to a soa structure
+ * @return    status code
+ *            - 0 success
+ * @note      the columns are kept
+ */
+uint8_t pmw3901mb_soa_clear(pmw3901mb_soa_t *soa)
+{
+    if (soa != NULL)
+    {
+        soa->count = 0;
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     decode raw bursts into the soa columns
+ * @param[in] *soa pointer to a soa structure
+ * @param[in] *raw pointer to n contiguous 12 bytes raw bursts
+ * @param[in] *timestamp_us pointer to n timestamps, NULL means 0
+ * @param[in] n burst number
+ * @return    appended samples
+ * @note      the samples are appended until the columns are full,
+ *            the decode uses ssse3 on x86 and neon on aarch64 when it is enabled and supported
+ */
+uint32_t pmw3901mb_soa_decode(pmw3901mb_soa_t *soa, const uint8_t *raw, const uint64_t *timestamp_us, uint32_t n)
+{
+    uint32_t i;
+    uint32_t j;
+    
+    if ((soa == NULL) || (raw == NULL))
+    {
+        return 0;
+    }
+    
+    /* clip to the free columns */
+    n = (n > soa->size - soa->count) ? (soa->size - soa->count) : n;
+    j = soa->count;
+    if (timestamp_us != NULL)
+    {
+        memcpy(soa->timestamp_us + j, timestamp_us, (size_t)n * sizeof(uint64_t));
+    }
+    else
+    {
+        memset(soa->timestamp_us + j, 0, (size_t)n * sizeof(uint64_t));
+    }
+    
+    /* eight bursts each step */
+    i = 0;
+#if defined(SOA_SSSE3)
+    if ((gs_simd != 0) && (a_soa_simd_supported() != 0))
+    {
+        for (; n - i > 8; i += 8)
+        {
+            a_soa_decode8_ssse3(soa, j + i, raw + (size_t)i * PMW3901MB_SOA_RAW_SIZE);
+        }
+    }
+#elif defined(SOA_NEON)
+    if (gs_simd != 0)
+    {
+        for (; n - i >= 8; i += 8)
+        {
+            a_soa_decode8_neon(soa, j + i, raw + (size_t)i * PMW3901MB_SOA_RAW_SIZE);
+        }
+    }
+#endif
+    
+    /* the tail */
+    for (; i < n; i++)
+    {
+        a_soa_decode_one(soa, j + i, raw + (size_t)i * PMW3901MB_SOA_RAW_SIZE);
+    }
+    soa->count += n;
+    
+    return n;
+}
+
+/**
+ * @brief     append motion samples into the soa columns
+ * @param[in] *soa pointer to a soa structure
+ * @param[in] *motion pointer to a motion array
+ * @param[in] n sample number
+ * @return    appended samples
+ * @note      the raw bursts and the timestamps of the motion array are decoded
+ */
+uint32_t pmw3901mb_soa_append(pmw3901mb_soa_t *soa, const pmw3901mb_motion_t *motion, uint32_t n)
+{
+    uint32_t i;
+    uint32_t j;
+    
+    if ((soa == NULL) || (motion == NULL))
+    {
+        return 0;
+    }
+    
+    /* the motion structures are not contiguous bursts */
+    n = (n > soa->size - soa->count) ? (soa->size - soa->count) : n;
+    j = soa->count;
+    for (i = 0; i < n; i++)
+    {
+        soa->timestamp_us[j + i] = motion[i].timestamp_us;
+        a_soa_decode_one(soa, j + i, motion[i].raw);
+    }
+    soa->count += n;
+    
+    return n;
+}
+
+/**
+ * @brief     enable or disable the simd decode
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ * @note      the simd decode is enabled by default, the scalar decode gives the same columns
+ */
+uint8_t pmw3901mb_soa_set_simd(uint8_t enable)
+{
+    gs_simd = (uint8_t)(enable != 0);
+    
+    return 0;
+}
+
+/**
+ * @brief  get the decode path name
+ * @return decode path name, "ssse3", "neon" or "scalar"
+ * @note   none
+ */
+const char *pmw3901mb_soa_get_simd(void)
+{
+    if (gs_simd == 0)
+    {
+        return "scalar";
+    }
+#if defined(SOA_SSSE3)
+    return (a_soa_simd_supported() != 0) ? "ssse3" : "scalar";
+#elif defined(SOA_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
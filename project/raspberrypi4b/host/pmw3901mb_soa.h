@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_soa.h
+ * @brief     pmw3901mb structure of arrays sample buffer header file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#ifndef PMW3901MB_SOA_H
+#define PMW3901MB_SOA_H
+
+#include "driver_pmw3901mb.h"
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/**
+ * @defgroup pmw3901mb_soa pmw3901mb soa function
+ * @brief    pmw3901mb structure of arrays function modules
+ * @ingroup  pmw3901mb_driver
+ * @{
+ */
+
+/**
+ * @brief pmw3901mb soa raw burst size definition
+ */
+#define PMW3901MB_SOA_RAW_SIZE    12        /**< raw burst bytes of one sample */
+
+/**
+ * @brief pmw3901mb soa structure definition
+ */
+typedef struct pmw3901mb_soa_s
+{
+    uint64_t *timestamp_us;        /**< timestamp column */
+    int16_t *delta_x;              /**< delta_x column */
+    int16_t *delta_y;              /**< delta_y column */
+    uint16_t *shutter;             /**< 13 bits shutter column */
+    uint8_t *squal;                /**< raw squal column, the surface quality is squal * 4 */
+    uint8_t *valid;                /**< valid column, same as is_valid of pmw3901mb_motion_t */
+    uint32_t size;                 /**< column capacity */
+    uint32_t count;                /**< decoded samples */
+} pmw3901mb_soa_t;
+
+/**
+ * @brief     init a soa buffer
+ * @param[in] *soa pointer to a soa structure
+ * @param[in] size column capacity
+ * @return    status code
+ *            - 0 success
+ *            - 1 init failed
+ * @note      all the columns are allocated in one 16 bytes aligned block
+ */
+uint8_t pmw3901mb_soa_init(pmw3901mb_soa_t *soa, uint32_t size);
+
+/**
+ * @brief     free a soa buffer
+ * @param[in] *soa pointer to a soa structure
+ * @return    status code
+ *            - 0 success
+ * @note      none
+ */
+uint8_t pmw3901mb_soa_free(pmw3901mb_soa_t *soa);
+
+/**
+ * @brief     clear the decoded samples
+ * @param[in] *soa pointer to a soa structure
+ * @return    status code
+ *            - 0 success
+ * @note      the columns are kept
+ */
+uint8_t pmw3901mb_soa_clear(pmw3901mb_soa_t *soa);
+
+/**
+ * @brief     decode raw bursts into the soa columns
+ * @param[in] *soa pointer to a soa structure
+ * @param[in] *raw pointer to n contiguous 12 bytes raw bursts
+ * @param[in] *timestamp_us pointer to n timestamps, NULL means 0
+ * @param[in] n burst number
+ * @return    appended samples
+ * @note      the samples are appended until the columns are full,
+ *            the decode uses ssse3 on x86 and neon on aarch64 when it is enabled and supported
+ */
+uint32_t pmw3901mb_soa_decode(pmw3901mb_soa_t *soa, const uint8_t *raw, const uint64_t *timestamp_us, uint32_t n);
+
+/**
+ * @brief     append motion samples into the soa columns
+ * @param[in] *soa pointer to a soa structure
+ * @param[in] *motion pointer to a motion array
+ * @param[in] n sample number
+ * @return    appended samples
+ * @note      the raw bursts and the timestamps of the motion array are decoded
+ */
+uint32_t pmw3901mb_soa_append(pmw3901mb_soa_t *soa, const pmw3901mb_motion_t *motion, uint32_t n);
+
+/**
+ * @brief     enable or disable the simd decode
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ * @note      the simd decode is enabled by default, the scalar decode gives the same columns
+ */
+uint8_t pmw3901mb_soa_set_simd(uint8_t enable);
+
+/**
+ * @brief  get the decode path name
+ * @return decode path name, "ssse3", "neon" or "scalar"
+ * @note   none
+ */
+const char *pmw3901mb_soa_get_simd(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,232 @@
+/**
+ * Copyright (c) 2015 - present LibDriver All rights reserved
+ * 
+ * The MIT License (MIT)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE. 
+ *
+ * @file      pmw3901mb_trace.c
+ * @brief     pmw3901mb spi trace decoder source file
+ * @version   1.0.0
+ * @author    Shifeng Li
+ * @date      2022-01-08
+ *
+ * <h3>history</h3>
+ * <table>
+ * <tr><th>Date        <th>Version  <th>Author      <th>Description
+ * <tr><td>2022/01/08  <td>1.0      <td>Shifeng Li  <td>first upload
+ * </table>
+ */
+
+#include "driver_pmw3901mb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief     read a little endian uint32
+ * @param[in] *p pointer to a data buffer
+ * @return    read value
+ * @note      none
+ */
+static uint32_t a_read_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief     decode a trace dump
+ * @param[in] *buf pointer to a dump buffer
+ * @param[in] len dump length
+ * @param[in] csv bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 decode failed
+ * @note      the records keep the low 32 bits of the timestamp, it is unwrapped
+ *            from the first record while the records are less than 71.6 min apart
+ */
+static int a_decode(const uint8_t *buf, size_t len, int csv)
+{
+    uint32_t num;
+    uint32_t dropped;
+    uint32_t i;
+    uint32_t timestamp;
+    uint32_t last;
+    uint64_t time;
+    uint32_t read_bytes;
+    uint32_t write_bytes;
+    uint32_t errors;
+    uint16_t data_len;
+    uint16_t payload;
+    uint16_t j;
+    uint8_t payload_max;
+    size_t offset;
+    
+    if (len < PMW3901MB_TRACE_DUMP_HEADER_SIZE)                                            /* check length */
+    {
+        fprintf(stderr, "pmw3901mb_trace: dump is too short.\n");
+        
+        return 1;
+    }
+    if ((a_read_u32(buf) != PMW3901MB_TRACE_DUMP_MAGIC) || (buf[4] != PMW3901MB_TRACE_DUMP_VERSION))
+    {
+        fprintf(stderr, "pmw3901mb_trace: unknown dump format.\n");
+        
+        return 1;
+    }
+    payload_max = buf[5];                                                                  /* get payload max */
+    num = a_read_u32(buf + 8);                                                             /* get num */
+    dropped = a_read_u32(buf + 12);                                                        /* get dropped */
+    offset = PMW3901MB_TRACE_DUMP_HEADER_SIZE;                                             /* skip the header */
+    
+    if (csv != 0)
+    {
+        printf("index,timestamp_us,delta_us,dir,reg,len,result,payload\n");
+    }
+    else
+    {
+        printf("%u transfers, %u dropped, payload max %u bytes.\n", num, dropped, payload_max);
+    }
+    last = 0;
+    time = 0;
+    read_bytes = 0;
+    write_bytes = 0;
+    errors = 0;
+    for (i = 0; i < num; i++)                                                              /* decode all */
+    {
+        if (offset + PMW3901MB_TRACE_DUMP_RECORD_SIZE > len)                               /* check length */
+        {
+            fprintf(stderr, "pmw3901mb_trace: record %u is truncated.\n", i);
+            
+            return 1;
+        }
+        timestamp = a_read_u32(buf + offset);                                              /* get timestamp */
+        time = (i != 0) ? (time + (uint32_t)(timestamp - last)) : timestamp;               /* unwrap the timestamp */
+        data_len = (uint16_t)(buf[offset + 6] | (buf[offset + 7] << 8));                   /* get length */
+        payload = (data_len < payload_max) ? data_len : payload_max;                       /* get payload length */
+        if (offset + PMW3901MB_TRACE_DUMP_RECORD_SIZE + payload > len)                     /* check length */
+        {
+            fprintf(stderr, "pmw3901mb_trace: record %u is truncated.\n", i);
+            
+            return 1;
+        }
+        if ((buf[offset + 4] & 0x80) != 0)                                                 /* write */
+        {
+            write_bytes += data_len;
+        }
+        else
+        {
+            read_bytes += data_len;
+        }
+        if (buf[offset + 5] != 0)                                                          /* failed transfer */
+        {
+            errors++;
+        }
+        if (csv != 0)
+        {
+            printf("%u,%llu,%u,%c,0x%02X,%u,%u,", dropped + i, (unsigned long long)time, (i != 0) ? (timestamp - last) : 0,
+                   ((buf[offset + 4] & 0x80) != 0) ? 'W' : 'R', buf[offset + 4] & 0x7F, data_len, buf[offset + 5]);
+        }
+        else
+        {
+            printf("%8u %10llu +%-8u %c 0x%02X len %-4u %s ", dropped + i, (unsigned long long)time, (i != 0) ? (timestamp - last) : 0,
+                   ((buf[offset + 4] & 0x80) != 0) ? 'W' : 'R', buf[offset + 4] & 0x7F, data_len,
+                   (buf[offset + 5] != 0) ? "fail" : "ok  ");
+        }
+        for (j = 0; j < payload; j++)                                                      /* print the payload */
+        {
+            printf("%02X", buf[offset + PMW3901MB_TRACE_DUMP_RECORD_SIZE + j]);
+        }
+        printf("%s\n", (payload < data_len) ? "..." : "");
+        last = timestamp;
+        offset += PMW3901MB_TRACE_DUMP_RECORD_SIZE + payload;                              /* next record */
+    }
+    if (csv == 0)
+    {
+        printf("read %u bytes, wrote %u bytes, %u failed transfers.\n", read_bytes, write_bytes, errors);
+    }
+    
+    return 0;
+}
+
+/**
+ * @brief     main function
+ * @param[in] argc arg numbers
+ * @param[in] **argv arg address
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      none
+ */
+int main(int argc, char **argv)
+{
+    FILE *fp;
+    uint8_t *buf;
+    uint8_t *tmp;
+    size_t len;
+    size_t cap;
+    size_t n;
+    int csv;
+    int res;
+    
+    if ((argc < 2) || (argc > 3) || ((argc == 3) && (strcmp(argv[2], "--csv") != 0)))
+    {
+        fprintf(stderr, "usage: pmw3901mb_trace <dump file> [--csv]\n");
+        
+        return 1;
+    }
+    csv = (argc == 3);
+    fp = fopen(argv[1], "rb");
+    if (fp == NULL)
+    {
+        fprintf(stderr, "pmw3901mb_trace: can't open %s.\n", argv[1]);
+        
+        return 1;
+    }
+    len = 0;
+    cap = 4096;
+    buf = (uint8_t *)malloc(cap);
+    while (buf != NULL)                                                                    /* read the whole file */
+    {
+        n = fread(buf + len, 1, cap - len, fp);
+        len += n;
+        if (len < cap)
+        {
+            break;
+        }
+        cap *= 2;
+        tmp = (uint8_t *)realloc(buf, cap);
+        if (tmp == NULL)
+        {
+            free(buf);
+        }
+        buf = tmp;
+    }
+    fclose(fp);
+    if (buf == NULL)
+    {
+        fprintf(stderr, "pmw3901mb_trace: out of memory.\n");
+        
+        return 1;
+    }
+    res = a_decode(buf, len, csv);
+    free(buf);
+    
+    return res;
+}
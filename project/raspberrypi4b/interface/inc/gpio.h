@@ -69,6 +69,16 @@ uint8_t gpio_interrupt_init(void);
  */
 uint8_t gpio_interrupt_deinit(void);
 
+/**
+ * @brief      gpio interrupt get the edge timestamp
+ * @param[out] *us pointer to a timestamp buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 no edge is being serviced
+ * @note       the timestamp is CLOCK_MONOTONIC and only valid inside the irq callback
+ */
+uint8_t gpio_interrupt_get_timestamp(uint64_t *us);
+
 /**
  * @}
  */
@@ -54,6 +54,8 @@
 static struct gpiod_chip *gs_chip;           /**< gpio chip handle */
 static struct gpiod_line *gs_line;           /**< gpio line handle */
 static pthread_t gs_pid;                     /**< gpio pthread pid */
+static volatile uint64_t gs_edge_us;         /**< serviced edge timestamp */
+static volatile uint8_t gs_edge_valid;       /**< serviced edge timestamp valid flag */
 extern uint8_t (*g_gpio_irq)(float m);       /**< gpio irq */
 
 /**
@@ -92,8 +94,15 @@ static void *a_gpio_interrupt_pthread(void *p)
                 /* check the g_gpio_irq */
                 if (g_gpio_irq != NULL)
                 {
+                    /* save the edge timestamp */
+                    gs_edge_us = (uint64_t)event.ts.tv_sec * 1000000 + (uint64_t)event.ts.tv_nsec / 1000;
+                    gs_edge_valid = 1;
+
                     /* run the callback */
                     g_gpio_irq(1.0f);
+
+                    /* clear the edge timestamp */
+                    gs_edge_valid = 0;
                 }
             }
         }
@@ -177,3 +186,25 @@ uint8_t gpio_interrupt_deinit(void)
     
     return 0;
 }
+
+/**
+ * @brief      gpio interrupt get the edge timestamp
+ * @param[out] *us pointer to a timestamp buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 no edge is being serviced
+ * @note       the timestamp is CLOCK_MONOTONIC and only valid inside the irq callback
+ */
+uint8_t gpio_interrupt_get_timestamp(uint64_t *us)
+{
+    /* check the caller and the edge */
+    if ((gs_edge_valid == 0) || (pthread_equal(pthread_self(), gs_pid) == 0))
+    {
+        return 1;
+    }
+
+    /* get the timestamp */
+    *us = gs_edge_us;
+
+    return 0;
+}
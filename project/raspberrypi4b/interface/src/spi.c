@@ -159,6 +159,39 @@ uint8_t spi_deinit(int fd)
     }
 }
 
+/**
+ * @brief     spi bus set frequence
+ * @param[in] fd spi handle
+ * @param[in] freq spi running frequence
+ * @return    status code
+ *            - 0 success
+ *            - 1 set frequence failed
+ * @note      none
+ */
+uint8_t spi_set_freq(int fd, uint32_t freq)
+{
+    int i;
+    
+    /* set the spi write frequence */
+    i = freq;
+    if (ioctl(fd, SPI_IOC_WR_MAX_SPEED_HZ, &i) < 0)
+    {
+        perror("spi: set spi write speed failed.\n");
+        
+        return 1;
+    }
+    
+    /* set the spi read frequence */
+    if (ioctl(fd, SPI_IOC_RD_MAX_SPEED_HZ, &i) < 0)
+    {
+        perror("spi: set spi read speed failed.\n");
+        
+        return 1;
+    }
+    
+    return 0;
+}
+
 /**
  * @brief      spi bus read command
  * @param[in]  fd spi handle
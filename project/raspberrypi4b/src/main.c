@@ -41,12 +41,15 @@
 #include "driver_pmw3901mb_basic.h"
 #include "driver_pmw3901mb_frame.h"
 #include "driver_pmw3901mb_interrupt.h"
+#include "raspberrypi4b_driver_pmw3901mb_interface.h"
+#include "pmw3901mb_log.h"
 #include "gpio.h"
 #include <getopt.h>
 #include <stdlib.h>
 
 static volatile uint8_t gs_flag;           /**< interrupt flag */
 static uint8_t gs_frame[35][35];           /**< frame array */
+static pmw3901mb_motion_t gs_samples[64];  /**< log samples */
 uint8_t (*g_gpio_irq)(float m) = NULL;     /**< gpio irq function address */
 
 /**
@@ -76,6 +79,71 @@ static void a_callback(pmw3901mb_motion_t *motion, float delta_x, float delta_y)
     }
 }
 
+/**
+ * @brief  spi clock tuning
+ * @return status code
+ *         - 0 success
+ *         - 1 tune failed
+ * @note   the chip is initialized once for the tuning, the settled clock is kept for the next runs
+ */
+static uint8_t a_spi_tune(void)
+{
+    uint8_t res;
+    uint32_t hz;
+    pmw3901mb_handle_t handle;
+    
+    /* link interface function */
+    DRIVER_PMW3901MB_LINK_INIT(&handle, pmw3901mb_handle_t);
+    DRIVER_PMW3901MB_LINK_SPI_INIT(&handle, pmw3901mb_interface_spi_init);
+    DRIVER_PMW3901MB_LINK_SPI_DEINIT(&handle, pmw3901mb_interface_spi_deinit);
+    DRIVER_PMW3901MB_LINK_SPI_READ(&handle, pmw3901mb_interface_spi_read);
+    DRIVER_PMW3901MB_LINK_SPI_WRITE(&handle, pmw3901mb_interface_spi_write);
+    DRIVER_PMW3901MB_LINK_SPI_TRANSFER_BATCH(&handle, pmw3901mb_interface_spi_transfer_batch);
+    DRIVER_PMW3901MB_LINK_RESET_GPIO_INIT(&handle, pmw3901mb_interface_reset_gpio_init);
+    DRIVER_PMW3901MB_LINK_RESET_GPIO_DEINIT(&handle, pmw3901mb_interface_reset_gpio_deinit);
+    DRIVER_PMW3901MB_LINK_RESET_GPIO_WRITE(&handle, pmw3901mb_interface_reset_gpio_write);
+    DRIVER_PMW3901MB_LINK_DELAY_MS(&handle, pmw3901mb_interface_delay_ms);
+    DRIVER_PMW3901MB_LINK_DELAY_US(&handle, pmw3901mb_interface_delay_us);
+    DRIVER_PMW3901MB_LINK_GET_TIMESTAMP_US(&handle, pmw3901mb_interface_get_timestamp_us);
+    DRIVER_PMW3901MB_LINK_DEBUG_PRINT(&handle, pmw3901mb_interface_debug_print);
+    
+    /* pmw3901mb init */
+    res = pmw3901mb_init(&handle);
+    if (res != 0)
+    {
+        pmw3901mb_interface_debug_print("pmw3901mb: init failed.\n");
+        
+        return 1;
+    }
+    
+    /* power up */
+    res = pmw3901mb_power_up(&handle);
+    if (res != 0)
+    {
+        pmw3901mb_interface_debug_print("pmw3901mb: power up failed.\n");
+        (void)pmw3901mb_deinit(&handle);
+        
+        return 1;
+    }
+    
+    /* tune the clock */
+    res = pmw3901mb_interface_spi_tune(&handle, PMW3901MB_INTERFACE_SPI_TUNE_MIN_HZ, PMW3901MB_INTERFACE_SPI_TUNE_MAX_HZ,
+                                       PMW3901MB_INTERFACE_SPI_TUNE_STEP_HZ, PMW3901MB_INTERFACE_SPI_TUNE_MARGIN, &hz);
+    if (res != 0)
+    {
+        pmw3901mb_interface_debug_print("pmw3901mb: spi tune failed.\n");
+        (void)pmw3901mb_deinit(&handle);
+        
+        return 1;
+    }
+    pmw3901mb_interface_debug_print("pmw3901mb: spi clock is %dHz.\n", hz);
+    
+    /* deinit */
+    (void)pmw3901mb_deinit(&handle);
+    
+    return 0;
+}
+
 /**
  * @brief     pmw3901mb full function
  * @param[in] argc arg numbers
@@ -100,11 +168,20 @@ uint8_t pmw3901mb(uint8_t argc, char **argv)
         {"test", required_argument, NULL, 't'},
         {"height", required_argument, NULL, 1},
         {"times", required_argument, NULL, 2},
+        {"spi-hz", required_argument, NULL, 3},
+        {"spi-tune", no_argument, NULL, 4},
+        {"log", required_argument, NULL, 5},
+        {"period", required_argument, NULL, 6},
         {NULL, 0, NULL, 0},
     };
     char type[33] = "unknown";
     uint32_t times = 3;
     float height = 1.0f;
+    uint32_t spi_hz = 0;
+    uint8_t spi_tune = 0;
+    char log_path[256] = "pmw3901mb.log";
+    uint8_t log_set = 0;
+    uint32_t period_us = 0;
     
     /* if no params */
     if (argc == 1)
@@ -193,6 +270,44 @@ uint8_t pmw3901mb(uint8_t argc, char **argv)
                 break;
             } 
             
+            /* spi clock */
+            case 3 :
+            {
+                /* set the spi clock */
+                spi_hz = atol(optarg);
+                
+                break;
+            } 
+            
+            /* spi clock tuning */
+            case 4 :
+            {
+                /* set the spi tuning */
+                spi_tune = 1;
+                
+                break;
+            } 
+            
+            /* log file */
+            case 5 :
+            {
+                /* set the log file */
+                memset(log_path, 0, sizeof(char) * 256);
+                strncpy(log_path, optarg, 255);
+                log_set = 1;
+                
+                break;
+            } 
+            
+            /* sample period */
+            case 6 :
+            {
+                /* set the period */
+                period_us = atol(optarg);
+                
+                break;
+            } 
+            
             /* the end */
             case -1 :
             {
@@ -206,6 +321,24 @@ uint8_t pmw3901mb(uint8_t argc, char **argv)
             }
         }
     } while (c != -1);
+    
+    /* set the spi clock */
+    if (spi_hz != 0)
+    {
+        if (pmw3901mb_interface_spi_set_clock(spi_hz) != 0)
+        {
+            return 5;
+        }
+    }
+    
+    /* tune the spi clock before the chip runs */
+    if ((spi_tune != 0) && ((type[0] == 't') || (type[0] == 'e')))
+    {
+        if (a_spi_tune() != 0)
+        {
+            return 1;
+        }
+    }
 
     /* run the function */
     if (strcmp("t_reg", type) == 0)
@@ -333,12 +466,80 @@ uint8_t pmw3901mb(uint8_t argc, char **argv)
         
         return 0;
     }
+    else if (strcmp("e_log", type) == 0)
+    {
+        uint8_t res;
+        uint32_t i;
+        uint32_t n;
+        pmw3901mb_log_writer_t writer;
+        
+        /* basic init */
+        res = pmw3901mb_basic_init();
+        if (res != 0)
+        {
+            return 1;
+        }
+        
+        /* open the log */
+        res = pmw3901mb_log_writer_open(&writer, log_path, 0);
+        if (res != 0)
+        {
+            pmw3901mb_interface_debug_print("pmw3901mb: open %s failed.\n", log_path);
+            (void)pmw3901mb_basic_deinit();
+            
+            return 1;
+        }
+        
+        /* loop */
+        for (i = 0; i < times; i += n)
+        {
+            /* read data */
+            n = ((times - i) > 64) ? 64 : (times - i);
+            res = pmw3901mb_basic_read_many(gs_samples, n, period_us);
+            if (res != 0)
+            {
+                (void)pmw3901mb_log_writer_close(&writer);
+                (void)pmw3901mb_basic_deinit();
+                
+                return 1;
+            }
+            
+            /* write the log */
+            res = pmw3901mb_log_writer_write(&writer, gs_samples, n);
+            if (res != 0)
+            {
+                pmw3901mb_interface_debug_print("pmw3901mb: write %s failed.\n", log_path);
+                (void)pmw3901mb_log_writer_close(&writer);
+                (void)pmw3901mb_basic_deinit();
+                
+                return 1;
+            }
+        }
+        
+        /* close the log */
+        res = pmw3901mb_log_writer_close(&writer);
+        if (res != 0)
+        {
+            pmw3901mb_interface_debug_print("pmw3901mb: close %s failed.\n", log_path);
+            (void)pmw3901mb_basic_deinit();
+            
+            return 1;
+        }
+        pmw3901mb_interface_debug_print("pmw3901mb: %d samples, %d blocks, %d bytes in %s.\n",
+                                        (uint32_t)writer.samples, writer.blocks, (uint32_t)writer.bytes, log_path);
+        
+        /* basic deinit */
+        (void)pmw3901mb_basic_deinit();
+        
+        return 0;
+    }
     else if (strcmp("e_frame", type) == 0)
     {
         uint8_t res;
         uint32_t k;
         uint32_t i;
         uint32_t j;
+        pmw3901mb_log_writer_t writer;
         
         /* frame init */
         res = pmw3901mb_frame_init();
@@ -347,6 +548,19 @@ uint8_t pmw3901mb(uint8_t argc, char **argv)
             return 1;
         }
         
+        /* open the log */
+        if (log_set != 0)
+        {
+            res = pmw3901mb_log_writer_open(&writer, log_path, 0);
+            if (res != 0)
+            {
+                pmw3901mb_interface_debug_print("pmw3901mb: open %s failed.\n", log_path);
+                (void)pmw3901mb_frame_deinit();
+                
+                return 1;
+            }
+        }
+        
         /* loop */
         for (k = 0; k < times; k++)
         {
@@ -354,6 +568,10 @@ uint8_t pmw3901mb(uint8_t argc, char **argv)
             res = pmw3901mb_frame_read(gs_frame);
             if (res != 0)
             {
+                if (log_set != 0)
+                {
+                    (void)pmw3901mb_log_writer_close(&writer);
+                }
                 (void)pmw3901mb_frame_deinit();
                 
                 return 1;
@@ -362,20 +580,51 @@ uint8_t pmw3901mb(uint8_t argc, char **argv)
             /* read data */
             pmw3901mb_interface_debug_print("pmw3901mb: %d/%d.\n", k + 1, times);
             
-            /* print frame */
-            for (i = 0; i < 35; i++)
+            if (log_set != 0)
+            {
+                /* write the log */
+                res = pmw3901mb_log_writer_write_frame(&writer, gs_frame, pmw3901mb_interface_get_timestamp_us());
+                if (res != 0)
+                {
+                    pmw3901mb_interface_debug_print("pmw3901mb: write %s failed.\n", log_path);
+                    (void)pmw3901mb_log_writer_close(&writer);
+                    (void)pmw3901mb_frame_deinit();
+                    
+                    return 1;
+                }
+            }
+            else
             {
-                for (j = 0; j < 35; j++)
+                /* print frame */
+                for (i = 0; i < 35; i++)
                 {
-                    pmw3901mb_interface_debug_print("0x%02X ", gs_frame[i][j]);
+                    for (j = 0; j < 35; j++)
+                    {
+                        pmw3901mb_interface_debug_print("0x%02X ", gs_frame[i][j]);
+                    }
+                    pmw3901mb_interface_debug_print("\n");
                 }
-                pmw3901mb_interface_debug_print("\n");
             }
             
             /* delay 1000 ms */
             pmw3901mb_interface_delay_ms(1000);
         }
         
+        /* close the log */
+        if (log_set != 0)
+        {
+            res = pmw3901mb_log_writer_close(&writer);
+            if (res != 0)
+            {
+                pmw3901mb_interface_debug_print("pmw3901mb: close %s failed.\n", log_path);
+                (void)pmw3901mb_frame_deinit();
+                
+                return 1;
+            }
+            pmw3901mb_interface_debug_print("pmw3901mb: %d frames, %d bytes in %s.\n",
+                                            writer.frames, (uint32_t)writer.bytes, log_path);
+        }
+        
         (void)pmw3901mb_frame_deinit();
         
         return 0;
@@ -414,6 +663,8 @@ uint8_t pmw3901mb(uint8_t argc, char **argv)
             gs_flag = 0;
             while (gs_flag == 0)
             {
+                /* process the samples */
+                (void)pmw3901mb_interrupt_process(height);
                 pmw3901mb_interface_delay_ms(10);
             }
         }
@@ -437,18 +688,24 @@ uint8_t pmw3901mb(uint8_t argc, char **argv)
         pmw3901mb_interface_debug_print("  pmw3901mb (-t frame | --test=frame) [--times=<num>]\n");
         pmw3901mb_interface_debug_print("  pmw3901mb (-t int | --test=int) [--times=<num>]\n");
         pmw3901mb_interface_debug_print("  pmw3901mb (-e read | --example=read) [--height=<m>] [--times=<num>]\n");
-        pmw3901mb_interface_debug_print("  pmw3901mb (-e frame | --example=frame) [--times=<num>]\n");
-        pmw3901mb_interface_debug_print("  pmw3901mb (-e int | --example=int) [--times=<num>]\n");
+        pmw3901mb_interface_debug_print("  pmw3901mb (-e frame | --example=frame) [--log=<file>] [--times=<num>]\n");
+        pmw3901mb_interface_debug_print("  pmw3901mb (-e int | --example=int) [--height=<m>] [--times=<num>]\n");
+        pmw3901mb_interface_debug_print("  pmw3901mb (-e log | --example=log) [--log=<file>] [--period=<us>] [--times=<num>]\n");
+        pmw3901mb_interface_debug_print("  pmw3901mb (-t | -e) <...> [--spi-hz=<hz>] [--spi-tune]\n");
         pmw3901mb_interface_debug_print("\n");
         pmw3901mb_interface_debug_print("Options:\n");
-        pmw3901mb_interface_debug_print("  -e <read | frame | int>, --example=<read | frame | int>\n");
+        pmw3901mb_interface_debug_print("  -e <read | frame | int | log>, --example=<read | frame | int | log>\n");
         pmw3901mb_interface_debug_print("                              Run the driver example.\n");
         pmw3901mb_interface_debug_print("  -h, --help                  Show the help.\n");
         pmw3901mb_interface_debug_print("      --height=<m>            Set the chip height in m.([default: 1.0])\n");
         pmw3901mb_interface_debug_print("  -i, --information           Show the chip information.\n");
+        pmw3901mb_interface_debug_print("      --log=<file>            Set the binary motion log file.([default: pmw3901mb.log])\n");
         pmw3901mb_interface_debug_print("  -p, --port                  Display the pin connections of the current board.\n");
+        pmw3901mb_interface_debug_print("      --period=<us>           Set the log sample period in us, 0 is back to back.([default: 0])\n");
         pmw3901mb_interface_debug_print("  -t <reg | read | frame | int>, --test=<reg | read | frame | int>\n");
         pmw3901mb_interface_debug_print("                              Run the driver test.\n");
+        pmw3901mb_interface_debug_print("      --spi-hz=<hz>           Set the spi clock in Hz.([default: 1000000])\n");
+        pmw3901mb_interface_debug_print("      --spi-tune              Step up the spi clock and settle on the fastest reliable one.\n");
         pmw3901mb_interface_debug_print("      --times=<num>           Set the running times.([default: 3])\n");
         
         return 0;
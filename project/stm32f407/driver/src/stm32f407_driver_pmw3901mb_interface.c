@@ -41,6 +41,12 @@
 #include "wire.h"
 #include <stdarg.h>
 
+/**
+ * @brief spi transfer timing definition
+ */
+#define SPI_TSWW_US     45        /**< write to next command delay */
+#define SPI_TSRW_US     20        /**< read to next command delay */
+
 /**
  * @brief  interface spi bus init
  * @return status code
@@ -95,6 +101,43 @@ uint8_t pmw3901mb_interface_spi_write(uint8_t reg, uint8_t *buf, uint16_t len)
     return spi_write(reg, buf, len);
 }
 
+/**
+ * @brief         interface spi bus transfer batch
+ * @param[in,out] *transfer pointer to a transfer array
+ * @param[in]     num transfer number
+ * @return        status code
+ *                - 0 success
+ *                - 1 transfer failed
+ * @note          the driver skips its own tSWW and tSRW delays when this is linked,
+ *                so each transfer waits them here
+ */
+uint8_t pmw3901mb_interface_spi_transfer_batch(pmw3901mb_transfer_t *transfer, uint16_t num)
+{
+    uint16_t i;
+    
+    for (i = 0; i < num; i++)
+    {
+        if ((transfer[i].reg & 0x80) != 0)
+        {
+            if (spi_write(transfer[i].reg, transfer[i].buf, transfer[i].len) != 0)
+            {
+                return 1;
+            }
+            delay_us(SPI_TSWW_US);
+        }
+        else
+        {
+            if (spi_read(transfer[i].reg, transfer[i].buf, transfer[i].len) != 0)
+            {
+                return 1;
+            }
+            delay_us(SPI_TSRW_US);
+        }
+    }
+    
+    return 0;
+}
+
 /**
  * @brief  interface reset gpio init
  * @return status code
@@ -142,6 +185,51 @@ void pmw3901mb_interface_delay_ms(uint32_t ms)
     delay_ms(ms);
 }
 
+/**
+ * @brief     interface delay us
+ * @param[in] us time
+ * @note      none
+ */
+void pmw3901mb_interface_delay_us(uint32_t us)
+{
+    delay_us(us);
+}
+
+/**
+ * @brief  interface get timestamp us
+ * @return timestamp in us
+ * @note   none
+ */
+uint64_t pmw3901mb_interface_get_timestamp_us(void)
+{
+    uint32_t ms;
+    uint32_t val;
+
+    /* read the tick and the systick counter together */
+    do
+    {
+        ms = HAL_GetTick();
+        val = SysTick->VAL;
+    } while (ms != HAL_GetTick());
+
+    return (uint64_t)ms * 1000 + (SysTick->LOAD - val) / (SystemCoreClock / 1000000);
+}
+
+/**
+ * @brief      interface get the motion edge timestamp
+ * @param[out] *us pointer to a timestamp buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 no edge is being serviced
+ * @note       the exti irq runs the handler at the edge, so get_timestamp_us is used
+ */
+uint8_t pmw3901mb_interface_get_edge_timestamp_us(uint64_t *us)
+{
+    (void)us;
+    
+    return 1;
+}
+
 /**
  * @brief     interface print format data
  * @param[in] fmt format data
@@ -448,6 +448,8 @@ uint8_t pmw3901mb(uint8_t argc, char **argv)
             gs_flag = 0;
             while (gs_flag == 0)
             {
+                /* process the samples */
+                (void)pmw3901mb_interrupt_process(height);
                 pmw3901mb_interface_delay_ms(10);
             }
         }
@@ -472,7 +474,7 @@ uint8_t pmw3901mb(uint8_t argc, char **argv)
         pmw3901mb_interface_debug_print("  pmw3901mb (-t int | --test=int) [--times=<num>]\n");
         pmw3901mb_interface_debug_print("  pmw3901mb (-e read | --example=read) [--height=<m>] [--times=<num>]\n");
         pmw3901mb_interface_debug_print("  pmw3901mb (-e frame | --example=frame) [--times=<num>]\n");
-        pmw3901mb_interface_debug_print("  pmw3901mb (-e int | --example=int) [--times=<num>]\n");
+        pmw3901mb_interface_debug_print("  pmw3901mb (-e int | --example=int) [--height=<m>] [--times=<num>]\n");
         pmw3901mb_interface_debug_print("\n");
         pmw3901mb_interface_debug_print("Options:\n");
         pmw3901mb_interface_debug_print("  -e <read | frame | int>, --example=<read | frame | int>\n");
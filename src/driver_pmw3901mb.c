@@ -73,2346 +73,3804 @@
 #define PMW3901MB_REG_INVERSE_PRODUCT_ID          0x5F        /**< inverse product id register */
 
 /**
- * @brief      read bytes
- * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[in]  reg register address
- * @param[out] *buf pointer to a data buffer
- * @param[in]  len data length
- * @return     status code
- *             - 0 success
- *             - 1 spi read failed
- * @note       none
+ * @brief bank select register definition
  */
-static uint8_t a_pmw3901mb_spi_read(pmw3901mb_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
+#define PMW3901MB_REG_BANK_SELECT                 0x7F        /**< bank select register */
+
+/**
+ * @brief sequence opcode definition
+ */
+#define PMW3901MB_SEQ_WRITE                  0x00        /**< write value to reg */
+#define PMW3901MB_SEQ_DELAY_MS               0x01        /**< delay param ms */
+#define PMW3901MB_SEQ_RETRY                  0x02        /**< set value retry times with param ms delay and mark the next record as the retry point */
+#define PMW3901MB_SEQ_EXPECT                 0x03        /**< read reg and retry from the retry point until it equals value */
+#define PMW3901MB_SEQ_SKIP_IF_CLEAR          0x04        /**< read reg and skip param records if all the value bits are cleared */
+#define PMW3901MB_SEQ_SKIP_IF_NOT_EQUAL      0x05        /**< read reg and skip param records if it doesn't equal value */
+#define PMW3901MB_SEQ_SKIP                   0x06        /**< skip param records */
+#define PMW3901MB_SEQ_LOAD_C1                0x07        /**< read reg and keep the corrected c1 */
+#define PMW3901MB_SEQ_LOAD_C2                0x08        /**< read reg and keep the corrected c2 */
+#define PMW3901MB_SEQ_WRITE_C1               0x09        /**< write c1 to reg */
+#define PMW3901MB_SEQ_WRITE_C2               0x0A        /**< write c2 to reg */
+
+/**
+ * @brief max transfers in one batch definition
+ */
+#ifndef PMW3901MB_BATCH_MAX
+    #define PMW3901MB_BATCH_MAX              16          /**< max transfers in one batch */
+#endif
+
+/**
+ * @brief max raw data grab reads in one batch definition
+ */
+#ifndef PMW3901MB_FRAME_BATCH_MAX
+    #define PMW3901MB_FRAME_BATCH_MAX        70          /**< max raw data grab reads in one batch, one frame row */
+#endif
+
+/**
+ * @brief delta conversion definition
+ */
+#define PMW3901MB_CM_PER_COUNT               (2.54f / 11.914f)        /**< cm per count at 1 m height */
+#define PMW3901MB_CM_PER_COUNT_Q32           915663667LL              /**< cm per count at 1 m height in q0.32 */
+
+/**
+ * @brief boot state definition
+ */
+#define PMW3901MB_BOOT_STATE_IDLE            0x00        /**< no boot is in progress */
+#define PMW3901MB_BOOT_STATE_RESET_HIGH      0x01        /**< release the reset */
+#define PMW3901MB_BOOT_STATE_CHECK_ID        0x02        /**< check the product id */
+#define PMW3901MB_BOOT_STATE_CLEAR_MOTION    0x03        /**< read the motion registers once */
+#define PMW3901MB_BOOT_STATE_OPTIMUM         0x04        /**< run the optimum performance sequence */
+
+/**
+ * @brief timing definition used when delay_us is linked
+ */
+#define PMW3901MB_TIMING_TSWW_US             45          /**< write to next command time */
+#define PMW3901MB_TIMING_TSRW_US             20          /**< read to next command time */
+#define PMW3901MB_TIMING_RESET_US            20          /**< nreset low pulse width */
+#define PMW3901MB_TIMING_RESET_WAIT_US       1000        /**< nreset high to the first command time */
+#define PMW3901MB_TIMING_POWER_UP_US         5000        /**< power up reset to the first motion read time */
+#define PMW3901MB_TIMING_SEQ_POLL_US         1000        /**< sequence expect poll interval inside the retry delay */
+#define PMW3901MB_TIMING_FRAME_POLL_US       250         /**< raw data grab poll interval */
+#define PMW3901MB_TIMING_FRAME_TIMEOUT_US    100000      /**< raw data grab no progress timeout */
+
+/**
+ * @brief optimum performance sequence
+ */
+static const pmw3901mb_sequence_t gsc_pmw3901mb_optimum_performance[] =
 {
-    if (handle->spi_read(reg, buf, len) != 0)        /* spi read */
-    {
-        return 1;                                    /* return error */
-    }
-    else
-    {
-        return 0;                                    /* success return 0 */
-    }
-}
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,              0x55, 0x01,   0},
+    {PMW3901MB_SEQ_WRITE,              0x50, 0x07,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x0E,   0},
+    {PMW3901MB_SEQ_RETRY,              0x00, 0x03, 100},
+    {PMW3901MB_SEQ_WRITE,              0x43, 0x10,   0},
+    {PMW3901MB_SEQ_EXPECT,             0x47, 0x08,   0},
+    {PMW3901MB_SEQ_SKIP_IF_CLEAR,      0x67, 0x80,   2},
+    {PMW3901MB_SEQ_WRITE,              0x48, 0x04,   0},
+    {PMW3901MB_SEQ_SKIP,               0x00, 0x00,   1},
+    {PMW3901MB_SEQ_WRITE,              0x48, 0x02,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,              0x51, 0x7B,   0},
+    {PMW3901MB_SEQ_WRITE,              0x50, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,              0x55, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x0E,   0},
+    {PMW3901MB_SEQ_SKIP_IF_NOT_EQUAL,  0x73, 0x00,   8},
+    {PMW3901MB_SEQ_LOAD_C1,            0x70, 0x00,   0},
+    {PMW3901MB_SEQ_LOAD_C2,            0x71, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,              0x61, 0xAD,   0},
+    {PMW3901MB_SEQ_WRITE,              0x51, 0x70,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x0E,   0},
+    {PMW3901MB_SEQ_WRITE_C1,           0x70, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE_C2,           0x71, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,              0x61, 0xAD,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x03,   0},
+    {PMW3901MB_SEQ_WRITE,              0x40, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x05,   0},
+    {PMW3901MB_SEQ_WRITE,              0x41, 0xB3,   0},
+    {PMW3901MB_SEQ_WRITE,              0x43, 0xF1,   0},
+    {PMW3901MB_SEQ_WRITE,              0x45, 0x14,   0},
+    {PMW3901MB_SEQ_WRITE,              0x5B, 0x32,   0},
+    {PMW3901MB_SEQ_WRITE,              0x5F, 0x34,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7B, 0x08,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x06,   0},
+    {PMW3901MB_SEQ_WRITE,              0x44, 0x1B,   0},
+    {PMW3901MB_SEQ_WRITE,              0x40, 0xBF,   0},
+    {PMW3901MB_SEQ_WRITE,              0x4E, 0x3F,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x08,   0},
+    {PMW3901MB_SEQ_WRITE,              0x65, 0x20,   0},
+    {PMW3901MB_SEQ_WRITE,              0x6A, 0x18,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x09,   0},
+    {PMW3901MB_SEQ_WRITE,              0x4F, 0xAF,   0},
+    {PMW3901MB_SEQ_WRITE,              0x5F, 0x40,   0},
+    {PMW3901MB_SEQ_WRITE,              0x48, 0x80,   0},
+    {PMW3901MB_SEQ_WRITE,              0x49, 0x80,   0},
+    {PMW3901MB_SEQ_WRITE,              0x57, 0x77,   0},
+    {PMW3901MB_SEQ_WRITE,              0x60, 0x78,   0},
+    {PMW3901MB_SEQ_WRITE,              0x61, 0x78,   0},
+    {PMW3901MB_SEQ_WRITE,              0x62, 0x08,   0},
+    {PMW3901MB_SEQ_WRITE,              0x63, 0x50,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x0A,   0},
+    {PMW3901MB_SEQ_WRITE,              0x45, 0x60,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,              0x4D, 0x11,   0},
+    {PMW3901MB_SEQ_WRITE,              0x55, 0x80,   0},
+    {PMW3901MB_SEQ_WRITE,              0x74, 0x1F,   0},
+    {PMW3901MB_SEQ_WRITE,              0x75, 0x1F,   0},
+    {PMW3901MB_SEQ_WRITE,              0x4A, 0x78,   0},
+    {PMW3901MB_SEQ_WRITE,              0x4B, 0x78,   0},
+    {PMW3901MB_SEQ_WRITE,              0x44, 0x08,   0},
+    {PMW3901MB_SEQ_WRITE,              0x45, 0x50,   0},
+    {PMW3901MB_SEQ_WRITE,              0x64, 0xFF,   0},
+    {PMW3901MB_SEQ_WRITE,              0x65, 0x1F,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x14,   0},
+    {PMW3901MB_SEQ_WRITE,              0x65, 0x67,   0},
+    {PMW3901MB_SEQ_WRITE,              0x66, 0x08,   0},
+    {PMW3901MB_SEQ_WRITE,              0x63, 0x70,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x15,   0},
+    {PMW3901MB_SEQ_WRITE,              0x48, 0x48,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x07,   0},
+    {PMW3901MB_SEQ_WRITE,              0x41, 0x0D,   0},
+    {PMW3901MB_SEQ_WRITE,              0x43, 0x14,   0},
+    {PMW3901MB_SEQ_WRITE,              0x4B, 0x0E,   0},
+    {PMW3901MB_SEQ_WRITE,              0x45, 0x0F,   0},
+    {PMW3901MB_SEQ_WRITE,              0x44, 0x42,   0},
+    {PMW3901MB_SEQ_WRITE,              0x4C, 0x80,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x10,   0},
+    {PMW3901MB_SEQ_WRITE,              0x5B, 0x02,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x07,   0},
+    {PMW3901MB_SEQ_WRITE,              0x40, 0x41,   0},
+    {PMW3901MB_SEQ_WRITE,              0x70, 0x00,   0},
+    {PMW3901MB_SEQ_DELAY_MS,           0x00, 0x00,  10},
+    {PMW3901MB_SEQ_WRITE,              0x32, 0x44,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x07,   0},
+    {PMW3901MB_SEQ_WRITE,              0x40, 0x40,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x06,   0},
+    {PMW3901MB_SEQ_WRITE,              0x62, 0xF0,   0},
+    {PMW3901MB_SEQ_WRITE,              0x63, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x0D,   0},
+    {PMW3901MB_SEQ_WRITE,              0x48, 0xC0,   0},
+    {PMW3901MB_SEQ_WRITE,              0x6F, 0xD5,   0},
+    {PMW3901MB_SEQ_WRITE,              0x7F, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,              0x5B, 0xA0,   0},
+    {PMW3901MB_SEQ_WRITE,              0x4E, 0xA8,   0},
+    {PMW3901MB_SEQ_WRITE,              0x5A, 0x50,   0},
+    {PMW3901MB_SEQ_WRITE,              0x40, 0x80,   0}
+};
 
 /**
- * @brief     write bytes
+ * @brief start frame capture sequence
+ */
+static const pmw3901mb_sequence_t gsc_pmw3901mb_start_frame_capture[] =
+{
+    {PMW3901MB_SEQ_WRITE,  0x7F, 0x07,   0},
+    {PMW3901MB_SEQ_WRITE,  0x41, 0x1D,   0},
+    {PMW3901MB_SEQ_WRITE,  0x4C, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,  0x7F, 0x08,   0},
+    {PMW3901MB_SEQ_WRITE,  0x6A, 0x38,   0},
+    {PMW3901MB_SEQ_WRITE,  0x7F, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,  0x55, 0x04,   0},
+    {PMW3901MB_SEQ_WRITE,  0x40, 0x80,   0},
+    {PMW3901MB_SEQ_WRITE,  0x4D, 0x11,   0}
+};
+
+/**
+ * @brief stop frame capture sequence
+ */
+static const pmw3901mb_sequence_t gsc_pmw3901mb_stop_frame_capture[] =
+{
+    {PMW3901MB_SEQ_WRITE,  0x7F, 0x00,   0},
+    {PMW3901MB_SEQ_WRITE,  0x4D, 0x11,   0},
+    {PMW3901MB_SEQ_WRITE,  0x40, 0x80,   0},
+    {PMW3901MB_SEQ_WRITE,  0x55, 0x80,   0},
+    {PMW3901MB_SEQ_WRITE,  0x7F, 0x08,   0},
+    {PMW3901MB_SEQ_WRITE,  0x6A, 0x18,   0},
+    {PMW3901MB_SEQ_WRITE,  0x7F, 0x07,   0},
+    {PMW3901MB_SEQ_WRITE,  0x41, 0x0D,   0},
+    {PMW3901MB_SEQ_WRITE,  0x4C, 0x80,   0},
+    {PMW3901MB_SEQ_WRITE,  0x7F, 0x00,   0}
+};
+
+/**
+ * @brief     delay
  * @param[in] *handle pointer to a pmw3901mb handle structure
- * @param[in] reg register address
- * @param[in] *buf pointer to a data buffer
- * @param[in] len data length
- * @return    status code
- *            - 0 success
- *            - 1 spi write failed
+ * @param[in] us delay us used when delay_us is linked
+ * @param[in] ms delay ms used when delay_us is not linked
  * @note      none
  */
-static uint8_t a_pmw3901mb_spi_write(pmw3901mb_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
+static void a_pmw3901mb_delay(pmw3901mb_handle_t *handle, uint32_t us, uint32_t ms)
 {
-    if (handle->spi_write(0x80 | reg, buf, len) != 0)        /* spi write */
+    if (handle->delay_us != NULL)        /* check delay_us */
     {
-        return 1;                                            /* return error */
+        handle->delay_us(us);            /* delay us */
     }
     else
     {
-        return 0;                                            /* success return 0 */
+        handle->delay_ms(ms);            /* delay ms */
     }
 }
 
 /**
- * @brief     initialize the chip
+ * @brief     clear the register shadow
  * @param[in] *handle pointer to a pmw3901mb handle structure
- * @return    status code
- *            - 0 success
- *            - 1 spi or gpio initialization failed
- *            - 2 handle is NULL
- *            - 3 linked functions is NULL
- *            - 4 id is invalid
- *            - 5 reset failed
  * @note      none
  */
-uint8_t pmw3901mb_init(pmw3901mb_handle_t *handle)
+static void a_pmw3901mb_shadow_clear(pmw3901mb_handle_t *handle)
 {
-    uint8_t id;
-  
-    if (handle == NULL)                                                                  /* check handle */
-    {
-        return 2;                                                                        /* return error */
-    }
-    if (handle->debug_print == NULL)                                                     /* check debug_print */
+    handle->shadow_bank_valid = 0;        /* bank is unknown */
+    handle->shadow_num = 0;               /* clear registers */
+}
+
+/**
+ * @brief         store a register value in a shadow table
+ * @param[in,out] *table pointer to a shadow table
+ * @param[in,out] *num pointer to a table number buffer
+ * @param[in]     size table size
+ * @param[in]     bank register bank
+ * @param[in]     reg register address
+ * @param[in]     value written value
+ * @note          the value is dropped when the table is full
+ */
+static void a_pmw3901mb_shadow_store(pmw3901mb_shadow_t *table, uint16_t *num, uint16_t size,
+                                     uint8_t bank, uint8_t reg, uint8_t value)
+{
+    uint16_t i;
+    
+    for (i = 0; i < *num; i++)                                                        /* find the register */
     {
-        return 3;                                                                        /* return error */
+        if ((table[i].bank == bank) && (table[i].reg == reg))                         /* check the register */
+        {
+            table[i].value = value;                                                   /* update value */
+            
+            return;                                                                   /* return */
+        }
     }
-    if (handle->spi_init == NULL)                                                        /* check spi_init */
+    if (*num < size)                                                                  /* check the space */
     {
-        handle->debug_print("pmw3901mb: spi_init is null.\n");                           /* spi_init is null */
-       
-        return 3;                                                                        /* return error */
+        table[*num].bank = bank;                                                      /* set bank */
+        table[*num].reg = reg;                                                        /* set reg */
+        table[*num].value = value;                                                    /* set value */
+        (*num)++;                                                                     /* num++ */
     }
-    if (handle->spi_deinit == NULL)                                                      /* check spi_deinit */
+}
+
+/**
+ * @brief     track a register write in the shadow
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] reg register address
+ * @param[in] value written value
+ * @note      command registers are not shadowed
+ */
+static void a_pmw3901mb_shadow_write(pmw3901mb_handle_t *handle, uint8_t reg, uint8_t value)
+{
+    if (handle->shadow_enable == 0)                 /* check enable */
     {
-        handle->debug_print("pmw3901mb: spi_deinit is null.\n");                         /* spi_deinit is null */
-       
-        return 3;                                                                        /* return error */
+        return;                                                                       /* return */
     }
-    if (handle->spi_read == NULL)                                                        /* check spi_read */
+    if (reg == PMW3901MB_REG_BANK_SELECT)                                             /* bank select */
     {
-        handle->debug_print("pmw3901mb: spi_read is null.\n");                           /* spi_read is null */
-       
-        return 3;                                                                        /* return error */
+        handle->shadow_bank = value;                                                  /* set bank */
+        handle->shadow_bank_valid = 1;                                                /* bank is known */
+        
+        return;                                                                       /* return */
     }
-    if (handle->spi_write == NULL)                                                       /* check spi_write */
+    if ((reg == PMW3901MB_REG_POWER_UP_RESET) || (reg == PMW3901MB_REG_SHUTDOWN))     /* chip reset */
     {
-        handle->debug_print("pmw3901mb: spi_write is null.\n");                          /* spi_write is null */
-       
-        return 3;                                                                        /* return error */
+        a_pmw3901mb_shadow_clear(handle);                                             /* clear the shadow */
+        
+        return;                                                                       /* return */
     }
-    if (handle->reset_gpio_init == NULL)                                                 /* check reset_gpio_init */
+    if ((handle->shadow_bank_valid == 0) ||
+        (reg == PMW3901MB_REG_MOTION) || (reg == PMW3901MB_REG_RAW_DATA_GRAB))        /* unknown bank or command */
     {
-        handle->debug_print("pmw3901mb: reset_gpio_init is null.\n");                    /* reset_gpio_init is null */
-       
-        return 3;                                                                        /* return error */
+        return;                                                                       /* return */
     }
-    if (handle->reset_gpio_deinit == NULL)                                               /* check reset_gpio_deinit */
+    
+    if (handle->shadow != NULL)                                                       /* check the shadow buffer */
     {
-        handle->debug_print("pmw3901mb: reset_gpio_deinit is null.\n");                  /* reset_gpio_deinit is null */
-       
-        return 3;                                                                        /* return error */
+        a_pmw3901mb_shadow_store(handle->shadow, &handle->shadow_num, handle->shadow_size,
+                                 handle->shadow_bank, reg, value);                    /* store in the shadow */
     }
-    if (handle->reset_gpio_write == NULL)                                                /* check reset_gpio_write */
+}
+
+/**
+ * @brief     begin the register image capture
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @note      the capture needs the resume buffer
+ */
+static void a_pmw3901mb_image_begin(pmw3901mb_handle_t *handle)
+{
+    handle->image_capture = (handle->image != NULL) ? 1 : 0;        /* start capture */
+    handle->image_full = 0;                                         /* clear overflow */
+    handle->image_num = 0;                                          /* clear the image */
+    handle->image_retry = 0;                                        /* clear the retry point */
+}
+
+/**
+ * @brief     append a record to the register image
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] op opcode
+ * @param[in] reg register address
+ * @param[in] value register value, compare value or retry times
+ * @param[in] param delay ms
+ * @note      the records are kept in the run order, a full image flags the overflow
+ */
+static void a_pmw3901mb_image_record(pmw3901mb_handle_t *handle, uint8_t op, uint8_t reg, uint8_t value, uint8_t param)
+{
+    if (handle->image_capture == 0)                                 /* check the capture */
     {
-        handle->debug_print("pmw3901mb: reset_gpio_write is null.\n");                   /* reset_gpio_write is null */
-       
-        return 3;                                                                        /* return error */
+        return;                                                     /* return */
     }
-    if (handle->delay_ms == NULL)                                                        /* check delay_ms */
+    if (handle->image_num >= handle->image_size)                    /* check the space */
     {
-        handle->debug_print("pmw3901mb: delay_ms is null.\n");                           /* delay_ms is null */
-       
-        return 3;                                                                        /* return error */
+        handle->image_full = 1;                                     /* flag overflow */
+        
+        return;                                                     /* return */
     }
     
-    if (handle->spi_init() != 0)                                                         /* initialize spi bus */
-    {
-        handle->debug_print("pmw3901mb: spi init failed.\n");                            /* spi init failed */
-       
-        return 1;                                                                        /* return error */
-    }
-    if (handle->reset_gpio_init() != 0)                                                  /* initialize gpio */
+    handle->image[handle->image_num].op = op;                       /* set op */
+    handle->image[handle->image_num].reg = reg;                     /* set reg */
+    handle->image[handle->image_num].value = value;                 /* set value */
+    handle->image[handle->image_num].param = param;                 /* set param */
+    handle->image_num++;                                            /* num++ */
+    if (op == PMW3901MB_SEQ_RETRY)                                  /* retry */
     {
-        handle->debug_print("pmw3901mb: gpio init failed.\n");                           /* gpio init failed */
-        (void)handle->spi_deinit();                                                      /* spi deinit */
-        
-        return 1;                                                                        /* return error */
+        handle->image_retry = handle->image_num;                    /* the next record is the retry point */
     }
-    if (handle->reset_gpio_write(0) != 0)                                                /* write 0 */
+}
+
+/**
+ * @brief     end the register image capture
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] success bool value
+ * @return    status code
+ *            - 0 success
+ *            - 1 image is full
+ * @note      a failed or full capture drops the image
+ */
+static uint8_t a_pmw3901mb_image_end(pmw3901mb_handle_t *handle, uint8_t success)
+{
+    uint8_t full;
+    
+    full = handle->image_full;                                    /* save overflow */
+    if ((success == 0) || (full != 0))                            /* check success */
     {
-        handle->debug_print("pmw3901mb: reset failed.\n");                               /* reset failed */
-        (void)handle->spi_deinit();                                                      /* spi deinit */
-        (void)handle->reset_gpio_deinit();                                               /* reset gpio deinit */
-        
-        return 5;                                                                        /* return error */
+        handle->image_num = 0;                                    /* drop the image */
     }
-    handle->delay_ms(10);                                                                /* delay 10 ms */
-    if (handle->reset_gpio_write(1) != 0)                                                /* write 1 */
+    handle->image_capture = 0;                                    /* stop capture */
+    handle->image_full = 0;                                       /* clear overflow */
+    if ((success != 0) && (full != 0))                            /* check overflow */
     {
-        handle->debug_print("pmw3901mb: reset failed.\n");                               /* reset failed */
-        (void)handle->spi_deinit();                                                      /* spi deinit */
-        (void)handle->reset_gpio_deinit();                                               /* reset gpio deinit */
+        handle->debug_print("pmw3901mb: register image is full.\n");        /* register image is full */
         
-        return 5;                                                                        /* return error */
+        return 1;                                                 /* return error */
     }
-    handle->delay_ms(10);                                                                /* delay 10 ms */
-    if (a_pmw3901mb_spi_read(handle, PMW3901MB_REG_PRODUCT_ID, (uint8_t *)&id, 1) != 0)  /* get product id */
+    
+    return 0;                                                     /* success return 0 */
+}
+
+/**
+ * @brief     count a failed spi call
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @note      none
+ */
+static void a_pmw3901mb_stats_spi_error(pmw3901mb_handle_t *handle)
+{
+    if (handle->stats != NULL)                /* check stats */
     {
-        handle->debug_print("pmw3901mb: get product id failed.\n");                      /* get product id failed */
-        (void)handle->spi_deinit();                                                      /* spi deinit */
-        (void)handle->reset_gpio_deinit();                                               /* reset gpio deinit */
-       
-        return 4;                                                                        /* return error */
+        handle->stats->spi_error++;           /* spi error++ */
     }
-    if (id != 0x49)                                                                      /* check id */
+}
+
+/**
+ * @brief     begin an api stats sample
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @return    start timestamp in us
+ * @note      handle can be NULL
+ */
+static uint64_t a_pmw3901mb_stats_begin(pmw3901mb_handle_t *handle)
+{
+    if ((handle == NULL) || (handle->stats == NULL) ||
+        (handle->get_timestamp_us == NULL))                 /* check stats */
     {
-        handle->debug_print("pmw3901mb: id is invalid.\n");                              /* id is invalid */
-        (void)handle->spi_deinit();                                                      /* spi deinit */
-        (void)handle->reset_gpio_deinit();                                               /* reset gpio deinit */
-       
-        return 4;                                                                        /* return error */
+        return 0;                                           /* no timestamp */
     }
-    handle->inited = 1;                                                                  /* flag finish initialization */
     
-    return 0;                                                                            /* success return 0 */
+    return handle->get_timestamp_us();                      /* return the start timestamp */
 }
 
 /**
- * @brief     close the chip
+ * @brief     end an api stats sample
  * @param[in] *handle pointer to a pmw3901mb handle structure
- * @return    status code
- *            - 0 success
- *            - 1 spi or gpio deinit failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- *            - 4 power down failed
- * @note      none
+ * @param[in] api stats api
+ * @param[in] start start timestamp in us
+ * @param[in] res api result
+ * @note      handle can be NULL, the latency is put into the floor(log2(us)) bucket
  */
-uint8_t pmw3901mb_deinit(pmw3901mb_handle_t *handle)
+static void a_pmw3901mb_stats_end(pmw3901mb_handle_t *handle, pmw3901mb_stats_api_t api, uint64_t start, uint8_t res)
 {
-    uint8_t res;
-    uint8_t cmd;
+    uint64_t us;
+    uint8_t bucket;
     
-    if (handle == NULL)                                                                    /* check handle */
-    {
-        return 2;                                                                          /* return error */
-    }
-    if (handle->inited != 1)                                                               /* check handle initialization */
+    if ((handle == NULL) || (handle->stats == NULL))                    /* check stats */
     {
-        return 3;                                                                          /* return error */
+        return;                                                         /* return */
     }
-    
-    cmd = 0xB6;                                                                            /* shutdown command */
-    res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_SHUTDOWN, (uint8_t *)&cmd, 1);       /* set shutdown reset */
-    if (res != 0)                                                                          /* check result */
+    handle->stats->api_call[api]++;                                     /* call++ */
+    if (res != 0)                                                       /* check result */
     {
-        handle->debug_print("pmw3901mb: power down failed.\n");                            /* power down failed */
-       
-        return 4;                                                                          /* return error */
+        handle->stats->api_error[api]++;                                /* error++ */
     }
-    res = handle->spi_deinit();                                                            /* spi deinit */
-    if (res != 0)                                                                          /* check result */
+    if (handle->get_timestamp_us == NULL)                               /* check get_timestamp_us */
     {
-        handle->debug_print("pmw3901mb: spi deinit failed.\n");                            /* spi deinit failed */
-       
-        return 1;                                                                          /* return error */
+        return;                                                         /* return */
     }
-    res = handle->reset_gpio_deinit();                                                     /* reset gpio deinit */
-    if (res != 0)                                                                          /* check result */
+    us = handle->get_timestamp_us() - start;                            /* get latency */
+    bucket = 0;                                                         /* init bucket */
+    while ((us > 1) && (bucket < (PMW3901MB_STATS_BUCKET_MAX - 1)))     /* find the bucket */
     {
-        handle->debug_print("pmw3901mb: gpio deinit failed.\n");                           /* gpio deinit failed */
-       
-        return 1;                                                                          /* return error */
+        us >>= 1;                                                       /* us /= 2 */
+        bucket++;                                                       /* bucket++ */
     }
-    handle->inited = 0;                                                                    /* flag close */
-    
-    return 0;                                                                              /* success return 0 */
+    handle->stats->latency[api][bucket]++;                              /* bucket++ */
 }
 
 /**
- * @brief     power up the chip
+ * @brief     record a transfer in the trace ring
  * @param[in] *handle pointer to a pmw3901mb handle structure
- * @return    status code
- *            - 0 success
- *            - 1 power up failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
+ * @param[in] reg register address, bit 7 is set for a write
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
+ * @param[in] result spi result
  * @note      none
  */
-uint8_t pmw3901mb_power_up(pmw3901mb_handle_t *handle)
+static void a_pmw3901mb_trace_record(pmw3901mb_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len, uint8_t result)
 {
-    uint8_t res;
-    uint8_t cmd;
+    pmw3901mb_trace_entry_t *entry;
+    uint16_t i;
+    uint16_t num;
     
-    if (handle == NULL)                                                                          /* check handle */
+    if (handle->trace == NULL)                                                      /* check trace */
     {
-        return 2;                                                                                /* return error */
+        return;                                                                     /* return */
     }
-    if (handle->inited != 1)                                                                     /* check handle initialization */
+    entry = &handle->trace->entry[handle->trace->head];                             /* get the next entry */
+    if (handle->get_timestamp_us != NULL)                                           /* check get_timestamp_us */
     {
-        return 3;                                                                                /* return error */
+        entry->timestamp_us = (uint32_t)handle->get_timestamp_us();                 /* set the low 32 bits, it wraps every 71.6 min */
     }
-    
-    res = handle->reset_gpio_write(0);                                                           /* write 0 */
-    if (res != 0)                                                                                /* check result */
+    else
     {
-        handle->debug_print("pmw3901mb: set gpio failed.\n");                                    /* set gpio failed */
-       
-        return 1;                                                                                /* return error */
-    }
-    handle->delay_ms(10);                                                                        /* delay 10 ms */
-    res = handle->reset_gpio_write(1);                                                           /* write 1 */
-    if (res != 0)                                                                                /* check result */
-    {
-        handle->debug_print("pmw3901mb: set gpio failed.\n");                                    /* set gpio failed */
-       
-        return 1;                                                                                /* return error */
-    }
-    handle->delay_ms(10);                                                                        /* delay 10 ms */
-    cmd = 0x5A;                                                                                  /* power up command */
-    res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_POWER_UP_RESET, (uint8_t *)&cmd, 1);       /* set power up reset */
-    if (res != 0)                                                                                /* check result */
-    {
-        handle->debug_print("pmw3901mb: set power up reset failed.\n");                          /* set power up reset failed */
-       
-        return 1;                                                                                /* return error */
-    }
-    handle->delay_ms(10);                                                                        /* delay 10 ms */
-    
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_MOTION, (uint8_t *)&cmd, 1);                /* get command */
-    if (res != 0)                                                                                /* check result */
-    {
-        handle->debug_print("pmw3901mb: get command failed.\n");                                 /* get command failed */
-       
-        return 1;                                                                                /* return error */
-    }
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_DELTA_X_L, (uint8_t *)&cmd, 1);             /* get command */
-    if (res != 0)                                                                                /* check result */
-    {
-        handle->debug_print("pmw3901mb: get command failed.\n");                                 /* get command failed */
-       
-        return 1;                                                                                /* return error */
+        entry->timestamp_us = 0;                                                    /* no timestamp */
     }
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_DELTA_X_H, (uint8_t *)&cmd, 1);             /* get command */
-    if (res != 0)                                                                                /* check result */
+    entry->reg = reg;                                                               /* set reg */
+    entry->result = result;                                                         /* set result */
+    entry->len = len;                                                               /* set len */
+    num = (len < PMW3901MB_TRACE_PAYLOAD_MAX) ? len : PMW3901MB_TRACE_PAYLOAD_MAX;  /* get the payload length */
+    for (i = 0; i < num; i++)                                                       /* copy the payload */
     {
-        handle->debug_print("pmw3901mb: get command failed.\n");                                 /* get command failed */
-       
-        return 1;                                                                                /* return error */
+        entry->payload[i] = buf[i];                                                 /* copy the byte */
     }
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_DELTA_Y_L, (uint8_t *)&cmd, 1);             /* get command */
-    if (res != 0)                                                                                /* check result */
+    handle->trace->head++;                                                          /* head++ */
+    if (handle->trace->head >= handle->trace->size)                                 /* check the ring end */
     {
-        handle->debug_print("pmw3901mb: get command failed.\n");                                 /* get command failed */
-       
-        return 1;                                                                                /* return error */
+        handle->trace->head = 0;                                                    /* wrap the head */
     }
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_DELTA_Y_H, (uint8_t *)&cmd, 1);             /* get command */
-    if (res != 0)                                                                                /* check result */
+    if (handle->trace->num < handle->trace->size)                                   /* check the ring fill */
     {
-        handle->debug_print("pmw3901mb: get command failed.\n");                                 /* get command failed */
-       
-        return 1;                                                                                /* return error */
+        handle->trace->num++;                                                       /* num++ */
     }
-    
-    return 0;                                                                                    /* success return 0 */
+    handle->trace->count++;                                                         /* count++ */
 }
 
 /**
- * @brief      burst read data
+ * @brief      read bytes
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *motion pointer to a motion structure
+ * @param[in]  reg register address
+ * @param[out] *buf pointer to a data buffer
+ * @param[in]  len data length
  * @return     status code
  *             - 0 success
- *             - 1 burst read failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
+ *             - 1 spi read failed
  * @note       none
  */
-uint8_t pmw3901mb_burst_read(pmw3901mb_handle_t *handle, pmw3901mb_motion_t *motion)
+static uint8_t a_pmw3901mb_spi_read(pmw3901mb_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
 {
-    uint8_t res;
-    
-    if (handle == NULL)                                                                               /* check handle */
-    {
-        return 2;                                                                                     /* return error */
-    }
-    if (handle->inited != 1)                                                                          /* check handle initialization */
+    if (handle->stats != NULL)                       /* check stats */
     {
-        return 3;                                                                                     /* return error */
-    }
-    
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_MOTION_BURST, (uint8_t *)motion->raw, 12);       /* burst read */
-    if (res != 0)                                                                                     /* check result */
-    {
-        handle->debug_print("pmw3901mb: burst read failed.\n");                                       /* burst read failed */
-       
-        return 1;                                                                                     /* return error */
+        handle->stats->spi_read++;                   /* spi read++ */
+        handle->stats->read_bytes += len;            /* add read bytes */
     }
-    if ((motion->raw[0] & (1 << 7)) != 0)                                                             /* check motion flag */
+    if (handle->spi_read(reg, buf, len) != 0)        /* spi read */
     {
-        if ((motion->raw[6] < 0x19) || (motion->raw[10] == 0x1F))                                     /* check data */
-        {
-            motion->is_valid = 2;                                                                     /* set invalid */
-            
-            return 0;                                                                                 /* success return 0 */
-        }
-        motion->delta_x = (int16_t)(((uint16_t)motion->raw[3] << 8) | motion->raw[2]);                /* set delta_x */
-        motion->delta_y = (int16_t)(((uint16_t)motion->raw[5] << 8) | motion->raw[4]);                /* set delta_y */
-        motion->observation = motion->raw[1] & 0x3F;                                                  /* set observation */
-        motion->raw_average = motion->raw[7];                                                         /* set raw average */
-        motion->raw_max = motion->raw[8];                                                             /* set raw max */
-        motion->raw_min = motion->raw[9];                                                             /* set raw min */
-        motion->shutter = (((((uint16_t)motion->raw[10] & 0x1F) << 8)) | motion->raw[11]);            /* set shutter */
-        motion->surface_quality = motion->raw[6] * 4;                                                 /* set surface quality */
+        a_pmw3901mb_stats_spi_error(handle);         /* spi error++ */
+        a_pmw3901mb_trace_record(handle, reg, buf,
+                                 len, 1);            /* record the transfer */
         
-        motion->is_valid = 1;                                                                         /* set valid */
+        return 1;                                    /* return error */
     }
-    else
+    a_pmw3901mb_trace_record(handle, reg, buf,
+                             len, 0);                /* record the transfer */
+    if (handle->delay_us != NULL)                    /* check delay_us */
     {
-        motion->is_valid = 0;                                                                         /* set invalid */
+        handle->delay_us(PMW3901MB_TIMING_TSRW_US);  /* wait tsrw */
     }
     
-    return 0;                                                                                         /* success return 0 */
+    return 0;                                        /* success return 0 */
 }
 
 /**
- * @brief     start frame capture
+ * @brief     write bytes
  * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] reg register address
+ * @param[in] *buf pointer to a data buffer
+ * @param[in] len data length
  * @return    status code
  *            - 0 success
- *            - 1 start frame capture failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
+ *            - 1 spi write failed
  * @note      none
  */
-uint8_t pmw3901mb_start_frame_capture(pmw3901mb_handle_t *handle)
+static uint8_t a_pmw3901mb_spi_write(pmw3901mb_handle_t *handle, uint8_t reg, uint8_t *buf, uint16_t len)
 {
-    uint8_t res;
-    uint8_t cmd;
-    
-    if (handle == NULL)                                                      /* check handle */
-    {
-        return 2;                                                            /* return error */
-    }
-    if (handle->inited != 1)                                                 /* check handle initialization */
-    {
-        return 3;                                                            /* return error */
-    }
-    
-    cmd = 0x07;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
-    }
-    cmd = 0x1D;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x41, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
-    }
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x4C, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
-    }
-    cmd = 0x08;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
-    }
-    cmd = 0x38;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x6A, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
-    }
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->stats != NULL)                               /* check stats */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        handle->stats->spi_write++;                          /* spi write++ */
+        handle->stats->write_bytes += len;                   /* add write bytes */
     }
-    cmd = 0x04;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x55, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->spi_write(0x80 | reg, buf, len) != 0)        /* spi write */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        a_pmw3901mb_stats_spi_error(handle);                 /* spi error++ */
+        a_pmw3901mb_trace_record(handle, 0x80 | reg, buf,
+                                 len, 1);                    /* record the transfer */
+        a_pmw3901mb_shadow_clear(handle);                    /* the chip state is unknown */
+        
+        return 1;                                            /* return error */
     }
-    cmd = 0x80;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x40, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    a_pmw3901mb_trace_record(handle, 0x80 | reg, buf,
+                             len, 0);                        /* record the transfer */
+    if (len != 0)                                            /* check length */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        a_pmw3901mb_shadow_write(handle, reg, buf[len - 1]); /* track the write */
     }
-    cmd = 0x11;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x4D, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->delay_us != NULL)                            /* check delay_us */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        handle->delay_us(PMW3901MB_TIMING_TSWW_US);          /* wait tsww */
     }
     
-    return 0;                                                                /* success return 0 */
+    return 0;                                                /* success return 0 */
 }
 
 /**
- * @brief     stop frame capture
- * @param[in] *handle pointer to a pmw3901mb handle structure
- * @return    status code
- *            - 0 success
- *            - 1 stop frame capture failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- * @note      none
+ * @brief         transfer a batch of register reads and writes
+ * @param[in]     *handle pointer to a pmw3901mb handle structure
+ * @param[in,out] *transfer pointer to a transfer array
+ * @param[in]     num transfer number
+ * @return        status code
+ *                - 0 success
+ *                - 1 spi transfer failed
+ * @note          the reg of a write transfer must have bit 7 set
  */
-uint8_t pmw3901mb_stop_frame_capture(pmw3901mb_handle_t *handle)
+static uint8_t a_pmw3901mb_spi_transfer_batch(pmw3901mb_handle_t *handle, pmw3901mb_transfer_t *transfer, uint16_t num)
 {
-    uint8_t res;
-    uint8_t cmd;
-    
-    if (handle == NULL)                                                      /* check handle */
-    {
-        return 2;                                                            /* return error */
-    }
-    if (handle->inited != 1)                                                 /* check handle initialization */
-    {
-        return 3;                                                            /* return error */
-    }
+    uint16_t i;
     
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
-    }
-    cmd = 0x11;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x4D, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
-    }
-    cmd = 0x80;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x40, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
-    }
-    cmd = 0x80;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x55, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
-    }
-    cmd = 0x08;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (num == 0)                                                                                  /* check num */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
-    }
-    cmd = 0x18;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x6A, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 0;                                                                                  /* success return 0 */
     }
-    cmd = 0x07;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->stats != NULL)                                                                     /* check stats */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        handle->stats->spi_batch++;                                                                /* spi batch++ */
+        for (i = 0; i < num; i++)                                                                  /* count all */
+        {
+            if ((transfer[i].reg & 0x80) != 0)                                                     /* write */
+            {
+                handle->stats->spi_write++;                                                        /* spi write++ */
+                handle->stats->write_bytes += transfer[i].len;                                     /* add write bytes */
+            }
+            else
+            {
+                handle->stats->spi_read++;                                                         /* spi read++ */
+                handle->stats->read_bytes += transfer[i].len;                                      /* add read bytes */
+            }
+        }
     }
-    cmd = 0x0D;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x41, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->spi_transfer_batch != NULL)                                                        /* check spi_transfer_batch */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        if (handle->spi_transfer_batch(transfer, num) != 0)                                        /* spi transfer batch */
+        {
+            a_pmw3901mb_stats_spi_error(handle);                                                   /* spi error++ */
+            for (i = 0; i < num; i++)                                                              /* record all */
+            {
+                a_pmw3901mb_trace_record(handle, transfer[i].reg, transfer[i].buf,
+                                         transfer[i].len, 1);                                      /* record the transfer */
+            }
+            a_pmw3901mb_shadow_clear(handle);                                                      /* the chip state is unknown */
+            
+            return 1;                                                                              /* return error */
+        }
     }
-    cmd = 0x80;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x4C, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    else
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        for (i = 0; i < num; i++)                                                                  /* transfer one by one */
+        {
+            if ((transfer[i].reg & 0x80) != 0)                                                     /* write */
+            {
+                if (handle->spi_write(transfer[i].reg, transfer[i].buf, transfer[i].len) != 0)     /* spi write */
+                {
+                    a_pmw3901mb_stats_spi_error(handle);                                           /* spi error++ */
+                    a_pmw3901mb_trace_record(handle, transfer[i].reg, transfer[i].buf,
+                                             transfer[i].len, 1);                                  /* record the transfer */
+                    a_pmw3901mb_shadow_clear(handle);                                              /* the chip state is unknown */
+                    
+                    return 1;                                                                      /* return error */
+                }
+                if (handle->delay_us != NULL)                                                      /* check delay_us */
+                {
+                    handle->delay_us(PMW3901MB_TIMING_TSWW_US);                                    /* wait tsww */
+                }
+            }
+            else
+            {
+                if (handle->spi_read(transfer[i].reg, transfer[i].buf, transfer[i].len) != 0)      /* spi read */
+                {
+                    a_pmw3901mb_stats_spi_error(handle);                                           /* spi error++ */
+                    a_pmw3901mb_trace_record(handle, transfer[i].reg, transfer[i].buf,
+                                             transfer[i].len, 1);                                  /* record the transfer */
+                    
+                    return 1;                                                                      /* return error */
+                }
+                if (handle->delay_us != NULL)                                                      /* check delay_us */
+                {
+                    handle->delay_us(PMW3901MB_TIMING_TSRW_US);                                    /* wait tsrw */
+                }
+            }
+        }
     }
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    for (i = 0; i < num; i++)                                                                      /* track the writes */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        a_pmw3901mb_trace_record(handle, transfer[i].reg, transfer[i].buf,
+                                 transfer[i].len, 0);                                              /* record the transfer */
+        if (((transfer[i].reg & 0x80) != 0) && (transfer[i].len != 0))                             /* write */
+        {
+            a_pmw3901mb_shadow_write(handle, transfer[i].reg & 0x7F,
+                                     transfer[i].buf[transfer[i].len - 1]);                        /* track the write */
+        }
     }
     
-    return 0;                                                                /* success return 0 */
+    return 0;                                                                                      /* success return 0 */
 }
 
 /**
- * @brief      get the frame
+ * @brief      run a register sequence until it needs a delay
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] **frame pointer to a frame buffer
+ * @param[in]  *seq pointer to a sequence table
+ * @param[in]  len sequence table length
+ * @param[in]  fine bool value, 1 polls the expect read in us inside the retry delay and 0 waits the whole delay
+ * @param[out] *wait_us pointer to a wait us buffer
  * @return     status code
  *             - 0 success
- *             - 1 get frame failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       0   1     2    ...   32   33   34 (byte)
- *             .    .    .    ...    .    .    .
- *             .    .    .    ...    .    .    .
- *             .    .    .    ...    .    .    .
- *             1190 1191 1192 ... 1222 1223 1224
+ *             - 1 run failed
+ * @note       the sequence state is kept in the handle, wait_us 0 means the sequence is finished,
+ *             the records from the retry point are run again only once per table retry delay
  */
-uint8_t pmw3901mb_get_frame(pmw3901mb_handle_t *handle, uint8_t frame[35][35])
+static uint8_t a_pmw3901mb_sequence_step(pmw3901mb_handle_t *handle, const pmw3901mb_sequence_t *seq, uint16_t len,
+                                         uint8_t fine, uint32_t *wait_us)
 {
     uint8_t res;
     uint8_t cmd;
-    uint8_t i, j;
-    uint32_t retry_times;
-    
-    if (handle == NULL)                                                                                    /* check handle */
-    {
-        return 2;                                                                                          /* return error */
-    }
-    if (handle->inited != 1)                                                                               /* check handle initialization */
-    {
-        return 3;                                                                                          /* return error */
-    }
-    
-    cmd = 0x00;                                                                                            /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x70, (uint8_t *)&cmd, 1);                                         /* sent the command */
-    if (res != 0)                                                                                          /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");                                      /* sent the command failed */
-       
-        return 1;                                                                                          /* return error */
-    }
-    cmd = 0xFF;                                                                                            /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x58, (uint8_t *)&cmd, 1);                                         /* sent the command */
-    if (res != 0)                                                                                          /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");                                      /* sent the command failed */
-       
-        return 1;                                                                                          /* return error */
-    }
-    
-    retry_times = 10;                                                                                      /* set retry times */
-    
-    start:
-    
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_RAW_DATA_GRAB_STATUS, (uint8_t *)&cmd, 1);            /* read grab status */
-    if (res != 0)                                                                                          /* check result */
-    {
-        handle->debug_print("pmw3901mb: read grab status failed.\n");                                      /* read grab status failed */
-       
-        return 1;                                                                                          /* return error */
-    }
-    if ((cmd & (1 << 7)) && (cmd & (1 << 6)))
-    {
-        for (i = 0; i < 35; i++)                                                                           /* 35 times */
+    uint8_t c1;
+    uint8_t c2;
+    uint8_t retry_times;
+    uint8_t retry_delay;
+    uint16_t retry_point;
+    uint16_t poll;
+    uint8_t bank;
+    uint8_t bank_valid;
+    uint16_t i;
+    uint16_t num;
+    uint8_t data[PMW3901MB_BATCH_MAX];
+    pmw3901mb_transfer_t transfer[PMW3901MB_BATCH_MAX];
+    
+    num = 0;                                                                         /* init batch num */
+    bank = handle->shadow_bank;                                                      /* load shadow bank */
+    bank_valid = handle->shadow_bank_valid & handle->shadow_enable;                  /* load shadow bank valid */
+    c1 = handle->seq_c1;                                                             /* load c1 */
+    c2 = handle->seq_c2;                                                             /* load c2 */
+    retry_times = handle->seq_retry_times;                                           /* load retry times */
+    retry_delay = handle->seq_retry_delay;                                           /* load retry delay */
+    retry_point = handle->seq_retry_point;                                           /* load retry point */
+    poll = handle->seq_poll;                                                         /* load poll */
+    i = handle->seq_index;                                                           /* load index */
+    while (i < len)                                                                  /* run all records */
+    {
+        switch (seq[i].op)
         {
-            for (j = 0; j < 35; j++)                                                                       /* 35 times */
+            case PMW3901MB_SEQ_WRITE :
+            case PMW3901MB_SEQ_WRITE_C1 :
+            case PMW3901MB_SEQ_WRITE_C2 :
             {
-                retry_times = 10;                                                                          /* set retry times */
-                
-                step1:
-                
-                res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_RAW_DATA_GRAB, (uint8_t *)&cmd, 1);       /* read grab data */
-                if (res != 0)                                                                              /* check result */
+                if (seq[i].op == PMW3901MB_SEQ_WRITE_C1)                             /* c1 */
                 {
-                    handle->debug_print("pmw3901mb: read grab data failed.\n");                            /* read grab data failed */
-                   
-                    return 1;                                                                              /* return error */
+                    cmd = c1;                                                        /* set c1 */
                 }
-                if ((cmd & (1 << 6)) != 0)                                                                 /* check flag */
+                else if (seq[i].op == PMW3901MB_SEQ_WRITE_C2)                        /* c2 */
                 {
-                    frame[i][j] = 0;                                                                       /* set 0 */
-                    frame[i][j] |= (cmd & 0x3F) << 2;                                                      /* upper 6 bits */
+                    cmd = c2;                                                        /* set c2 */
                 }
                 else
                 {
-                    retry_times--;                                                                         /* retry times-- */
-                    if (retry_times != 0)                                                                  /* check retry times */
-                    {
-                        handle->delay_ms(10);                                                              /* delay 10 ms */
-                        
-                        goto step1;                                                                        /* goto step1 */
-                    }
-                    else
+                    cmd = seq[i].value;                                              /* set the command */
+                }
+                a_pmw3901mb_image_record(handle, PMW3901MB_SEQ_WRITE,
+                                         seq[i].reg, cmd, 0);                        /* record the write */
+                if ((seq[i].reg != PMW3901MB_REG_BANK_SELECT) ||
+                    (bank_valid == 0) || (bank != cmd))                              /* skip the selected bank */
+                {
+                    if (seq[i].reg == PMW3901MB_REG_BANK_SELECT)                     /* bank select */
                     {
-                        handle->debug_print("pmw3901mb: read timeout.\n");                                 /* read timeout */
-                       
-                        return 4;                                                                          /* return error */
+                        bank = cmd;                                                  /* set bank */
+                        bank_valid = handle->shadow_enable;                          /* bank is known */
                     }
+                    data[num] = cmd;                                                 /* queue the command */
+                    transfer[num].reg = 0x80 | seq[i].reg;                           /* set the write reg */
+                    transfer[num].buf = &data[num];                                  /* set the buffer */
+                    transfer[num].len = 1;                                           /* set the length */
+                    num++;                                                           /* num++ */
+                }
+                i++;                                                                 /* next record */
+                if ((num < PMW3901MB_BATCH_MAX) && (i < len) &&
+                    ((seq[i].op == PMW3901MB_SEQ_WRITE) ||
+                     (seq[i].op == PMW3901MB_SEQ_WRITE_C1) ||
+                     (seq[i].op == PMW3901MB_SEQ_WRITE_C2)))                         /* next record is a write */
+                {
+                    break;                                                           /* keep queuing */
+                }
+                res = a_pmw3901mb_spi_transfer_batch(handle, transfer, num);         /* sent the commands */
+                if (res != 0)                                                        /* check result */
+                {
+                    handle->debug_print("pmw3901mb: sent the command failed.\n");    /* sent the command failed */
+                   
+                    return 1;                                                        /* return error */
                 }
-                retry_times = 10;                                                                          /* set 10 times */
+                num = 0;                                                             /* clear batch */
+                
+                break;
+            }
+            case PMW3901MB_SEQ_DELAY_MS :
+            {
+                a_pmw3901mb_image_record(handle, PMW3901MB_SEQ_DELAY_MS,
+                                         0, 0, seq[i].param);                        /* record the delay */
+                i++;                                                                 /* next record */
+                handle->seq_c1 = c1;                                                 /* save c1 */
+                handle->seq_c2 = c2;                                                 /* save c2 */
+                handle->seq_retry_times = retry_times;                               /* save retry times */
+                handle->seq_retry_delay = retry_delay;                               /* save retry delay */
+                handle->seq_retry_point = retry_point;                               /* save retry point */
+                handle->seq_poll = poll;                                             /* save poll */
+                handle->seq_index = i;                                               /* save index */
+                *wait_us = (uint32_t)seq[i - 1].param * 1000;                        /* wait param ms */
                 
-                step2:
+                return 0;                                                            /* success return 0 */
+            }
+            case PMW3901MB_SEQ_RETRY :
+            {
+                a_pmw3901mb_image_record(handle, PMW3901MB_SEQ_RETRY, 0,
+                                         seq[i].value, seq[i].param);                /* record the retry */
+                retry_times = seq[i].value;                                          /* set retry times */
+                retry_delay = seq[i].param;                                          /* set retry delay */
+                poll = 0;                                                            /* clear poll */
+                retry_point = i + 1;                                                 /* set retry point */
+                i++;                                                                 /* next record */
                 
-                res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_RAW_DATA_GRAB, (uint8_t *)&cmd, 1);       /* read grab data */
-                if (res != 0)                                                                              /* check result */
+                break;
+            }
+            case PMW3901MB_SEQ_EXPECT :
+            case PMW3901MB_SEQ_SKIP_IF_CLEAR :
+            case PMW3901MB_SEQ_SKIP_IF_NOT_EQUAL :
+            case PMW3901MB_SEQ_LOAD_C1 :
+            case PMW3901MB_SEQ_LOAD_C2 :
+            {
+                res = a_pmw3901mb_spi_read(handle, seq[i].reg, (uint8_t *)&cmd, 1);  /* read */
+                if (res != 0)                                                        /* check result */
                 {
-                    handle->debug_print("pmw3901mb: read grab data failed.\n");                            /* read grab data failed */
+                    handle->debug_print("pmw3901mb: read failed.\n");                /* read failed */
                    
-                    return 1;                                                                              /* return error */
+                    return 1;                                                        /* return error */
                 }
-                if ((cmd & (2 << 6)) != 0)                                                                 /* check flag */
+                if (seq[i].op == PMW3901MB_SEQ_EXPECT)                               /* expect */
                 {
-                    cmd = (cmd >> 2) & 0x3;                                                                /* get 2 bits */
-                    frame[i][j] = frame[i][j] | cmd;                                                       /* set the frame */
+                    if (cmd != seq[i].value)                                         /* check the result */
+                    {
+                        if ((fine != 0) && ((uint32_t)(poll + 1) * PMW3901MB_TIMING_SEQ_POLL_US <
+                                            (uint32_t)retry_delay * 1000))           /* check the retry delay */
+                        {
+                            poll++;                                                  /* poll the read again */
+                        }
+                        else if (retry_times != 0)                                   /* check retry times */
+                        {
+                            retry_times--;                                           /* retry times-- */
+                            poll = 0;                                                /* clear poll */
+                            i = retry_point;                                         /* retry */
+                            if (handle->image_capture != 0)                          /* check the capture */
+                            {
+                                handle->image_num = handle->image_retry;             /* drop the retried records */
+                                handle->image_full = 0;                              /* the records before fit */
+                            }
+                        }
+                        else
+                        {
+                            handle->debug_print("pmw3901mb: set failed.\n");         /* set failed */
+                           
+                            return 1;                                                /* return error */
+                        }
+                        handle->seq_c1 = c1;                                         /* save c1 */
+                        handle->seq_c2 = c2;                                         /* save c2 */
+                        handle->seq_retry_times = retry_times;                       /* save retry times */
+                        handle->seq_retry_delay = retry_delay;                       /* save retry delay */
+                        handle->seq_retry_point = retry_point;                       /* save retry point */
+                        handle->seq_poll = poll;                                     /* save poll */
+                        handle->seq_index = i;                                       /* save index */
+                        if (fine != 0)                                               /* check fine */
+                        {
+                            *wait_us = PMW3901MB_TIMING_SEQ_POLL_US;                 /* wait poll interval */
+                        }
+                        else
+                        {
+                            *wait_us = (uint32_t)retry_delay * 1000;                 /* wait retry delay */
+                        }
+                        
+                        return 0;                                                    /* success return 0 */
+                    }
+                    a_pmw3901mb_image_record(handle, PMW3901MB_SEQ_EXPECT, seq[i].reg,
+                                             seq[i].value, 0);                       /* record the expect */
                 }
-                else
+                else if (seq[i].op == PMW3901MB_SEQ_SKIP_IF_CLEAR)                   /* skip if clear */
                 {
-                    retry_times--;                                                                         /* retry times-- */
-                    if (retry_times != 0)                                                                  /* check retry times */
+                    if ((cmd & seq[i].value) == 0)                                   /* check bits */
                     {
-                        handle->delay_ms(10);                                                              /* delay 10 ms */
-                        
-                        goto step2;                                                                        /* goto step2 */
+                        i += seq[i].param;                                           /* skip records */
+                    }
+                }
+                else if (seq[i].op == PMW3901MB_SEQ_SKIP_IF_NOT_EQUAL)               /* skip if not equal */
+                {
+                    if (cmd != seq[i].value)                                         /* check value */
+                    {
+                        i += seq[i].param;                                           /* skip records */
+                    }
+                }
+                else if (seq[i].op == PMW3901MB_SEQ_LOAD_C1)                         /* load c1 */
+                {
+                    if (cmd <= 28)                                                   /* check c1 */
+                    {
+                        c1 = cmd + 14;                                               /* c1 = c1 + 14 */
                     }
                     else
                     {
-                        handle->debug_print("pmw3901mb: read timeout.\n");                                 /* read timeout */
-                       
-                        return 4;                                                                          /* return error */
+                        c1 = cmd + 11;                                               /* c1 = c1 + 11 */
+                    }
+                    if (c1 > 0x3F)                                                   /* check c1 */
+                    {
+                        c1 = 0x3F;                                                   /* max 0x3F */
                     }
                 }
+                else
+                {
+                    c2 = (uint8_t)(((uint32_t)cmd * 45) / 100);                      /* get c2 */
+                }
+                i++;                                                                 /* next record */
+                
+                break;
+            }
+            case PMW3901MB_SEQ_SKIP :
+            {
+                i += seq[i].param + 1;                                               /* skip records */
+                
+                break;
+            }
+            default :
+            {
+                handle->debug_print("pmw3901mb: sequence is invalid.\n");            /* sequence is invalid */
+               
+                return 1;                                                            /* return error */
             }
         }
-        
-        return 0;                                                                                          /* success return 0 */
     }
-    else
+    
+    handle->seq_index = i;                                                           /* save index */
+    *wait_us = 0;                                                                    /* finished */
+    
+    return 0;                                                                        /* success return 0 */
+}
+
+/**
+ * @brief     reset the register sequence state
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @note      none
+ */
+static void a_pmw3901mb_sequence_begin(pmw3901mb_handle_t *handle)
+{
+    handle->seq_index = 0;              /* init index */
+    handle->seq_retry_point = 0;        /* init retry point */
+    handle->seq_retry_times = 0;        /* init retry times */
+    handle->seq_retry_delay = 0;        /* init retry delay */
+    handle->seq_poll = 0;               /* init poll */
+    handle->seq_c1 = 0;                 /* init c1 */
+    handle->seq_c2 = 0;                 /* init c2 */
+}
+
+/**
+ * @brief     run a register sequence
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] *seq pointer to a sequence table
+ * @param[in] len sequence table length
+ * @return    status code
+ *            - 0 success
+ *            - 1 run failed
+ * @note      none
+ */
+static uint8_t a_pmw3901mb_run_sequence(pmw3901mb_handle_t *handle, const pmw3901mb_sequence_t *seq, uint16_t len)
+{
+    uint8_t res;
+    uint8_t fine;
+    uint32_t wait_us;
+    
+    fine = (handle->delay_us != NULL) ? 1 : 0;                                 /* poll in us if delay_us is linked */
+    a_pmw3901mb_sequence_begin(handle);                                        /* begin the sequence */
+    while (1)                                                                  /* run the sequence */
     {
-        retry_times--;                                                                                     /* retry times-- */
-        if (retry_times != 0)
+        res = a_pmw3901mb_sequence_step(handle, seq, len, fine, &wait_us);     /* run a step */
+        if (res != 0)                                                          /* check result */
         {
-            handle->delay_ms(10);                                                                          /* delay 10 ms */
-            
-            goto start;                                                                                    /* goto start */
+            return 1;                                                          /* return error */
         }
-        else
+        if (wait_us == 0)                                                      /* check finished */
         {
-            handle->debug_print("pmw3901mb: read timeout.\n");                                             /* read timeout */
-           
-            return 4;                                                                                      /* return error */
+            break;                                                             /* break */
         }
+        a_pmw3901mb_delay(handle, wait_us, wait_us / 1000);                    /* delay */
     }
+    
+    return 0;                                                                  /* success return 0 */
 }
 
 /**
- * @brief     set the optimum performance
+ * @brief     check the linked functions
  * @param[in] *handle pointer to a pmw3901mb handle structure
  * @return    status code
  *            - 0 success
- *            - 1 set optimum performance failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
+ *            - 3 linked functions is NULL
  * @note      none
  */
-uint8_t pmw3901mb_set_optimum_performance(pmw3901mb_handle_t *handle)
+static uint8_t a_pmw3901mb_check_link(pmw3901mb_handle_t *handle)
 {
-    uint8_t res;
-    uint8_t cmd;
-    uint8_t retry_times;
-    
-    if (handle == NULL)                                                      /* check handle */
-    {
-        return 2;                                                            /* return error */
-    }
-    if (handle->inited != 1)                                                 /* check handle initialization */
+    if (handle->debug_print == NULL)                                                     /* check debug_print */
     {
-        return 3;                                                            /* return error */
+        return 3;                                                                        /* return error */
     }
-    
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->spi_init == NULL)                                                        /* check spi_init */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: spi_init is null.\n");                           /* spi_init is null */
        
-        return 1;                                                            /* return error */
+        return 3;                                                                        /* return error */
     }
-    cmd = 0x01;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x55, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->spi_deinit == NULL)                                                      /* check spi_deinit */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: spi_deinit is null.\n");                         /* spi_deinit is null */
        
-        return 1;                                                            /* return error */
+        return 3;                                                                        /* return error */
     }
-    cmd = 0x07;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x50, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->spi_read == NULL)                                                        /* check spi_read */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: spi_read is null.\n");                           /* spi_read is null */
        
-        return 1;                                                            /* return error */
+        return 3;                                                                        /* return error */
     }
-    cmd = 0x0E;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->spi_write == NULL)                                                       /* check spi_write */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: spi_write is null.\n");                          /* spi_write is null */
        
-        return 1;                                                            /* return error */
+        return 3;                                                                        /* return error */
     }
-    
-    retry_times = 3;                                                         /* set retry times 3 */
-    
-    start:
-    
-    cmd = 0x10;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x43, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->reset_gpio_init == NULL)                                                 /* check reset_gpio_init */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: reset_gpio_init is null.\n");                    /* reset_gpio_init is null */
        
-        return 1;                                                            /* return error */
+        return 3;                                                                        /* return error */
     }
-    res = a_pmw3901mb_spi_read(handle, 0x47, (uint8_t *)&cmd, 1);            /* read */
-    if (res != 0)                                                            /* check result */
+    if (handle->reset_gpio_deinit == NULL)                                               /* check reset_gpio_deinit */
     {
-        handle->debug_print("pmw3901mb: read failed.\n");                    /* read failed */
+        handle->debug_print("pmw3901mb: reset_gpio_deinit is null.\n");                  /* reset_gpio_deinit is null */
        
-        return 1;                                                            /* return error */
+        return 3;                                                                        /* return error */
     }
-    if (cmd != 0x08)                                                         /* check the result */
+    if (handle->reset_gpio_write == NULL)                                                /* check reset_gpio_write */
     {
-        if (retry_times != 0)                                                /* check retry times */
-        {
-            retry_times--;                                                   /* retry times-- */
-            handle->delay_ms(100);                                           /* delay 100 ms */
-            
-            goto start;                                                      /* goto start */
-        }
-        else
-        {
-            handle->debug_print("pmw3901mb: set failed.\n");                 /* set failed */
-           
-            return 1;                                                        /* return error */
-        }
+        handle->debug_print("pmw3901mb: reset_gpio_write is null.\n");                   /* reset_gpio_write is null */
+       
+        return 3;                                                                        /* return error */
     }
-    res = a_pmw3901mb_spi_read(handle, 0x67, (uint8_t *)&cmd, 1);            /* read */
-    if (res != 0)                                                            /* check result */
+    if (handle->delay_ms == NULL)                                                        /* check delay_ms */
     {
-        handle->debug_print("pmw3901mb: read failed.\n");                    /* read failed */
+        handle->debug_print("pmw3901mb: delay_ms is null.\n");                           /* delay_ms is null */
        
-        return 1;                                                            /* return error */
+        return 3;                                                                        /* return error */
     }
-    if ((cmd & (1 << 7)) != 0)
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief initialize the chip
+ */
+static uint8_t a_pmw3901mb_init(pmw3901mb_handle_t *handle)
+{
+    uint8_t id;
+  
+    if (handle == NULL)                                                                  /* check handle */
     {
-        cmd = 0x04;                                                          /* set the command */
-        res = a_pmw3901mb_spi_write(handle, 0x48, (uint8_t *)&cmd, 1);       /* sent the command */
-        if (res != 0)                                                        /* check result */
-        {
-            handle->debug_print("pmw3901mb: sent the command failed.\n");    /* sent the command failed */
-           
-            return 1;                                                        /* return error */
-        }
+        return 2;                                                                        /* return error */
     }
-    else
+    if (a_pmw3901mb_check_link(handle) != 0)                                             /* check linked functions */
     {
-        cmd = 0x02;                                                          /* set the command */
-        res = a_pmw3901mb_spi_write(handle, 0x48, (uint8_t *)&cmd, 1);       /* sent the command */
-        if (res != 0)                                                        /* check result */
-        {
-            handle->debug_print("pmw3901mb: sent the command failed.\n");    /* sent the command failed */
-           
-            return 1;                                                        /* return error */
-        }
+        return 3;                                                                        /* return error */
     }
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    if (handle->spi_init() != 0)                                                         /* initialize spi bus */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: spi init failed.\n");                            /* spi init failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                        /* return error */
     }
-    cmd = 0x7B;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x51, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->reset_gpio_init() != 0)                                                  /* initialize gpio */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        handle->debug_print("pmw3901mb: gpio init failed.\n");                           /* gpio init failed */
+        (void)handle->spi_deinit();                                                      /* spi deinit */
+        
+        return 1;                                                                        /* return error */
     }
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x50, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    a_pmw3901mb_shadow_clear(handle);                                                    /* the chip is reset */
+    if (handle->reset_gpio_write(0) != 0)                                                /* write 0 */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        handle->debug_print("pmw3901mb: reset failed.\n");                               /* reset failed */
+        (void)handle->spi_deinit();                                                      /* spi deinit */
+        (void)handle->reset_gpio_deinit();                                               /* reset gpio deinit */
+        
+        return 5;                                                                        /* return error */
     }
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x55, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    a_pmw3901mb_delay(handle, PMW3901MB_TIMING_RESET_US, 10);                            /* delay reset pulse */
+    if (handle->reset_gpio_write(1) != 0)                                                /* write 1 */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        handle->debug_print("pmw3901mb: reset failed.\n");                               /* reset failed */
+        (void)handle->spi_deinit();                                                      /* spi deinit */
+        (void)handle->reset_gpio_deinit();                                               /* reset gpio deinit */
+        
+        return 5;                                                                        /* return error */
     }
-    cmd = 0x0E;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    a_pmw3901mb_delay(handle, PMW3901MB_TIMING_RESET_WAIT_US, 10);                       /* delay reset wait */
+    if (a_pmw3901mb_spi_read(handle, PMW3901MB_REG_PRODUCT_ID, (uint8_t *)&id, 1) != 0)  /* get product id */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: get product id failed.\n");                      /* get product id failed */
+        (void)handle->spi_deinit();                                                      /* spi deinit */
+        (void)handle->reset_gpio_deinit();                                               /* reset gpio deinit */
        
-        return 1;                                                            /* return error */
+        return 4;                                                                        /* return error */
     }
-    res = a_pmw3901mb_spi_read(handle, 0x73, (uint8_t *)&cmd, 1);            /* read */
-    if (res != 0)                                                            /* check result */
+    if (id != 0x49)                                                                      /* check id */
     {
-        handle->debug_print("pmw3901mb: read failed.\n");                    /* read failed */
+        handle->debug_print("pmw3901mb: id is invalid.\n");                              /* id is invalid */
+        (void)handle->spi_deinit();                                                      /* spi deinit */
+        (void)handle->reset_gpio_deinit();                                               /* reset gpio deinit */
        
-        return 1;                                                            /* return error */
+        return 4;                                                                        /* return error */
     }
-    if (cmd == 0x00)                                                         /* check status */
+    handle->frame_status = PMW3901MB_FRAME_STATUS_IDLE;                                  /* set frame idle */
+    handle->inited = 1;                                                                  /* flag finish initialization */
+    (void)pmw3901mb_odometry_reset(handle, 0x10000);                                     /* odometry at 1 m height */
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     initialize the chip
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi or gpio initialization failed
+ *            - 2 handle is NULL
+ *            - 3 linked functions is NULL
+ *            - 4 id is invalid
+ *            - 5 reset failed
+ * @note      none
+ */
+uint8_t pmw3901mb_init(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_init(handle);                                                         /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_INIT, start, res);                    /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief close the chip
+ */
+static uint8_t a_pmw3901mb_deinit(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t cmd;
+    
+    if (handle == NULL)                                                                    /* check handle */
     {
-        uint8_t c1;
-        uint8_t c2;
-        
-        res = a_pmw3901mb_spi_read(handle, 0x70, (uint8_t *)&c1, 1);         /* read */
-        if (res != 0)                                                        /* check result */
-        {
-            handle->debug_print("pmw3901mb: read failed.\n");                /* read failed */
-           
-            return 1;                                                        /* return error */
-        }
-        if (c1 <= 28)                                                        /* check c1 */
-        {
-            c1 = c1 + 14;                                                    /* c1 = c1 + 14 */
-        }
-        else
-        {
-            c1 = c1 + 11;                                                    /* c1 = c1 + 11 */
-        }
-        if (c1 > 0x3F)                                                       /* check c1 */
-        {
-            c1 = 0x3F;                                                       /* max 0x3F */
-        }
-        res = a_pmw3901mb_spi_read(handle, 0x71, (uint8_t *)&c2, 1);         /* read */
-        if (res != 0)                                                        /* check result */
-        {
-            handle->debug_print("pmw3901mb: read failed.\n");                /* read failed */
-           
-            return 1;                                                        /* return error */
-        }
-        c2 = (uint8_t)(((uint32_t)c2 * 45) / 100);                           /* get c2 */
-        cmd = 0x00;                                                          /* set the command */
-        res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);       /* sent the command */
-        if (res != 0)                                                        /* check result */
-        {
-            handle->debug_print("pmw3901mb: sent the command failed.\n");    /* sent the command failed */
-           
-            return 1;                                                        /* return error */
-        }
-        cmd = 0xAD;                                                          /* set the command */
-        res = a_pmw3901mb_spi_write(handle, 0x61, (uint8_t *)&cmd, 1);       /* sent the command */
-        if (res != 0)                                                        /* check result */
-        {
-            handle->debug_print("pmw3901mb: sent the command failed.\n");    /* sent the command failed */
-           
-            return 1;                                                        /* return error */
-        }
-        cmd = 0x70;                                                          /* set the command */
-        res = a_pmw3901mb_spi_write(handle, 0x51, (uint8_t *)&cmd, 1);       /* sent the command */
-        if (res != 0)                                                        /* check result */
-        {
-            handle->debug_print("pmw3901mb: sent the command failed.\n");    /* sent the command failed */
-           
-            return 1;                                                        /* return error */
-        }
-        cmd = 0x0E;                                                          /* set the command */
-        res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);       /* sent the command */
-        if (res != 0)                                                        /* check result */
-        {
-            handle->debug_print("pmw3901mb: sent the command failed.\n");    /* sent the command failed */
-           
-            return 1;                                                        /* return error */
-        }
-        cmd = c1;                                                            /* set the command */
-        res = a_pmw3901mb_spi_write(handle, 0x70, (uint8_t *)&cmd, 1);       /* sent the command */
-        if (res != 0)                                                        /* check result */
-        {
-            handle->debug_print("pmw3901mb: sent the command failed.\n");    /* sent the command failed */
-           
-            return 1;                                                        /* return error */
-        }
-        cmd = c2;                                                            /* set the command */
-        res = a_pmw3901mb_spi_write(handle, 0x71, (uint8_t *)&cmd, 1);       /* sent the command */
-        if (res != 0)                                                        /* check result */
-        {
-            handle->debug_print("pmw3901mb: sent the command failed.\n");    /* sent the command failed */
-           
-            return 1;                                                        /* return error */
-        }
-    }
-    
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
-    }
-    cmd = 0xAD;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x61, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
-    }
-    cmd = 0x03;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                                          /* return error */
     }
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x40, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->inited != 1)                                                               /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                                          /* return error */
     }
-    cmd = 0x05;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    cmd = 0xB6;                                                                            /* shutdown command */
+    res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_SHUTDOWN, (uint8_t *)&cmd, 1);       /* set shutdown reset */
+    if (res != 0)                                                                          /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: power down failed.\n");                            /* power down failed */
        
-        return 1;                                                            /* return error */
+        return 4;                                                                          /* return error */
     }
-    cmd = 0xB3;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x41, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    res = handle->spi_deinit();                                                            /* spi deinit */
+    if (res != 0)                                                                          /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: spi deinit failed.\n");                            /* spi deinit failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                          /* return error */
     }
-    cmd = 0xF1;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x43, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    res = handle->reset_gpio_deinit();                                                     /* reset gpio deinit */
+    if (res != 0)                                                                          /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: gpio deinit failed.\n");                           /* gpio deinit failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                          /* return error */
     }
-    cmd = 0x14;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x45, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    handle->inited = 0;                                                                    /* flag close */
+    
+    return 0;                                                                              /* success return 0 */
+}
+
+/**
+ * @brief     close the chip
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 spi or gpio deinit failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 power down failed
+ * @note      none
+ */
+uint8_t pmw3901mb_deinit(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_deinit(handle);                                                       /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_DEINIT, start, res);                  /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief     stop a failed boot
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @note      none
+ */
+static void a_pmw3901mb_boot_stop(pmw3901mb_handle_t *handle)
+{
+    (void)handle->spi_deinit();                                  /* spi deinit */
+    (void)handle->reset_gpio_deinit();                           /* reset gpio deinit */
+    handle->inited = 0;                                          /* flag close */
+    handle->boot_state = PMW3901MB_BOOT_STATE_IDLE;              /* set idle */
+    if (handle->image_capture != 0)                              /* check the capture */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        (void)a_pmw3901mb_image_end(handle, 0);                  /* drop the capture */
     }
-    cmd = 0x32;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x5B, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+}
+
+/**
+ * @brief begin a non-blocking boot
+ */
+static uint8_t a_pmw3901mb_boot_begin(pmw3901mb_handle_t *handle, uint32_t *wait_us)
+{
+    if (handle == NULL)                                                   /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                         /* return error */
     }
-    cmd = 0x34;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x5F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (a_pmw3901mb_check_link(handle) != 0)                              /* check linked functions */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                         /* return error */
     }
-    cmd = 0x08;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7B, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    handle->inited = 0;                                                   /* flag not finished */
+    handle->boot_state = PMW3901MB_BOOT_STATE_IDLE;                       /* set idle */
+    if (handle->spi_init() != 0)                                          /* initialize spi bus */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: spi init failed.\n");             /* spi init failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                         /* return error */
     }
-    cmd = 0x06;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->reset_gpio_init() != 0)                                   /* initialize gpio */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        handle->debug_print("pmw3901mb: gpio init failed.\n");            /* gpio init failed */
+        (void)handle->spi_deinit();                                       /* spi deinit */
+        
+        return 1;                                                         /* return error */
     }
-    cmd = 0x1B;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x44, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    a_pmw3901mb_shadow_clear(handle);                                     /* the chip is reset */
+    if (handle->reset_gpio_write(0) != 0)                                 /* write 0 */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        handle->debug_print("pmw3901mb: reset failed.\n");                /* reset failed */
+        a_pmw3901mb_boot_stop(handle);                                    /* stop the boot */
+        
+        return 5;                                                         /* return error */
     }
-    cmd = 0xBF;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x40, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    handle->boot_state = PMW3901MB_BOOT_STATE_RESET_HIGH;                 /* release the reset next */
+    *wait_us = PMW3901MB_TIMING_RESET_US;                                 /* wait the reset pulse */
+    
+    return 0;                                                             /* success return 0 */
+}
+
+/**
+ * @brief      begin a non-blocking boot
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *wait_us pointer to a wait us buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 spi or gpio initialization failed
+ *             - 2 handle is NULL
+ *             - 3 linked functions is NULL
+ *             - 5 reset failed
+ * @note       the boot covers init, power up and set optimum performance,
+ *             call pmw3901mb_boot_step after at least wait_us until it is done
+ */
+uint8_t pmw3901mb_boot_begin(pmw3901mb_handle_t *handle, uint32_t *wait_us)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_boot_begin(handle, wait_us);                                          /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_BOOT_BEGIN, start, res);              /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief run the non-blocking boot until it needs a wait
+ */
+static uint8_t a_pmw3901mb_boot_step(pmw3901mb_handle_t *handle, uint32_t *wait_us, pmw3901mb_boot_status_t *status)
+{
+    uint8_t res;
+    uint8_t i;
+    uint8_t id;
+    uint8_t cmd;
+    uint8_t buf[5];
+    pmw3901mb_transfer_t transfer[5];
+    
+    if (handle == NULL)                                                                              /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                                                    /* return error */
     }
-    cmd = 0x3F;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x4E, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->boot_state == PMW3901MB_BOOT_STATE_IDLE)                                             /* check boot state */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 6;                                                                                    /* return error */
     }
-    cmd = 0x08;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    while (1)                                                                                        /* run the states */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        switch (handle->boot_state)
+        {
+            case PMW3901MB_BOOT_STATE_RESET_HIGH :
+            {
+                if (handle->reset_gpio_write(1) != 0)                                                /* write 1 */
+                {
+                    handle->debug_print("pmw3901mb: reset failed.\n");                               /* reset failed */
+                    a_pmw3901mb_boot_stop(handle);                                                   /* stop the boot */
+                    
+                    return 5;                                                                        /* return error */
+                }
+                handle->boot_state = PMW3901MB_BOOT_STATE_CHECK_ID;                                  /* check id next */
+                *wait_us = PMW3901MB_TIMING_RESET_WAIT_US;                                           /* wait the reset */
+                *status = PMW3901MB_BOOT_STATUS_BUSY;                                                /* busy */
+                
+                return 0;                                                                            /* success return 0 */
+            }
+            case PMW3901MB_BOOT_STATE_CHECK_ID :
+            {
+                if (a_pmw3901mb_spi_read(handle, PMW3901MB_REG_PRODUCT_ID, (uint8_t *)&id, 1) != 0)  /* get product id */
+                {
+                    handle->debug_print("pmw3901mb: get product id failed.\n");                      /* get product id failed */
+                    a_pmw3901mb_boot_stop(handle);                                                   /* stop the boot */
+                    
+                    return 4;                                                                        /* return error */
+                }
+                if (id != 0x49)                                                                      /* check id */
+                {
+                    handle->debug_print("pmw3901mb: id is invalid.\n");                              /* id is invalid */
+                    a_pmw3901mb_boot_stop(handle);                                                   /* stop the boot */
+                    
+                    return 4;                                                                        /* return error */
+                }
+                handle->frame_status = PMW3901MB_FRAME_STATUS_IDLE;                                  /* set frame idle */
+                cmd = 0x5A;                                                                          /* power up command */
+                res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_POWER_UP_RESET, &cmd, 1);          /* set power up reset */
+                if (res != 0)                                                                        /* check result */
+                {
+                    handle->debug_print("pmw3901mb: set power up reset failed.\n");                  /* set power up reset failed */
+                    a_pmw3901mb_boot_stop(handle);                                                   /* stop the boot */
+                    
+                    return 1;                                                                        /* return error */
+                }
+                handle->boot_state = PMW3901MB_BOOT_STATE_CLEAR_MOTION;                              /* clear motion next */
+                *wait_us = PMW3901MB_TIMING_POWER_UP_US;                                             /* wait the power up */
+                *status = PMW3901MB_BOOT_STATUS_BUSY;                                                /* busy */
+                
+                return 0;                                                                            /* success return 0 */
+            }
+            case PMW3901MB_BOOT_STATE_CLEAR_MOTION :
+            {
+                transfer[0].reg = PMW3901MB_REG_MOTION;                                              /* motion */
+                transfer[1].reg = PMW3901MB_REG_DELTA_X_L;                                           /* delta x low */
+                transfer[2].reg = PMW3901MB_REG_DELTA_X_H;                                           /* delta x high */
+                transfer[3].reg = PMW3901MB_REG_DELTA_Y_L;                                           /* delta y low */
+                transfer[4].reg = PMW3901MB_REG_DELTA_Y_H;                                           /* delta y high */
+                for (i = 0; i < 5; i++)                                                              /* 5 times */
+                {
+                    transfer[i].buf = &buf[i];                                                       /* set the buffer */
+                    transfer[i].len = 1;                                                             /* set the length */
+                }
+                res = a_pmw3901mb_spi_transfer_batch(handle, transfer, 5);                           /* get command */
+                if (res != 0)                                                                        /* check result */
+                {
+                    handle->debug_print("pmw3901mb: get command failed.\n");                         /* get command failed */
+                    a_pmw3901mb_boot_stop(handle);                                                   /* stop the boot */
+                    
+                    return 1;                                                                        /* return error */
+                }
+                a_pmw3901mb_sequence_begin(handle);                                                  /* begin the sequence */
+                a_pmw3901mb_image_begin(handle);                                                     /* capture the image */
+                handle->boot_state = PMW3901MB_BOOT_STATE_OPTIMUM;                                   /* optimum next */
+                
+                break;
+            }
+            case PMW3901MB_BOOT_STATE_OPTIMUM :
+            {
+                res = a_pmw3901mb_sequence_step(handle, gsc_pmw3901mb_optimum_performance,
+                                                sizeof(gsc_pmw3901mb_optimum_performance) /
+                                                sizeof(pmw3901mb_sequence_t),
+                                                (handle->delay_us != NULL) ? 1 : 0, wait_us);        /* run a step as the blocking path */
+                if (res != 0)                                                                        /* check result */
+                {
+                    a_pmw3901mb_boot_stop(handle);                                                   /* stop the boot */
+                    
+                    return 1;                                                                        /* return error */
+                }
+                if (*wait_us != 0)                                                                   /* check the wait */
+                {
+                    *status = PMW3901MB_BOOT_STATUS_BUSY;                                            /* busy */
+                    
+                    return 0;                                                                        /* success return 0 */
+                }
+                res = a_pmw3901mb_image_end(handle, 1);                                              /* end the capture */
+                handle->inited = 1;                                                                  /* flag finish initialization */
+                (void)pmw3901mb_odometry_reset(handle, 0x10000);                                     /* odometry at 1 m height */
+                handle->boot_state = PMW3901MB_BOOT_STATE_IDLE;                                      /* set idle */
+                *status = PMW3901MB_BOOT_STATUS_DONE;                                                /* done */
+                if (res != 0)                                                                        /* check the image */
+                {
+                    return 7;                                                                        /* return error */
+                }
+                
+                return 0;                                                                            /* success return 0 */
+            }
+            default :
+            {
+                handle->debug_print("pmw3901mb: boot state is invalid.\n");                          /* boot state is invalid */
+                a_pmw3901mb_boot_stop(handle);                                                       /* stop the boot */
+                
+                return 1;                                                                            /* return error */
+            }
+        }
     }
-    cmd = 0x20;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x65, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+}
+
+/**
+ * @brief      run the non-blocking boot until it needs a wait
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *wait_us pointer to a wait us buffer
+ * @param[out] *status pointer to a boot status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 boot step failed
+ *             - 2 handle is NULL
+ *             - 4 id is invalid
+ *             - 5 reset failed
+ *             - 6 boot is not begun
+ *             - 7 register image is full
+ * @note       the step never sleeps, call it again after at least wait_us,
+ *             spi and gpio are closed when the boot fails, with 7 the boot is done
+ *             and only the resume image is dropped
+ */
+uint8_t pmw3901mb_boot_step(pmw3901mb_handle_t *handle, uint32_t *wait_us, pmw3901mb_boot_status_t *status)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_boot_step(handle, wait_us, status);                                   /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_BOOT_STEP, start, res);               /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief power up the chip
+ */
+static uint8_t a_pmw3901mb_power_up(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t cmd;
+    uint8_t i;
+    uint8_t buf[5];
+    pmw3901mb_transfer_t transfer[5];
+    
+    if (handle == NULL)                                                                          /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                                                /* return error */
     }
-    cmd = 0x18;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x6A, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->inited != 1)                                                                     /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                                                /* return error */
     }
-    cmd = 0x09;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    a_pmw3901mb_shadow_clear(handle);                                                            /* the chip is reset */
+    res = handle->reset_gpio_write(0);                                                           /* write 0 */
+    if (res != 0)                                                                                /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: set gpio failed.\n");                                    /* set gpio failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                                /* return error */
     }
-    cmd = 0xAF;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x4F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    a_pmw3901mb_delay(handle, PMW3901MB_TIMING_RESET_US, 10);                                    /* delay reset pulse */
+    res = handle->reset_gpio_write(1);                                                           /* write 1 */
+    if (res != 0)                                                                                /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: set gpio failed.\n");                                    /* set gpio failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                                /* return error */
     }
-    cmd = 0x40;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x5F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    a_pmw3901mb_delay(handle, PMW3901MB_TIMING_RESET_WAIT_US, 10);                               /* delay reset wait */
+    cmd = 0x5A;                                                                                  /* power up command */
+    res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_POWER_UP_RESET, (uint8_t *)&cmd, 1);       /* set power up reset */
+    if (res != 0)                                                                                /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: set power up reset failed.\n");                          /* set power up reset failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                                /* return error */
     }
-    cmd = 0x80;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x48, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    a_pmw3901mb_delay(handle, PMW3901MB_TIMING_POWER_UP_US, 10);                                 /* delay power up */
+    
+    transfer[0].reg = PMW3901MB_REG_MOTION;                                                      /* motion */
+    transfer[1].reg = PMW3901MB_REG_DELTA_X_L;                                                   /* delta x low */
+    transfer[2].reg = PMW3901MB_REG_DELTA_X_H;                                                   /* delta x high */
+    transfer[3].reg = PMW3901MB_REG_DELTA_Y_L;                                                   /* delta y low */
+    transfer[4].reg = PMW3901MB_REG_DELTA_Y_H;                                                   /* delta y high */
+    for (i = 0; i < 5; i++)                                                                      /* 5 times */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        transfer[i].buf = &buf[i];                                                               /* set the buffer */
+        transfer[i].len = 1;                                                                     /* set the length */
     }
-    cmd = 0x80;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x49, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    res = a_pmw3901mb_spi_transfer_batch(handle, transfer, 5);                                   /* get command */
+    if (res != 0)                                                                                /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: get command failed.\n");                                 /* get command failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                                /* return error */
     }
-    cmd = 0x77;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x57, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
-    {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
-    }
-    cmd = 0x78;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x60, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    return 0;                                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     power up the chip
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 power up failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t pmw3901mb_power_up(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_power_up(handle);                                                     /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_POWER_UP, start, res);                /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief         decode a burst profile prefix
+ * @param[in]     profile burst profile
+ * @param[in,out] *motion pointer to a motion structure
+ * @note          only the fields inside the profile are written
+ */
+static void a_pmw3901mb_burst_decode(pmw3901mb_burst_profile_t profile, pmw3901mb_motion_t *motion)
+{
+    if ((motion->raw[0] & (1 << 7)) != 0)                                                             /* check motion flag */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        if (((profile >= PMW3901MB_BURST_PROFILE_SQUAL) && (motion->raw[6] < 0x19)) ||                /* check data */
+            ((profile == PMW3901MB_BURST_PROFILE_FULL) && (motion->raw[10] == 0x1F)))
+        {
+            motion->is_valid = 2;                                                                     /* set invalid */
+            
+            return;                                                                                   /* return */
+        }
+        motion->delta_x = (int16_t)(((uint16_t)motion->raw[3] << 8) | motion->raw[2]);                /* set delta_x */
+        motion->delta_y = (int16_t)(((uint16_t)motion->raw[5] << 8) | motion->raw[4]);                /* set delta_y */
+        motion->observation = motion->raw[1] & 0x3F;                                                  /* set observation */
+        if (profile >= PMW3901MB_BURST_PROFILE_SQUAL)                                                 /* check squal */
+        {
+            motion->surface_quality = motion->raw[6] * 4;                                             /* set surface quality */
+        }
+        if (profile == PMW3901MB_BURST_PROFILE_FULL)                                                  /* check full */
+        {
+            motion->raw_average = motion->raw[7];                                                     /* set raw average */
+            motion->raw_max = motion->raw[8];                                                         /* set raw max */
+            motion->raw_min = motion->raw[9];                                                         /* set raw min */
+            motion->shutter = (((((uint16_t)motion->raw[10] & 0x1F) << 8)) | motion->raw[11]);        /* set shutter */
+        }
+        
+        motion->is_valid = 1;                                                                         /* set valid */
     }
-    cmd = 0x78;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x61, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    else
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        motion->is_valid = 0;                                                                         /* set invalid */
     }
-    cmd = 0x08;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x62, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+}
+
+/**
+ * @brief      burst read a profile prefix
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[in]  profile burst profile
+ * @param[out] *motion pointer to a motion structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 burst read failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 profile is invalid
+ * @note       none
+ */
+static uint8_t a_pmw3901mb_burst_read(pmw3901mb_handle_t *handle, pmw3901mb_burst_profile_t profile, pmw3901mb_motion_t *motion)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                               /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                                                     /* return error */
     }
-    cmd = 0x50;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x63, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->inited != 1)                                                                          /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                                                     /* return error */
     }
-    cmd = 0x0A;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if ((profile != PMW3901MB_BURST_PROFILE_MOTION) &&                                                /* check profile */
+        (profile != PMW3901MB_BURST_PROFILE_SQUAL) &&
+        (profile != PMW3901MB_BURST_PROFILE_FULL))
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: profile is invalid.\n");                                     /* profile is invalid */
        
-        return 1;                                                            /* return error */
+        return 4;                                                                                     /* return error */
     }
-    cmd = 0x60;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x45, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    if (handle->get_timestamp_us != NULL)                                                             /* check get_timestamp_us */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        motion->timestamp_us = handle->get_timestamp_us();                                            /* stamp the transaction */
     }
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    else
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        motion->timestamp_us = 0;                                                                     /* no timestamp */
     }
-    cmd = 0x11;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x4D, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_MOTION_BURST, (uint8_t *)motion->raw,
+                               (uint16_t)profile);                                                    /* burst read */
+    if (res != 0)                                                                                     /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: burst read failed.\n");                                       /* burst read failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                                     /* return error */
     }
-    cmd = 0x80;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x55, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    a_pmw3901mb_burst_decode(profile, motion);                                                        /* decode */
+    
+    return 0;                                                                                         /* success return 0 */
+}
+
+/**
+ * @brief     count the burst validity
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] *motion pointer to a motion structure
+ * @note      none
+ */
+static void a_pmw3901mb_stats_burst(pmw3901mb_handle_t *handle, pmw3901mb_motion_t *motion)
+{
+    if (handle->stats == NULL)                                                              /* check stats */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return;                                                                             /* return */
     }
-    cmd = 0x1F;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x74, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (motion->is_valid == 0)                                                              /* no motion */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        handle->stats->burst_invalid++;                                                     /* burst invalid++ */
     }
-    cmd = 0x1F;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x75, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    else if (motion->is_valid == 2)                                                         /* inner errors */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        handle->stats->burst_error++;                                                       /* burst error++ */
     }
-    cmd = 0x78;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x4A, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    else
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        /* valid */
     }
-    cmd = 0x78;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x4B, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+}
+
+/**
+ * @brief      burst read data
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *motion pointer to a motion structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 burst read failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t pmw3901mb_burst_read(pmw3901mb_handle_t *handle, pmw3901mb_motion_t *motion)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_burst_read(handle, PMW3901MB_BURST_PROFILE_FULL, motion);             /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_BURST_READ, start, res);              /* stats end */
+    if (res == 0)                                                                           /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        a_pmw3901mb_stats_burst(handle, motion);                                            /* count the validity */
     }
-    cmd = 0x08;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x44, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief      burst read a profile prefix
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[in]  profile burst profile
+ * @param[out] *motion pointer to a motion structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 burst read failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 profile is invalid
+ * @note       only the first profile bytes are read and decoded, the other raw bytes and fields are not touched,
+ *             the surface quality check runs from the squal profile and the shutter check in the full profile
+ */
+uint8_t pmw3901mb_burst_read_profile(pmw3901mb_handle_t *handle, pmw3901mb_burst_profile_t profile, pmw3901mb_motion_t *motion)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_burst_read(handle, profile, motion);                                  /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_BURST_READ_PROFILE, start, res);      /* stats end */
+    if (res == 0)                                                                           /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        a_pmw3901mb_stats_burst(handle, motion);                                            /* count the validity */
     }
-    cmd = 0x50;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x45, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief burst read many samples
+ */
+static uint8_t a_pmw3901mb_burst_read_many(pmw3901mb_handle_t *handle, pmw3901mb_motion_t *samples, uint32_t n, uint32_t period_us)
+{
+    uint32_t i;
+    uint64_t now;
+    uint64_t deadline;
+    
+    if (handle == NULL)                                                                               /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                                                     /* return error */
     }
-    cmd = 0xFF;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x64, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->inited != 1)                                                                          /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                                                     /* return error */
     }
-    cmd = 0x1F;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x65, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if ((samples == NULL) && (n != 0))                                                                /* check samples */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: samples is NULL.\n");                                         /* samples is NULL */
        
-        return 1;                                                            /* return error */
+        return 4;                                                                                     /* return error */
     }
-    cmd = 0x14;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    deadline = 0;                                                                                     /* init deadline */
+    for (i = 0; i < n; i++)                                                                           /* read all samples */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        if (handle->get_timestamp_us != NULL)                                                         /* check get_timestamp_us */
+        {
+            now = handle->get_timestamp_us();                                                         /* get now */
+            if ((i != 0) && (period_us != 0) && (now < deadline))                                     /* check the schedule */
+            {
+                a_pmw3901mb_delay(handle, (uint32_t)(deadline - now),
+                                  (uint32_t)((deadline - now + 999) / 1000));                         /* wait for the deadline */
+                now = handle->get_timestamp_us();                                                     /* get now */
+            }
+            deadline = ((i == 0) ? now : deadline) + period_us;                                       /* next deadline */
+        }
+        else
+        {
+            now = 0;                                                                                  /* no timestamp */
+            if ((i != 0) && (period_us != 0))                                                         /* check period */
+            {
+                a_pmw3901mb_delay(handle, period_us, (period_us + 999) / 1000);                       /* wait a period */
+            }
+        }
+        samples[i].timestamp_us = now;                                                                /* stamp the transaction */
+        if (a_pmw3901mb_spi_read(handle, PMW3901MB_REG_MOTION_BURST,
+                                 (uint8_t *)samples[i].raw, 12) != 0)                                 /* burst read */
+        {
+            handle->debug_print("pmw3901mb: burst read failed.\n");                                   /* burst read failed */
+           
+            return 1;                                                                                 /* return error */
+        }
+        a_pmw3901mb_burst_decode(PMW3901MB_BURST_PROFILE_FULL, &samples[i]);                          /* decode */
+        a_pmw3901mb_stats_burst(handle, &samples[i]);                                                 /* count the validity */
     }
-    cmd = 0x67;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x65, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    return 0;                                                                                         /* success return 0 */
+}
+
+/**
+ * @brief      burst read many samples
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *samples pointer to a motion array
+ * @param[in]  n sample number
+ * @param[in]  period_us sample period in us, 0 means back to back
+ * @return     status code
+ *             - 0 success
+ *             - 1 burst read failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 samples is NULL
+ * @note       the samples are read with the full profile, each one is stamped when get_timestamp_us is linked,
+ *             with a period the samples are paced from the first timestamp and late samples don't wait,
+ *             without get_timestamp_us the period is a plain delay between samples,
+ *             the samples before a failed read are kept
+ */
+uint8_t pmw3901mb_burst_read_many(pmw3901mb_handle_t *handle, pmw3901mb_motion_t *samples, uint32_t n, uint32_t period_us)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_burst_read_many(handle, samples, n, period_us);                       /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_BURST_READ_MANY, start, res);         /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief start frame capture
+ */
+static uint8_t a_pmw3901mb_start_frame_capture(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                  /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                                        /* return error */
     }
-    cmd = 0x08;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x66, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->inited != 1)                                                             /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                                        /* return error */
     }
-    cmd = 0x70;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x63, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    res = a_pmw3901mb_run_sequence(handle, gsc_pmw3901mb_start_frame_capture,
+                                   sizeof(gsc_pmw3901mb_start_frame_capture) / sizeof(pmw3901mb_sequence_t));        /* run the sequence */
+    if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 1;                                                                        /* return error */
     }
-    cmd = 0x15;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     start frame capture
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 start frame capture failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t pmw3901mb_start_frame_capture(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_start_frame_capture(handle);                                          /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_START_FRAME_CAPTURE, start, res);     /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief stop frame capture
+ */
+static uint8_t a_pmw3901mb_stop_frame_capture(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                  /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                                        /* return error */
     }
-    cmd = 0x48;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x48, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->inited != 1)                                                             /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                                        /* return error */
     }
-    cmd = 0x07;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    res = a_pmw3901mb_run_sequence(handle, gsc_pmw3901mb_stop_frame_capture,
+                                   sizeof(gsc_pmw3901mb_stop_frame_capture) / sizeof(pmw3901mb_sequence_t));        /* run the sequence */
+    if (res != 0)                                                                        /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        return 1;                                                                        /* return error */
+    }
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     stop frame capture
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 stop frame capture failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t pmw3901mb_stop_frame_capture(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_stop_frame_capture(handle);                                           /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_STOP_FRAME_CAPTURE, start, res);      /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief     arm the raw data grab of the frame read
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] **frame pointer to a frame buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 frame begin failed
+ * @note      none
+ */
+static uint8_t a_pmw3901mb_frame_grab_begin(pmw3901mb_handle_t *handle, uint8_t frame[35][35])
+{
+    uint8_t res;
+    uint8_t buf[2];
+    pmw3901mb_transfer_t transfer[2];
+    
+    buf[0] = 0x00;                                                                    /* set the command */
+    buf[1] = 0xFF;                                                                    /* set the command */
+    transfer[0].reg = 0x80 | 0x70;                                                    /* set the reg */
+    transfer[0].buf = &buf[0];                                                        /* set the buffer */
+    transfer[0].len = 1;                                                              /* set the length */
+    transfer[1].reg = 0x80 | PMW3901MB_REG_RAW_DATA_GRAB;                             /* set the reg */
+    transfer[1].buf = &buf[1];                                                        /* set the buffer */
+    transfer[1].len = 1;                                                              /* set the length */
+    res = a_pmw3901mb_spi_transfer_batch(handle, transfer, 2);                        /* sent the command */
+    if (res != 0)                                                                     /* check result */
+    {
+        handle->debug_print("pmw3901mb: sent the command failed.\n");                 /* sent the command failed */
+        handle->frame_status = PMW3901MB_FRAME_STATUS_IDLE;                           /* set idle */
+       
+        return 1;                                                                     /* return error */
+    }
+    handle->frame = frame;                                                            /* set the frame */
+    handle->frame_pixel = 0;                                                          /* init pixel */
+    handle->frame_high = 0;                                                           /* no upper bits */
+    handle->frame_status = PMW3901MB_FRAME_STATUS_WAIT;                               /* wait for the status */
+    
+    return 0;                                                                         /* success return 0 */
+}
+
+/**
+ * @brief      read the raw data grab bytes of a frame read step
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[in]  budget max register reads in this step
+ * @param[out] *progress pointer to a progress buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 frame step failed
+ * @note       progress counts the accepted status and pixel bytes
+ */
+static uint8_t a_pmw3901mb_frame_grab_step(pmw3901mb_handle_t *handle, uint16_t budget, uint16_t *progress)
+{
+    uint8_t res;
+    uint8_t cmd;
+    uint16_t i;
+    uint16_t num;
+    uint8_t buf[PMW3901MB_FRAME_BATCH_MAX];
+    pmw3901mb_transfer_t transfer[PMW3901MB_FRAME_BATCH_MAX];
+    
+    *progress = 0;                                                                                         /* init progress */
+    while ((budget != 0) && (handle->frame_status != PMW3901MB_FRAME_STATUS_DONE))                         /* run the budget */
+    {
+        if (handle->frame_status == PMW3901MB_FRAME_STATUS_WAIT)                                           /* wait for the status */
+        {
+            res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_RAW_DATA_GRAB_STATUS, (uint8_t *)&cmd, 1);    /* read grab status */
+            if (res != 0)                                                                                  /* check result */
+            {
+                handle->debug_print("pmw3901mb: read grab status failed.\n");                              /* read grab status failed */
+                handle->frame_status = PMW3901MB_FRAME_STATUS_IDLE;                                        /* set idle */
+               
+                return 1;                                                                                  /* return error */
+            }
+            budget--;                                                                                      /* budget-- */
+            if (((cmd & (1 << 7)) == 0) || ((cmd & (1 << 6)) == 0))                                        /* check the status */
+            {
+                break;                                                                                     /* not ready */
+            }
+            handle->frame_status = PMW3901MB_FRAME_STATUS_READ;                                            /* read the pixels */
+            (*progress)++;                                                                                 /* progress++ */
+            
+            continue;                                                                                      /* next */
+        }
+        
+        num = (uint16_t)((35 * 35 - handle->frame_pixel) * 2 - handle->frame_high);                        /* remain bytes */
+        if (num > budget)                                                                                  /* check budget */
+        {
+            num = budget;                                                                                  /* set budget */
+        }
+        if (num > PMW3901MB_FRAME_BATCH_MAX)                                                               /* check num */
+        {
+            num = PMW3901MB_FRAME_BATCH_MAX;                                                               /* set max */
+        }
+        for (i = 0; i < num; i++)                                                                          /* num times */
+        {
+            transfer[i].reg = PMW3901MB_REG_RAW_DATA_GRAB;                                                 /* set the reg */
+            transfer[i].buf = &buf[i];                                                                     /* set the buffer */
+            transfer[i].len = 1;                                                                           /* set the length */
+        }
+        res = a_pmw3901mb_spi_transfer_batch(handle, transfer, num);                                       /* read grab data */
+        if (res != 0)                                                                                      /* check result */
+        {
+            handle->debug_print("pmw3901mb: read grab data failed.\n");                                    /* read grab data failed */
+            handle->frame_status = PMW3901MB_FRAME_STATUS_IDLE;                                            /* set idle */
+           
+            return 1;                                                                                      /* return error */
+        }
+        budget -= num;                                                                                     /* budget -= num */
+        
+        for (i = 0; i < num; i++)                                                                          /* check all bytes */
+        {
+            cmd = buf[i];                                                                                  /* get the byte */
+            if (handle->frame_high == 0)                                                                   /* upper 6 bits */
+            {
+                if ((cmd & (1 << 6)) != 0)                                                                 /* check flag */
+                {
+                    handle->frame[handle->frame_pixel / 35][handle->frame_pixel % 35] =
+                        (uint8_t)((cmd & 0x3F) << 2);                                                      /* upper 6 bits */
+                    handle->frame_high = 1;                                                                /* lower bits next */
+                    (*progress)++;                                                                         /* progress++ */
+                }
+            }
+            else                                                                                           /* lower 2 bits */
+            {
+                if ((cmd & (2 << 6)) != 0)                                                                 /* check flag */
+                {
+                    handle->frame[handle->frame_pixel / 35][handle->frame_pixel % 35] |= (cmd >> 2) & 0x3; /* set the frame */
+                    handle->frame_high = 0;                                                                /* upper bits next */
+                    handle->frame_pixel++;                                                                 /* next pixel */
+                    (*progress)++;                                                                         /* progress++ */
+                    if (handle->frame_pixel == 35 * 35)                                                    /* check the end */
+                    {
+                        handle->frame_status = PMW3901MB_FRAME_STATUS_DONE;                                /* done */
+                        
+                        break;                                                                             /* break */
+                    }
+                }
+            }
+        }
+        if (*progress == 0)                                                                                /* check progress */
+        {
+            break;                                                                                         /* not ready */
+        }
+    }
+    
+    return 0;                                                                                              /* success return 0 */
+}
+
+/**
+ * @brief get the frame
+ */
+static uint8_t a_pmw3901mb_get_frame(pmw3901mb_handle_t *handle, uint8_t frame[35][35])
+{
+    uint8_t res;
+    uint16_t progress;
+    uint32_t retry_times;
+    uint32_t retry_max;
+    
+    if (handle == NULL)                                                                  /* check handle */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if (handle->inited != 1)                                                             /* check handle initialization */
+    {
+        return 3;                                                                        /* return error */
+    }
+    
+    res = a_pmw3901mb_frame_grab_begin(handle, frame);                                   /* begin the frame */
+    if (res != 0)                                                                        /* check result */
+    {
+        return 1;                                                                        /* return error */
+    }
+    
+    if (handle->delay_us != NULL)                                                        /* check delay_us */
+    {
+        retry_max = PMW3901MB_TIMING_FRAME_TIMEOUT_US / PMW3901MB_TIMING_FRAME_POLL_US;  /* poll in us */
+    }
+    else
+    {
+        retry_max = 10;                                                                  /* poll in 10 ms */
+    }
+    retry_times = retry_max;                                                             /* set retry times */
+    while (handle->frame_status != PMW3901MB_FRAME_STATUS_DONE)                          /* read all pixels */
+    {
+        res = a_pmw3901mb_frame_grab_step(handle, PMW3901MB_FRAME_BATCH_MAX, &progress); /* run a step */
+        if (res != 0)                                                                    /* check result */
+        {
+            return 1;                                                                    /* return error */
+        }
+        if (progress != 0)                                                               /* check progress */
+        {
+            retry_times = retry_max;                                                     /* set retry times */
+        }
+        else
+        {
+            if (handle->stats != NULL)                                                   /* check stats */
+            {
+                handle->stats->frame_retry++;                                            /* frame retry++ */
+            }
+            retry_times--;                                                               /* retry times-- */
+            if (retry_times == 0)                                                        /* check retry times */
+            {
+                handle->debug_print("pmw3901mb: read timeout.\n");                       /* read timeout */
+                handle->frame_status = PMW3901MB_FRAME_STATUS_IDLE;                      /* set idle */
+               
+                return 4;                                                                /* return error */
+            }
+            a_pmw3901mb_delay(handle, PMW3901MB_TIMING_FRAME_POLL_US, 10);               /* delay poll interval */
+        }
+    }
+    handle->frame_status = PMW3901MB_FRAME_STATUS_IDLE;                                  /* set idle */
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief      get the frame
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] **frame pointer to a frame buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get frame failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       0   1     2    ...   32   33   34 (byte)
+ *             .    .    .    ...    .    .    .
+ *             .    .    .    ...    .    .    .
+ *             .    .    .    ...    .    .    .
+ *             1190 1191 1192 ... 1222 1223 1224
+ */
+uint8_t pmw3901mb_get_frame(pmw3901mb_handle_t *handle, uint8_t frame[35][35])
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_get_frame(handle, frame);                                             /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_GET_FRAME, start, res);               /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief begin a non-blocking frame read
+ */
+static uint8_t a_pmw3901mb_frame_begin(pmw3901mb_handle_t *handle, uint8_t frame[35][35])
+{
+    if (handle == NULL)                                     /* check handle */
+    {
+        return 2;                                           /* return error */
+    }
+    if (handle->inited != 1)                                /* check handle initialization */
+    {
+        return 3;                                           /* return error */
+    }
+    
+    return a_pmw3901mb_frame_grab_begin(handle, frame);     /* begin the frame */
+}
+
+/**
+ * @brief     begin a non-blocking frame read
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] **frame pointer to a frame buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 frame begin failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the frame capture must be started and the frame buffer must be kept until the frame is done
+ */
+uint8_t pmw3901mb_frame_begin(pmw3901mb_handle_t *handle, uint8_t frame[35][35])
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_frame_begin(handle, frame);                                           /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_FRAME_BEGIN, start, res);             /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief run a bounded step of the non-blocking frame read
+ */
+static uint8_t a_pmw3901mb_frame_step(pmw3901mb_handle_t *handle, uint16_t budget, pmw3901mb_frame_status_t *status, uint16_t *pixel)
+{
+    uint8_t res;
+    uint16_t progress;
+    
+    if (handle == NULL)                                                      /* check handle */
+    {
+        return 2;                                                            /* return error */
+    }
+    if (handle->inited != 1)                                                 /* check handle initialization */
+    {
+        return 3;                                                            /* return error */
+    }
+    if (handle->frame_status == PMW3901MB_FRAME_STATUS_IDLE)                 /* check frame status */
+    {
+        handle->debug_print("pmw3901mb: frame is not begun.\n");             /* frame is not begun */
        
+        return 4;                                                            /* return error */
+    }
+    
+    res = a_pmw3901mb_frame_grab_step(handle, budget, &progress);            /* run a step */
+    if (res != 0)                                                            /* check result */
+    {
         return 1;                                                            /* return error */
     }
-    cmd = 0x0D;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x41, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    *status = (pmw3901mb_frame_status_t)(handle->frame_status);              /* set the status */
+    *pixel = handle->frame_pixel;                                            /* set the pixel */
+    if (handle->frame_status == PMW3901MB_FRAME_STATUS_DONE)                 /* check done */
+    {
+        handle->frame_status = PMW3901MB_FRAME_STATUS_IDLE;                  /* set idle */
+    }
+    
+    return 0;                                                                /* success return 0 */
+}
+
+/**
+ * @brief      run a bounded step of the non-blocking frame read
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[in]  budget max register reads in this step
+ * @param[out] *status pointer to a frame status buffer
+ * @param[out] *pixel pointer to a finished pixels buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 frame step failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 frame is not begun
+ * @note       the step returns early when the sensor is not ready, the caller decides when to step again
+ *             and how long to wait before giving up
+ */
+uint8_t pmw3901mb_frame_step(pmw3901mb_handle_t *handle, uint16_t budget, pmw3901mb_frame_status_t *status, uint16_t *pixel)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_frame_step(handle, budget, status, pixel);                            /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_FRAME_STEP, start, res);              /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief set the optimum performance
+ */
+static uint8_t a_pmw3901mb_set_optimum_performance(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t full;
+    
+    if (handle == NULL)                                                                  /* check handle */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if (handle->inited != 1)                                                             /* check handle initialization */
+    {
+        return 3;                                                                        /* return error */
+    }
+    
+    a_pmw3901mb_image_begin(handle);                                                     /* capture the image */
+    res = a_pmw3901mb_run_sequence(handle, gsc_pmw3901mb_optimum_performance,
+                                   sizeof(gsc_pmw3901mb_optimum_performance) / sizeof(pmw3901mb_sequence_t));        /* run the sequence */
+    full = a_pmw3901mb_image_end(handle, (res == 0) ? 1 : 0);                            /* end the capture */
+    if (res != 0)                                                                        /* check result */
+    {
+        return 1;                                                                        /* return error */
+    }
+    if (full != 0)                                                                       /* check the image */
+    {
+        return 4;                                                                        /* return error */
+    }
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     set the optimum performance
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 set optimum performance failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 register image is full
+ * @note      with 4 the chip is set and only the resume image is dropped
+ */
+uint8_t pmw3901mb_set_optimum_performance(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_set_optimum_performance(handle);                                      /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_SET_OPTIMUM_PERFORMANCE, start, res); /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief resume the chip from the captured register image
+ */
+static uint8_t a_pmw3901mb_resume(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                  /* check handle */
+    {
+        return 2;                                                                        /* return error */
+    }
+    if (handle->inited != 1)                                                             /* check handle initialization */
+    {
+        return 3;                                                                        /* return error */
+    }
+    if (handle->image_num == 0)                                                          /* check the image */
+    {
+        handle->debug_print("pmw3901mb: no register image.\n");                          /* no register image */
+       
+        return 4;                                                                        /* return error */
+    }
+    
+    res = a_pmw3901mb_power_up(handle);                                                  /* power up */
+    if (res != 0)                                                                        /* check result */
+    {
+        return 1;                                                                        /* return error */
+    }
+    res = a_pmw3901mb_run_sequence(handle, handle->image, handle->image_num);            /* replay the image */
+    if (res != 0)                                                                        /* check result */
+    {
+        return 1;                                                                        /* return error */
+    }
+    
+    return 0;                                                                            /* success return 0 */
+}
+
+/**
+ * @brief     resume the chip from the captured register image
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 resume failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 no register image
+ * @note      the image is captured into the resume buffer by the last set optimum performance or boot,
+ *            a failed capture drops the image, the chip is powered up and the image replays the writes,
+ *            the delays and the handshake polls in the captured order with the branches already resolved
+ */
+uint8_t pmw3901mb_resume(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_resume(handle);                                                       /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_RESUME, start, res);                  /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief      get the product id
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *id pointer to an id buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get product id failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t pmw3901mb_get_product_id(pmw3901mb_handle_t *handle, uint8_t *id)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                   /* check handle */
+    {
+        return 2;                                                                         /* return error */
+    }
+    if (handle->inited != 1)                                                              /* check handle initialization */
+    {
+        return 3;                                                                         /* return error */
+    }
+    
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_PRODUCT_ID, (uint8_t *)id, 1);       /* get product id */
+    if (res != 0)                                                                         /* check result */
+    {
+        handle->debug_print("pmw3901mb: get product id failed.\n");                       /* get product id failed */
+       
+        return 1;                                                                         /* return error */
+    }
+    
+    return 0;                                                                             /* success return 0 */
+}
+
+/**
+ * @brief      get the inverse product id
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *id pointer to an id buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get inverse product id failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t pmw3901mb_get_inverse_product_id(pmw3901mb_handle_t *handle, uint8_t *id)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                           /* check handle */
+    {
+        return 2;                                                                                 /* return error */
+    }
+    if (handle->inited != 1)                                                                      /* check handle initialization */
+    {
+        return 3;                                                                                 /* return error */
+    }
+    
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_INVERSE_PRODUCT_ID, (uint8_t *)id, 1);       /* get inverse product id */
+    if (res != 0)                                                                                 /* check result */
+    {
+        handle->debug_print("pmw3901mb: get inverse product id failed.\n");                       /* get inverse product id failed */
+       
+        return 1;                                                                                 /* return error */
+    }
+    
+    return 0;                                                                                     /* success return 0 */
+}
+
+/**
+ * @brief      get the revision id
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *id pointer to an id buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get revision id failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t pmw3901mb_get_revision_id(pmw3901mb_handle_t *handle, uint8_t *id)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                    /* check handle */
+    {
+        return 2;                                                                          /* return error */
+    }
+    if (handle->inited != 1)                                                               /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                                          /* return error */
     }
-    cmd = 0x14;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x43, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_REVISION_ID, (uint8_t *)id, 1);       /* get revision id */
+    if (res != 0)                                                                          /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: get revision id failed.\n");                       /* get revision id failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                          /* return error */
     }
-    cmd = 0x0E;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x4B, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    return 0;                                                                              /* success return 0 */
+}
+
+/**
+ * @brief reset the chip
+ */
+static uint8_t a_pmw3901mb_reset(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t cmd;
+    
+    if (handle == NULL)                                                                          /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                                                /* return error */
     }
-    cmd = 0x0F;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x45, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->inited != 1)                                                                     /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                                                /* return error */
     }
-    cmd = 0x42;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x44, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    cmd = 0x5A;                                                                                  /* power up command */
+    res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_POWER_UP_RESET, (uint8_t *)&cmd, 1);       /* set power up reset */
+    if (res != 0)                                                                                /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: set power up reset failed.\n");                          /* set power up reset failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                                /* return error */
     }
-    cmd = 0x80;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x4C, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    return 0;                                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     reset the chip
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 reset failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t pmw3901mb_reset(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_reset(handle);                                                        /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_RESET, start, res);                   /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief shutdown the chip
+ */
+static uint8_t a_pmw3901mb_shutdown(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint8_t cmd;
+    
+    if (handle == NULL)                                                                    /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                                          /* return error */
     }
-    cmd = 0x10;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->inited != 1)                                                               /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                                          /* return error */
     }
-    cmd = 0x02;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x5B, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    cmd = 0xB6;                                                                            /* shutdown command */
+    res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_SHUTDOWN, (uint8_t *)&cmd, 1);       /* set shutdown reset */
+    if (res != 0)                                                                          /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: set shutdown failed.\n");                          /* set shutdown failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                          /* return error */
     }
-    cmd = 0x07;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    return 0;                                                                              /* success return 0 */
+}
+
+/**
+ * @brief     shutdown the chip
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 shutdown failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t pmw3901mb_shutdown(pmw3901mb_handle_t *handle)
+{
+    uint8_t res;
+    uint64_t start;
+    
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_shutdown(handle);                                                     /* run */
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_SHUTDOWN, start, res);                /* stats end */
+    
+    return res;                                                                             /* return the result */
+}
+
+/**
+ * @brief      get the motion
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *motion pointer to a motion buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get motion failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t pmw3901mb_get_motion(pmw3901mb_handle_t *handle, uint8_t *motion)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                   /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                                         /* return error */
     }
-    cmd = 0x41;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x40, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->inited != 1)                                                              /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                                         /* return error */
     }
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x70, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_MOTION, (uint8_t *)motion, 1);       /* get motion */
+    if (res != 0)                                                                         /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: get motion failed.\n");                           /* get motion failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                         /* return error */
     }
-    handle->delay_ms(10);                                                    /* delay 10 ms */
-    cmd = 0x44;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x32, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    return 0;                                                                             /* success return 0 */
+}
+
+/**
+ * @brief     set the motion
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] motion set motion
+ * @return    status code
+ *            - 0 success
+ *            - 1 set motion failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t pmw3901mb_set_motion(pmw3901mb_handle_t *handle, uint8_t motion)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                    /* check handle */
+    {
+        return 2;                                                                          /* return error */
+    }
+    if (handle->inited != 1)                                                               /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        return 3;                                                                          /* return error */
+    }
+    
+    res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_MOTION, (uint8_t *)&motion, 1);      /* set motion */
+    if (res != 0)                                                                          /* check result */
+    {
+        handle->debug_print("pmw3901mb: set motion failed.\n");                            /* set motion failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                          /* return error */
     }
-    cmd = 0x07;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    return 0;                                                                              /* success return 0 */
+}
+
+/**
+ * @brief      get the delta x
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *delta pointer to a delta buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get delta x failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t pmw3901mb_get_delta_x(pmw3901mb_handle_t *handle, int16_t *delta)
+{
+    uint8_t res;
+    uint8_t msb;
+    uint8_t lsb;
+    
+    if (handle == NULL)                                                                   /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        return 2;                                                                         /* return error */
+    }
+    if (handle->inited != 1)                                                              /* check handle initialization */
+    {
+        return 3;                                                                         /* return error */
+    }
+    
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_DELTA_X_L, (uint8_t *)&lsb, 1);      /* get delta xl */
+    if (res != 0)                                                                         /* check result */
+    {
+        handle->debug_print("pmw3901mb: get delta xl failed.\n");                         /* get delta xl failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                         /* return error */
     }
-    cmd = 0x40;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x40, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_DELTA_X_H, (uint8_t *)&msb, 1);      /* get delta xh */
+    if (res != 0)                                                                         /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: get delta xh failed.\n");                         /* get delta xh failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                         /* return error */
+    }
+    *delta = (int16_t)(((uint16_t)(msb) << 8) | lsb);                                     /* get delta */
+    
+    return 0;                                                                             /* success return 0 */
+}
+
+/**
+ * @brief      get the delta y
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *delta pointer to a delta buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get delta y failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t pmw3901mb_get_delta_y(pmw3901mb_handle_t *handle, int16_t *delta)
+{
+    uint8_t res;
+    uint8_t msb;
+    uint8_t lsb;
+    
+    if (handle == NULL)                                                                   /* check handle */
+    {
+        return 2;                                                                         /* return error */
+    }
+    if (handle->inited != 1)                                                              /* check handle initialization */
+    {
+        return 3;                                                                         /* return error */
     }
-    cmd = 0x06;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_DELTA_Y_L, (uint8_t *)&lsb, 1);      /* get delta yl */
+    if (res != 0)                                                                         /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: get delta yl failed.\n");                         /* get delta yl failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                         /* return error */
     }
-    cmd = 0xF0;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x62, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_DELTA_Y_H, (uint8_t *)&msb, 1);      /* get delta yh */
+    if (res != 0)                                                                         /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: get delta yh failed.\n");                         /* get delta yh failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                         /* return error */
     }
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x63, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    *delta = (int16_t)(((uint16_t)(msb) << 8) | lsb);                                     /* get delta */
+    
+    return 0;                                                                             /* success return 0 */
+}
+
+/**
+ * @brief      get the motion burst
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *burst pointer to a burst buffer
+ * @param[in]  len burst length
+ * @return     status code
+ *             - 0 success
+ *             - 1 get motion burst failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t pmw3901mb_get_motion_burst(pmw3901mb_handle_t *handle, uint8_t *burst, uint8_t len)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                        /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                                              /* return error */
     }
-    cmd = 0x0D;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->inited != 1)                                                                   /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                                              /* return error */
     }
-    cmd = 0xC0;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x48, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_MOTION_BURST, (uint8_t *)burst, len);     /* get motion burst */
+    if (res != 0)                                                                              /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: get motion burst failed.\n");                          /* get motion burst failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                              /* return error */
     }
-    cmd = 0xD5;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x6F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    return 0;                                                                                  /* success return 0 */
+}
+
+/**
+ * @brief      get the surface quality
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *squal pointer to a surface quality buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get squal failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t pmw3901mb_get_squal(pmw3901mb_handle_t *handle, uint8_t *squal)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                 /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                                       /* return error */
     }
-    cmd = 0x00;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x7F, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->inited != 1)                                                            /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                                       /* return error */
     }
-    cmd = 0xA0;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x5B, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_SQUAL, (uint8_t *)squal, 1);       /* get squal */
+    if (res != 0)                                                                       /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: get squal failed.\n");                          /* get squal failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                       /* return error */
     }
-    cmd = 0xA8;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x4E, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    return 0;                                                                           /* success return 0 */
+}
+
+/**
+ * @brief      get the average raw data value
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *sum pointer to a sum buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get raw data sum failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t pmw3901mb_get_raw_data_sum(pmw3901mb_handle_t *handle, uint8_t *sum)
+{
+    uint8_t res;
+    
+    if (handle == NULL)                                                                      /* check handle */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 2;                                                                            /* return error */
     }
-    cmd = 0x50;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x5A, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    if (handle->inited != 1)                                                                 /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
-       
-        return 1;                                                            /* return error */
+        return 3;                                                                            /* return error */
     }
-    cmd = 0x80;                                                              /* set the command */
-    res = a_pmw3901mb_spi_write(handle, 0x40, (uint8_t *)&cmd, 1);           /* sent the command */
-    if (res != 0)                                                            /* check result */
+    
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_RAW_DATA_SUM, (uint8_t *)sum, 1);       /* get sum */
+    if (res != 0)                                                                            /* check result */
     {
-        handle->debug_print("pmw3901mb: sent the command failed.\n");        /* sent the command failed */
+        handle->debug_print("pmw3901mb: get sum failed.\n");                                 /* get sum failed */
        
-        return 1;                                                            /* return error */
+        return 1;                                                                            /* return error */
     }
     
-    return 0;                                                                /* success return 0 */
+    return 0;                                                                                /* success return 0 */
 }
 
 /**
- * @brief      get the product id
+ * @brief      get the maximum raw data value
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *id pointer to an id buffer
+ * @param[out] *max pointer to a max buffer
  * @return     status code
  *             - 0 success
- *             - 1 get product id failed
+ *             - 1 get max raw data failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t pmw3901mb_get_product_id(pmw3901mb_handle_t *handle, uint8_t *id)
+uint8_t pmw3901mb_get_max_raw_data(pmw3901mb_handle_t *handle, uint8_t *max)
 {
     uint8_t res;
     
-    if (handle == NULL)                                                                   /* check handle */
+    if (handle == NULL)                                                                          /* check handle */
     {
-        return 2;                                                                         /* return error */
+        return 2;                                                                                /* return error */
     }
-    if (handle->inited != 1)                                                              /* check handle initialization */
+    if (handle->inited != 1)                                                                     /* check handle initialization */
     {
-        return 3;                                                                         /* return error */
+        return 3;                                                                                /* return error */
     }
     
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_PRODUCT_ID, (uint8_t *)id, 1);       /* get product id */
-    if (res != 0)                                                                         /* check result */
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_MAXIMUM_RAW_DATA, (uint8_t *)max, 1);       /* get maximum raw data */
+    if (res != 0)                                                                                /* check result */
     {
-        handle->debug_print("pmw3901mb: get product id failed.\n");                       /* get product id failed */
+        handle->debug_print("pmw3901mb: get maximum raw data failed.\n");                        /* get maximum raw data failed */
        
-        return 1;                                                                         /* return error */
+        return 1;                                                                                /* return error */
     }
     
-    return 0;                                                                             /* success return 0 */
+    return 0;                                                                                    /* success return 0 */
 }
 
 /**
- * @brief      get the inverse product id
+ * @brief      get the minimum raw data value
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *id pointer to an id buffer
+ * @param[out] *min pointer to a min buffer
  * @return     status code
  *             - 0 success
- *             - 1 get inverse product id failed
+ *             - 1 get min raw data failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t pmw3901mb_get_inverse_product_id(pmw3901mb_handle_t *handle, uint8_t *id)
+uint8_t pmw3901mb_get_min_raw_data(pmw3901mb_handle_t *handle, uint8_t *min)
 {
     uint8_t res;
     
-    if (handle == NULL)                                                                           /* check handle */
+    if (handle == NULL)                                                                          /* check handle */
     {
-        return 2;                                                                                 /* return error */
+        return 2;                                                                                /* return error */
     }
-    if (handle->inited != 1)                                                                      /* check handle initialization */
+    if (handle->inited != 1)                                                                     /* check handle initialization */
     {
-        return 3;                                                                                 /* return error */
+        return 3;                                                                                /* return error */
     }
     
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_INVERSE_PRODUCT_ID, (uint8_t *)id, 1);       /* get inverse product id */
-    if (res != 0)                                                                                 /* check result */
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_MINIMUM_RAW_DATA, (uint8_t *)min, 1);       /* get minimum raw data */
+    if (res != 0)                                                                                /* check result */
     {
-        handle->debug_print("pmw3901mb: get inverse product id failed.\n");                       /* get inverse product id failed */
+        handle->debug_print("pmw3901mb: get minimum raw data failed.\n");                        /* get minimum raw data failed */
        
-        return 1;                                                                                 /* return error */
+        return 1;                                                                                /* return error */
     }
     
-    return 0;                                                                                     /* success return 0 */
+    return 0;                                                                                    /* success return 0 */
 }
 
 /**
- * @brief      get the revision id
+ * @brief      get the shutter
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *id pointer to an id buffer
+ * @param[out] *shutter pointer to a shutter buffer
  * @return     status code
  *             - 0 success
- *             - 1 get revision id failed
+ *             - 1 get shutter failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t pmw3901mb_get_revision_id(pmw3901mb_handle_t *handle, uint8_t *id)
+uint8_t pmw3901mb_get_shutter(pmw3901mb_handle_t *handle, uint16_t *shutter)
 {
     uint8_t res;
+    uint8_t msb;
+    uint8_t lsb;
     
-    if (handle == NULL)                                                                    /* check handle */
+    if (handle == NULL)                                                                        /* check handle */
     {
-        return 2;                                                                          /* return error */
+        return 2;                                                                              /* return error */
     }
-    if (handle->inited != 1)                                                               /* check handle initialization */
+    if (handle->inited != 1)                                                                   /* check handle initialization */
     {
-        return 3;                                                                          /* return error */
+        return 3;                                                                              /* return error */
     }
     
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_REVISION_ID, (uint8_t *)id, 1);       /* get revision id */
-    if (res != 0)                                                                          /* check result */
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_SHUTTER_UPPER, (uint8_t *)&msb, 1);       /* get shutter upper */
+    if (res != 0)                                                                              /* check result */
     {
-        handle->debug_print("pmw3901mb: get revision id failed.\n");                       /* get revision id failed */
+        handle->debug_print("pmw3901mb: get shutter upper failed.\n");                         /* get shutter upper failed */
        
-        return 1;                                                                          /* return error */
+        return 1;                                                                              /* return error */
+    }
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_SHUTTER_LOWER, (uint8_t *)&lsb, 1);       /* get shutter lower */
+    if (res != 0)                                                                              /* check result */
+    {
+        handle->debug_print("pmw3901mb: get shutter lower failed.\n");                         /* get shutter lower failed */
+       
+        return 1;                                                                              /* return error */
     }
+    *shutter = (uint16_t)(((uint16_t)(msb & 0x1F) << 8) | lsb);                                /* get shutter */
     
-    return 0;                                                                              /* success return 0 */
+    return 0;                                                                                  /* success return 0 */
 }
 
 /**
- * @brief     reset the chip
- * @param[in] *handle pointer to a pmw3901mb handle structure
- * @return    status code
- *            - 0 success
- *            - 1 reset failed
- *            - 2 handle is NULL
- *            - 3 handle is not initialized
- * @note      none
+ * @brief      get the observation
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *observation pointer to an observation buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 get observation failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
  */
-uint8_t pmw3901mb_reset(pmw3901mb_handle_t *handle)
+uint8_t pmw3901mb_get_observation(pmw3901mb_handle_t *handle, uint8_t *observation)
 {
     uint8_t res;
-    uint8_t cmd;
     
-    if (handle == NULL)                                                                          /* check handle */
+    if (handle == NULL)                                                                             /* check handle */
     {
-        return 2;                                                                                /* return error */
+        return 2;                                                                                   /* return error */
     }
-    if (handle->inited != 1)                                                                     /* check handle initialization */
+    if (handle->inited != 1)                                                                        /* check handle initialization */
     {
-        return 3;                                                                                /* return error */
+        return 3;                                                                                   /* return error */
     }
     
-    cmd = 0x5A;                                                                                  /* power up command */
-    res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_POWER_UP_RESET, (uint8_t *)&cmd, 1);       /* set power up reset */
-    if (res != 0)                                                                                /* check result */
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_OBSERVATION, (uint8_t *)observation, 1);       /* get observation data */
+    if (res != 0)                                                                                   /* check result */
     {
-        handle->debug_print("pmw3901mb: set power up reset failed.\n");                          /* set power up reset failed */
+        handle->debug_print("pmw3901mb: get observation failed.\n");                                /* get observation failed */
        
-        return 1;                                                                                /* return error */
+        return 1;                                                                                   /* return error */
     }
+    *observation = (*observation) & 0x3F;                                                           /* set the observation */
     
-    return 0;                                                                                    /* success return 0 */
+    return 0;                                                                                       /* success return 0 */
 }
 
 /**
- * @brief     shutdown the chip
+ * @brief     set the observation
  * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] observation input observation
  * @return    status code
  *            - 0 success
- *            - 1 shutdown failed
+ *            - 1 set observation failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  * @note      none
  */
-uint8_t pmw3901mb_shutdown(pmw3901mb_handle_t *handle)
+uint8_t pmw3901mb_set_observation(pmw3901mb_handle_t *handle, uint8_t observation)
 {
     uint8_t res;
-    uint8_t cmd;
     
-    if (handle == NULL)                                                                    /* check handle */
+    if (handle == NULL)                                                                               /* check handle */
     {
-        return 2;                                                                          /* return error */
+        return 2;                                                                                     /* return error */
     }
-    if (handle->inited != 1)                                                               /* check handle initialization */
+    if (handle->inited != 1)                                                                          /* check handle initialization */
     {
-        return 3;                                                                          /* return error */
+        return 3;                                                                                     /* return error */
     }
     
-    cmd = 0xB6;                                                                            /* shutdown command */
-    res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_SHUTDOWN, (uint8_t *)&cmd, 1);       /* set shutdown reset */
-    if (res != 0)                                                                          /* check result */
+    res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_OBSERVATION, (uint8_t *)&observation, 1);       /* set observation data */
+    if (res != 0)                                                                                     /* check result */
     {
-        handle->debug_print("pmw3901mb: set shutdown failed.\n");                          /* set shutdown failed */
+        handle->debug_print("pmw3901mb: set observation failed.\n");                                  /* set observation failed */
        
-        return 1;                                                                          /* return error */
+        return 1;                                                                                     /* return error */
     }
     
-    return 0;                                                                              /* success return 0 */
+    return 0;                                                                                         /* success return 0 */
 }
 
 /**
- * @brief      get the motion
+ * @brief      get the raw data grab
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *motion pointer to a motion buffer
+ * @param[out] *grab pointer to a grab buffer
+ * @param[in]  len grab length
  * @return     status code
  *             - 0 success
- *             - 1 get motion failed
+ *             - 1 get raw data grab failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t pmw3901mb_get_motion(pmw3901mb_handle_t *handle, uint8_t *motion)
+uint8_t pmw3901mb_get_raw_data_grab(pmw3901mb_handle_t *handle, uint8_t *grab, uint16_t len)
 {
     uint8_t res;
+    uint16_t i;
+    uint16_t num;
+    pmw3901mb_transfer_t transfer[PMW3901MB_FRAME_BATCH_MAX];
     
-    if (handle == NULL)                                                                   /* check handle */
+    if (handle == NULL)                                                                                /* check handle */
     {
-        return 2;                                                                         /* return error */
+        return 2;                                                                                      /* return error */
     }
-    if (handle->inited != 1)                                                              /* check handle initialization */
+    if (handle->inited != 1)                                                                           /* check handle initialization */
     {
-        return 3;                                                                         /* return error */
+        return 3;                                                                                      /* return error */
     }
     
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_MOTION, (uint8_t *)motion, 1);       /* get motion */
-    if (res != 0)                                                                         /* check result */
+    while (len != 0)                                                                                   /* read all bytes */
     {
-        handle->debug_print("pmw3901mb: get motion failed.\n");                           /* get motion failed */
-       
-        return 1;                                                                         /* return error */
+        num = (len > PMW3901MB_FRAME_BATCH_MAX) ? PMW3901MB_FRAME_BATCH_MAX : len;                     /* set the batch num */
+        for (i = 0; i < num; i++)                                                                      /* num times */
+        {
+            transfer[i].reg = PMW3901MB_REG_RAW_DATA_GRAB;                                             /* set the reg */
+            transfer[i].buf = &grab[i];                                                                /* set the buffer */
+            transfer[i].len = 1;                                                                       /* set the length */
+        }
+        res = a_pmw3901mb_spi_transfer_batch(handle, transfer, num);                                   /* get raw data grab data */
+        if (res != 0)                                                                                  /* check result */
+        {
+            handle->debug_print("pmw3901mb: get raw data grab failed.\n");                             /* get raw data grab failed */
+           
+            return 1;                                                                                  /* return error */
+        }
+        grab += num;                                                                                   /* next batch */
+        len -= num;                                                                                    /* len -= num */
     }
     
-    return 0;                                                                             /* success return 0 */
+    return 0;                                                                                          /* success return 0 */
 }
 
 /**
- * @brief     set the motion
+ * @brief     set the raw data grab
  * @param[in] *handle pointer to a pmw3901mb handle structure
- * @param[in] motion set motion
+ * @param[in] *grab pointer to a raw data grab buffer
+ * @param[in] len grab length
  * @return    status code
  *            - 0 success
- *            - 1 set motion failed
+ *            - 1 set raw data grab failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
  * @note      none
  */
-uint8_t pmw3901mb_set_motion(pmw3901mb_handle_t *handle, uint8_t motion)
+uint8_t pmw3901mb_set_raw_data_grab(pmw3901mb_handle_t *handle, uint8_t *grab, uint16_t len)
 {
     uint8_t res;
+    uint16_t i;
     
-    if (handle == NULL)                                                                    /* check handle */
+    if (handle == NULL)                                                                                /* check handle */
     {
-        return 2;                                                                          /* return error */
+        return 2;                                                                                      /* return error */
     }
-    if (handle->inited != 1)                                                               /* check handle initialization */
+    if (handle->inited != 1)                                                                           /* check handle initialization */
     {
-        return 3;                                                                          /* return error */
+        return 3;                                                                                      /* return error */
     }
     
-    res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_MOTION, (uint8_t *)&motion, 1);      /* set motion */
-    if (res != 0)                                                                          /* check result */
+    for (i = 0; i < len; i++)                                                                          /* length times */
     {
-        handle->debug_print("pmw3901mb: set motion failed.\n");                            /* set motion failed */
-       
-        return 1;                                                                          /* return error */
+        res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_RAW_DATA_GRAB, (uint8_t *)&grab[i], 1);      /* set raw data grab */
+        if (res != 0)                                                                                  /* check result */
+        {
+            handle->debug_print("pmw3901mb: set raw data grab failed.\n");                             /* set raw data grab failed */
+           
+            return 1;                                                                                  /* return error */
+        }
     }
     
-    return 0;                                                                              /* success return 0 */
+    return 0;                                                                                          /* success return 0 */
 }
 
 /**
- * @brief      get the delta x
+ * @brief      get the raw data grab status
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *delta pointer to a delta buffer
+ * @param[out] *status pointer to a status buffer
  * @return     status code
  *             - 0 success
- *             - 1 get delta x failed
+ *             - 1 get raw data grab status failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t pmw3901mb_get_delta_x(pmw3901mb_handle_t *handle, int16_t *delta)
+uint8_t pmw3901mb_get_raw_data_grab_status(pmw3901mb_handle_t *handle, uint8_t *status)
 {
     uint8_t res;
-    uint8_t msb;
-    uint8_t lsb;
     
-    if (handle == NULL)                                                                   /* check handle */
+    if (handle == NULL)                                                                                 /* check handle */
     {
-        return 2;                                                                         /* return error */
+        return 2;                                                                                       /* return error */
     }
-    if (handle->inited != 1)                                                              /* check handle initialization */
+    if (handle->inited != 1)                                                                            /* check handle initialization */
     {
-        return 3;                                                                         /* return error */
+        return 3;                                                                                       /* return error */
     }
     
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_DELTA_X_L, (uint8_t *)&lsb, 1);      /* get delta xl */
-    if (res != 0)                                                                         /* check result */
-    {
-        handle->debug_print("pmw3901mb: get delta xl failed.\n");                         /* get delta xl failed */
-       
-        return 1;                                                                         /* return error */
-    }
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_DELTA_X_H, (uint8_t *)&msb, 1);      /* get delta xh */
-    if (res != 0)                                                                         /* check result */
+    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_RAW_DATA_GRAB_STATUS, (uint8_t *)status, 1);       /* get raw data grab status */
+    if (res != 0)                                                                                       /* check result */
     {
-        handle->debug_print("pmw3901mb: get delta xh failed.\n");                         /* get delta xh failed */
+        handle->debug_print("pmw3901mb: get raw data grab status failed.\n");                           /* get raw data grab status failed */
        
-        return 1;                                                                         /* return error */
+        return 1;                                                                                       /* return error */
     }
-    *delta = (int16_t)(((uint16_t)(msb) << 8) | lsb);                                     /* get delta */
     
-    return 0;                                                                             /* success return 0 */
+    return 0;                                                                                           /* success return 0 */
 }
 
 /**
- * @brief      get the delta y
+ * @brief      convert the delta raw to the delta cm
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *delta pointer to a delta buffer
+ * @param[in]  raw delta raw
+ * @param[in]  height_m height(m)
+ * @param[out] *cm pointer to a cm buffer
  * @return     status code
  *             - 0 success
- *             - 1 get delta y failed
+ *             - 1 delta raw to delta cm failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t pmw3901mb_get_delta_y(pmw3901mb_handle_t *handle, int16_t *delta)
+uint8_t pmw3901mb_delta_raw_to_delta_cm(pmw3901mb_handle_t *handle, int16_t raw, float height_m, float *cm)
 {
-    uint8_t res;
-    uint8_t msb;
-    uint8_t lsb;
-    
-    if (handle == NULL)                                                                   /* check handle */
+    if (handle == NULL)                                     /* check handle */
     {
-        return 2;                                                                         /* return error */
+        return 2;                                           /* return error */
     }
-    if (handle->inited != 1)                                                              /* check handle initialization */
+    if (handle->inited != 1)                                /* check handle initialization */
     {
-        return 3;                                                                         /* return error */
+        return 3;                                           /* return error */
     }
     
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_DELTA_Y_L, (uint8_t *)&lsb, 1);      /* get delta yl */
-    if (res != 0)                                                                         /* check result */
-    {
-        handle->debug_print("pmw3901mb: get delta yl failed.\n");                         /* get delta yl failed */
-       
-        return 1;                                                                         /* return error */
-    }
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_DELTA_Y_H, (uint8_t *)&msb, 1);      /* get delta yh */
-    if (res != 0)                                                                         /* check result */
-    {
-        handle->debug_print("pmw3901mb: get delta yh failed.\n");                         /* get delta yh failed */
-       
-        return 1;                                                                         /* return error */
-    }
-    *delta = (int16_t)(((uint16_t)(msb) << 8) | lsb);                                     /* get delta */
+    *cm = (float)(raw) * height_m / 11.914f * 2.54f;        /* convert */
     
-    return 0;                                                                             /* success return 0 */
+    return 0;                                               /* success return 0 */
 }
 
 /**
- * @brief      get the motion burst
+ * @brief      convert the delta raw array to the delta cm array
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *burst pointer to a burst buffer
- * @param[in]  len burst length
+ * @param[in]  *raw pointer to a delta raw array
+ * @param[in]  height_m height(m)
+ * @param[out] *cm pointer to a cm array
+ * @param[in]  len array length
  * @return     status code
  *             - 0 success
- *             - 1 get motion burst failed
+ *             - 1 delta raw to delta cm failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
- * @note       none
+ * @note       the scale is computed once for the whole array
  */
-uint8_t pmw3901mb_get_motion_burst(pmw3901mb_handle_t *handle, uint8_t *burst, uint8_t len)
+uint8_t pmw3901mb_delta_raw_to_delta_cm_batch(pmw3901mb_handle_t *handle, const int16_t *raw, float height_m,
+                                              float *cm, uint16_t len)
 {
-    uint8_t res;
+    uint16_t i;
+    float scale;
     
-    if (handle == NULL)                                                                        /* check handle */
+    if (handle == NULL)                                     /* check handle */
     {
-        return 2;                                                                              /* return error */
+        return 2;                                           /* return error */
     }
-    if (handle->inited != 1)                                                                   /* check handle initialization */
+    if (handle->inited != 1)                                /* check handle initialization */
     {
-        return 3;                                                                              /* return error */
+        return 3;                                           /* return error */
     }
     
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_MOTION_BURST, (uint8_t *)burst, len);     /* get motion burst */
-    if (res != 0)                                                                              /* check result */
+    scale = height_m * PMW3901MB_CM_PER_COUNT;              /* get the scale */
+    for (i = 0; i < len; i++)                               /* convert all */
     {
-        handle->debug_print("pmw3901mb: get motion burst failed.\n");                          /* get motion burst failed */
-       
-        return 1;                                                                              /* return error */
+        cm[i] = (float)(raw[i]) * scale;                    /* convert */
     }
     
-    return 0;                                                                                  /* success return 0 */
+    return 0;                                               /* success return 0 */
 }
 
 /**
- * @brief      get the surface quality
+ * @brief      get the q16.16 delta scale
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *squal pointer to a surface quality buffer
+ * @param[in]  height_m_q16 height(m) in q16.16
+ * @param[out] *scale_q16 pointer to a cm per count scale buffer in q16.16
  * @return     status code
  *             - 0 success
- *             - 1 get squal failed
+ *             - 1 get delta scale failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
- * @note       none
+ * @note       height_m_q16 can't be negative
  */
-uint8_t pmw3901mb_get_squal(pmw3901mb_handle_t *handle, uint8_t *squal)
+uint8_t pmw3901mb_get_delta_scale_q16(pmw3901mb_handle_t *handle, int32_t height_m_q16, int32_t *scale_q16)
 {
-    uint8_t res;
-    
-    if (handle == NULL)                                                                 /* check handle */
+    if (handle == NULL)                                                                       /* check handle */
     {
-        return 2;                                                                       /* return error */
+        return 2;                                                                             /* return error */
     }
-    if (handle->inited != 1)                                                            /* check handle initialization */
+    if (handle->inited != 1)                                                                  /* check handle initialization */
     {
-        return 3;                                                                       /* return error */
+        return 3;                                                                             /* return error */
     }
-    
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_SQUAL, (uint8_t *)squal, 1);       /* get squal */
-    if (res != 0)                                                                       /* check result */
+    if (height_m_q16 < 0)                                                                     /* check height */
     {
-        handle->debug_print("pmw3901mb: get squal failed.\n");                          /* get squal failed */
-       
-        return 1;                                                                       /* return error */
+        handle->debug_print("pmw3901mb: height is invalid.\n");                               /* height is invalid */
+        
+        return 1;                                                                             /* return error */
     }
     
-    return 0;                                                                           /* success return 0 */
+    *scale_q16 = (int32_t)(((int64_t)height_m_q16 * PMW3901MB_CM_PER_COUNT_Q32 +
+                            (1LL << 31)) >> 32);                                              /* round the scale */
+    
+    return 0;                                                                                 /* success return 0 */
 }
 
 /**
- * @brief      get the average raw data value
+ * @brief      convert the delta raw array to the q16.16 delta cm array
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *sum pointer to a sum buffer
+ * @param[in]  *raw pointer to a delta raw array
+ * @param[in]  height_m_q16 height(m) in q16.16
+ * @param[out] *cm_q16 pointer to a cm array in q16.16
+ * @param[in]  len array length
  * @return     status code
  *             - 0 success
- *             - 1 get raw data sum failed
+ *             - 1 delta raw to delta cm failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
- * @note       none
+ * @note       no float operation is used, the results saturate at the q16.16 range
  */
-uint8_t pmw3901mb_get_raw_data_sum(pmw3901mb_handle_t *handle, uint8_t *sum)
+uint8_t pmw3901mb_delta_raw_to_delta_cm_q16(pmw3901mb_handle_t *handle, const int16_t *raw, int32_t height_m_q16,
+                                            int32_t *cm_q16, uint16_t len)
 {
     uint8_t res;
+    uint16_t i;
+    int32_t scale;
+    int64_t cm;
     
-    if (handle == NULL)                                                                      /* check handle */
+    res = pmw3901mb_get_delta_scale_q16(handle, height_m_q16, &scale);      /* get the scale */
+    if (res != 0)                                                           /* check result */
     {
-        return 2;                                                                            /* return error */
+        return res;                                                         /* return error */
     }
-    if (handle->inited != 1)                                                                 /* check handle initialization */
+    
+    for (i = 0; i < len; i++)                                               /* convert all */
     {
-        return 3;                                                                            /* return error */
+        cm = (int64_t)raw[i] * scale;                                       /* convert */
+        if (cm > INT32_MAX)                                                 /* check max */
+        {
+            cm = INT32_MAX;                                                 /* set max */
+        }
+        else if (cm < INT32_MIN)                                            /* check min */
+        {
+            cm = INT32_MIN;                                                 /* set min */
+        }
+        cm_q16[i] = (int32_t)cm;                                            /* set the result */
     }
     
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_RAW_DATA_SUM, (uint8_t *)sum, 1);       /* get sum */
-    if (res != 0)                                                                            /* check result */
+    return 0;                                                               /* success return 0 */
+}
+
+/**
+ * @brief     reset the odometry
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] height_m_q16 height(m) in q16.16
+ * @return    status code
+ *            - 0 success
+ *            - 1 odometry reset failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the position and the checkpoint are cleared
+ */
+uint8_t pmw3901mb_odometry_reset(pmw3901mb_handle_t *handle, int32_t height_m_q16)
+{
+    uint8_t res;
+    
+    res = pmw3901mb_odometry_set_height(handle, height_m_q16);                   /* set the height */
+    if (res != 0)                                                                /* check result */
+    {
+        return res;                                                              /* return error */
+    }
+    handle->odometry_x_q16 = 0;                                                  /* clear x */
+    handle->odometry_y_q16 = 0;                                                  /* clear y */
+    handle->odometry_checkpoint_x_q16 = 0;                                       /* clear checkpoint x */
+    handle->odometry_checkpoint_y_q16 = 0;                                       /* clear checkpoint y */
+    
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     set the odometry height
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] height_m_q16 height(m) in q16.16
+ * @return    status code
+ *            - 0 success
+ *            - 1 set height failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the new height is used by the following samples
+ */
+uint8_t pmw3901mb_odometry_set_height(pmw3901mb_handle_t *handle, int32_t height_m_q16)
+{
+    uint8_t res;
+    int32_t scale;
+    
+    res = pmw3901mb_get_delta_scale_q16(handle, height_m_q16, &scale);          /* get the scale */
+    if (res != 0)                                                                /* check result */
     {
-        handle->debug_print("pmw3901mb: get sum failed.\n");                                 /* get sum failed */
-       
-        return 1;                                                                            /* return error */
+        return res;                                                              /* return error */
     }
+    handle->odometry_scale_q16 = scale;                                          /* set the scale */
     
-    return 0;                                                                                /* success return 0 */
+    return 0;                                                                    /* success return 0 */
 }
 
 /**
- * @brief      get the maximum raw data value
- * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *max pointer to a max buffer
- * @return     status code
- *             - 0 success
- *             - 1 get max raw data failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
+ * @brief     update the odometry with a motion sample
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] *motion pointer to a motion structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      only the valid samples are integrated
  */
-uint8_t pmw3901mb_get_max_raw_data(pmw3901mb_handle_t *handle, uint8_t *max)
+uint8_t pmw3901mb_odometry_update(pmw3901mb_handle_t *handle, const pmw3901mb_motion_t *motion)
 {
-    uint8_t res;
-    
-    if (handle == NULL)                                                                          /* check handle */
+    if (handle == NULL)                                                          /* check handle */
     {
-        return 2;                                                                                /* return error */
+        return 2;                                                                /* return error */
     }
-    if (handle->inited != 1)                                                                     /* check handle initialization */
+    if (handle->inited != 1)                                                     /* check handle initialization */
     {
-        return 3;                                                                                /* return error */
+        return 3;                                                                /* return error */
     }
     
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_MAXIMUM_RAW_DATA, (uint8_t *)max, 1);       /* get maximum raw data */
-    if (res != 0)                                                                                /* check result */
+    if (motion->is_valid == 1)                                                   /* check valid */
     {
-        handle->debug_print("pmw3901mb: get maximum raw data failed.\n");                        /* get maximum raw data failed */
-       
-        return 1;                                                                                /* return error */
+        handle->odometry_x_q16 += (int64_t)motion->delta_x *
+                                  handle->odometry_scale_q16;                    /* integrate x */
+        handle->odometry_y_q16 += (int64_t)motion->delta_y *
+                                  handle->odometry_scale_q16;                    /* integrate y */
     }
     
-    return 0;                                                                                    /* success return 0 */
+    return 0;                                                                    /* success return 0 */
 }
 
 /**
- * @brief      get the minimum raw data value
+ * @brief      burst read and update the odometry
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *min pointer to a min buffer
+ * @param[out] *motion pointer to a motion structure
  * @return     status code
  *             - 0 success
- *             - 1 get min raw data failed
+ *             - 1 burst read failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t pmw3901mb_get_min_raw_data(pmw3901mb_handle_t *handle, uint8_t *min)
+uint8_t pmw3901mb_odometry_burst_read(pmw3901mb_handle_t *handle, pmw3901mb_motion_t *motion)
 {
     uint8_t res;
+    uint64_t start;
     
-    if (handle == NULL)                                                                          /* check handle */
-    {
-        return 2;                                                                                /* return error */
-    }
-    if (handle->inited != 1)                                                                     /* check handle initialization */
-    {
-        return 3;                                                                                /* return error */
-    }
-    
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_MINIMUM_RAW_DATA, (uint8_t *)min, 1);       /* get minimum raw data */
-    if (res != 0)                                                                                /* check result */
+    start = a_pmw3901mb_stats_begin(handle);                                                /* stats begin */
+    res = a_pmw3901mb_burst_read(handle, PMW3901MB_BURST_PROFILE_FULL, motion);             /* burst read */
+    if (res == 0)                                                                           /* check result */
     {
-        handle->debug_print("pmw3901mb: get minimum raw data failed.\n");                        /* get minimum raw data failed */
-       
-        return 1;                                                                                /* return error */
+        a_pmw3901mb_stats_burst(handle, motion);                                            /* count the validity */
+        res = pmw3901mb_odometry_update(handle, motion);                                    /* update the odometry */
     }
+    a_pmw3901mb_stats_end(handle, PMW3901MB_STATS_API_ODOMETRY_BURST_READ, start, res);     /* stats end */
     
-    return 0;                                                                                    /* success return 0 */
+    return res;                                                                             /* return the result */
 }
 
 /**
- * @brief      get the shutter
+ * @brief      get the odometry position
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *shutter pointer to a shutter buffer
+ * @param[out] *x_cm_q16 pointer to an x cm buffer in q16.16
+ * @param[out] *y_cm_q16 pointer to a y cm buffer in q16.16
  * @return     status code
  *             - 0 success
- *             - 1 get shutter failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t pmw3901mb_get_shutter(pmw3901mb_handle_t *handle, uint16_t *shutter)
+uint8_t pmw3901mb_odometry_get_position(pmw3901mb_handle_t *handle, int64_t *x_cm_q16, int64_t *y_cm_q16)
 {
-    uint8_t res;
-    uint8_t msb;
-    uint8_t lsb;
-    
-    if (handle == NULL)                                                                        /* check handle */
+    if (handle == NULL)                                                          /* check handle */
     {
-        return 2;                                                                              /* return error */
+        return 2;                                                                /* return error */
     }
-    if (handle->inited != 1)                                                                   /* check handle initialization */
+    if (handle->inited != 1)                                                     /* check handle initialization */
     {
-        return 3;                                                                              /* return error */
+        return 3;                                                                /* return error */
     }
     
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_SHUTTER_UPPER, (uint8_t *)&msb, 1);       /* get shutter upper */
-    if (res != 0)                                                                              /* check result */
+    *x_cm_q16 = handle->odometry_x_q16;                                          /* get x */
+    *y_cm_q16 = handle->odometry_y_q16;                                          /* get y */
+    
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     set the odometry checkpoint at the current position
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t pmw3901mb_odometry_set_checkpoint(pmw3901mb_handle_t *handle)
+{
+    if (handle == NULL)                                                          /* check handle */
     {
-        handle->debug_print("pmw3901mb: get shutter upper failed.\n");                         /* get shutter upper failed */
-       
-        return 1;                                                                              /* return error */
+        return 2;                                                                /* return error */
     }
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_SHUTTER_LOWER, (uint8_t *)&lsb, 1);       /* get shutter lower */
-    if (res != 0)                                                                              /* check result */
+    if (handle->inited != 1)                                                     /* check handle initialization */
     {
-        handle->debug_print("pmw3901mb: get shutter lower failed.\n");                         /* get shutter lower failed */
-       
-        return 1;                                                                              /* return error */
+        return 3;                                                                /* return error */
     }
-    *shutter = (uint16_t)(((uint16_t)(msb & 0x1F) << 8) | lsb);                                /* get shutter */
     
-    return 0;                                                                                  /* success return 0 */
+    handle->odometry_checkpoint_x_q16 = handle->odometry_x_q16;                  /* set checkpoint x */
+    handle->odometry_checkpoint_y_q16 = handle->odometry_y_q16;                  /* set checkpoint y */
+    
+    return 0;                                                                    /* success return 0 */
 }
 
 /**
- * @brief      get the observation
+ * @brief      get the odometry displacement since the checkpoint
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *observation pointer to an observation buffer
+ * @param[out] *x_cm_q16 pointer to an x cm buffer in q16.16
+ * @param[out] *y_cm_q16 pointer to a y cm buffer in q16.16
  * @return     status code
  *             - 0 success
- *             - 1 get observation failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
  * @note       none
  */
-uint8_t pmw3901mb_get_observation(pmw3901mb_handle_t *handle, uint8_t *observation)
+uint8_t pmw3901mb_odometry_get_since_checkpoint(pmw3901mb_handle_t *handle, int64_t *x_cm_q16, int64_t *y_cm_q16)
 {
-    uint8_t res;
-    
-    if (handle == NULL)                                                                             /* check handle */
+    if (handle == NULL)                                                          /* check handle */
     {
-        return 2;                                                                                   /* return error */
+        return 2;                                                                /* return error */
     }
-    if (handle->inited != 1)                                                                        /* check handle initialization */
+    if (handle->inited != 1)                                                     /* check handle initialization */
     {
-        return 3;                                                                                   /* return error */
+        return 3;                                                                /* return error */
     }
     
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_OBSERVATION, (uint8_t *)observation, 1);       /* get observation data */
-    if (res != 0)                                                                                   /* check result */
+    *x_cm_q16 = handle->odometry_x_q16 - handle->odometry_checkpoint_x_q16;      /* get x since checkpoint */
+    *y_cm_q16 = handle->odometry_y_q16 - handle->odometry_checkpoint_y_q16;      /* get y since checkpoint */
+    
+    return 0;                                                                    /* success return 0 */
+}
+
+/**
+ * @brief     enable or disable the register shadow
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ * @note      it can be called before init, the shadow is cleared on every change and chip reset,
+ *            with the shadow the redundant bank select writes are skipped, the register values
+ *            are only kept when a shadow buffer is set
+ */
+uint8_t pmw3901mb_set_shadow(pmw3901mb_handle_t *handle, uint8_t enable)
+{
+    if (handle == NULL)                                  /* check handle */
     {
-        handle->debug_print("pmw3901mb: get observation failed.\n");                                /* get observation failed */
-       
-        return 1;                                                                                   /* return error */
+        return 2;                                        /* return error */
     }
-    *observation = (*observation) & 0x3F;                                                           /* set the observation */
     
-    return 0;                                                                                       /* success return 0 */
+    handle->shadow_enable = (enable != 0) ? 1 : 0;       /* set enable */
+    a_pmw3901mb_shadow_clear(handle);                    /* clear the shadow */
+    
+    return 0;                                            /* success return 0 */
 }
 
 /**
- * @brief     set the observation
+ * @brief     set the shadow registers buffer
  * @param[in] *handle pointer to a pmw3901mb handle structure
- * @param[in] observation input observation
+ * @param[in] *shadow pointer to a shadow buffer, NULL drops the register values
+ * @param[in] size shadow buffer size
  * @return    status code
  *            - 0 success
- *            - 1 set observation failed
  *            - 2 handle is NULL
- *            - 3 handle is not initialized
- * @note      none
+ *            - 4 size is 0
+ * @note      it can be called before init, the shadow is cleared,
+ *            PMW3901MB_SHADOW_MAX entries hold all the optimum performance registers
  */
-uint8_t pmw3901mb_set_observation(pmw3901mb_handle_t *handle, uint8_t observation)
+uint8_t pmw3901mb_set_shadow_buffer(pmw3901mb_handle_t *handle, pmw3901mb_shadow_t *shadow, uint16_t size)
 {
-    uint8_t res;
-    
-    if (handle == NULL)                                                                               /* check handle */
+    if (handle == NULL)                                              /* check handle */
     {
-        return 2;                                                                                     /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->inited != 1)                                                                          /* check handle initialization */
+    if ((shadow != NULL) && (size == 0))                             /* check size */
     {
-        return 3;                                                                                     /* return error */
+        handle->debug_print("pmw3901mb: size is invalid.\n");        /* size is invalid */
+        
+        return 4;                                                    /* return error */
     }
     
-    res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_OBSERVATION, (uint8_t *)&observation, 1);       /* set observation data */
-    if (res != 0)                                                                                     /* check result */
+    handle->shadow = shadow;                                         /* set shadow */
+    handle->shadow_size = (shadow != NULL) ? size : 0;               /* set size */
+    a_pmw3901mb_shadow_clear(handle);                                /* clear the shadow */
+    
+    return 0;                                                        /* success return 0 */
+}
+
+/**
+ * @brief     set the register image buffer of the resume
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] *image pointer to an image buffer, NULL disables the capture
+ * @param[in] size image buffer size
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 4 size is 0
+ * @note      it can be called before init, the image is captured by the next set optimum performance or boot,
+ *            PMW3901MB_IMAGE_MAX records hold the whole optimum performance log
+ */
+uint8_t pmw3901mb_set_resume_buffer(pmw3901mb_handle_t *handle, pmw3901mb_sequence_t *image, uint16_t size)
+{
+    if (handle == NULL)                                              /* check handle */
     {
-        handle->debug_print("pmw3901mb: set observation failed.\n");                                  /* set observation failed */
-       
-        return 1;                                                                                     /* return error */
+        return 2;                                                    /* return error */
+    }
+    if ((image != NULL) && (size == 0))                              /* check size */
+    {
+        handle->debug_print("pmw3901mb: size is invalid.\n");        /* size is invalid */
+        
+        return 4;                                                    /* return error */
     }
     
-    return 0;                                                                                         /* success return 0 */
+    handle->image = image;                                           /* set image */
+    handle->image_size = (image != NULL) ? size : 0;                 /* set size */
+    handle->image_num = 0;                                           /* no image yet */
+    handle->image_full = 0;                                          /* clear overflow */
+    handle->image_capture = 0;                                       /* stop capture */
+    
+    return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief      get the raw data grab
+ * @brief      get a register value from the shadow
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *grab pointer to a grab buffer
- * @param[in]  len grab length
+ * @param[in]  bank register bank
+ * @param[in]  reg register address
+ * @param[out] *value pointer to a value buffer
  * @return     status code
  *             - 0 success
- *             - 1 get raw data grab failed
  *             - 2 handle is NULL
  *             - 3 handle is not initialized
- * @note       none
+ *             - 4 register is not shadowed
+ * @note       the value is the last one the driver wrote, no spi transfer is used
  */
-uint8_t pmw3901mb_get_raw_data_grab(pmw3901mb_handle_t *handle, uint8_t *grab, uint16_t len)
+uint8_t pmw3901mb_get_shadow_reg(pmw3901mb_handle_t *handle, uint8_t bank, uint8_t reg, uint8_t *value)
 {
-    uint8_t res;
     uint16_t i;
     
-    if (handle == NULL)                                                                                /* check handle */
+    if (handle == NULL)                                                                   /* check handle */
     {
-        return 2;                                                                                      /* return error */
+        return 2;                                                                         /* return error */
     }
-    if (handle->inited != 1)                                                                           /* check handle initialization */
+    if (handle->inited != 1)                                                              /* check handle initialization */
     {
-        return 3;                                                                                      /* return error */
+        return 3;                                                                         /* return error */
     }
     
-    for (i = 0; i < len; i++)                                                                          /* length times */
+    if (reg == PMW3901MB_REG_BANK_SELECT)                                                 /* bank select */
     {
-        res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_RAW_DATA_GRAB, (uint8_t *)&grab[i], 1);       /* get raw data grab data */
-        if (res != 0)                                                                                  /* check result */
+        if (handle->shadow_bank_valid == 0)                                               /* check bank */
         {
-            handle->debug_print("pmw3901mb: get raw data grab failed.\n");                             /* get raw data grab failed */
-           
-            return 1;                                                                                  /* return error */
+            return 4;                                                                     /* return error */
+        }
+        *value = handle->shadow_bank;                                                     /* get bank */
+        
+        return 0;                                                                         /* success return 0 */
+    }
+    for (i = 0; i < handle->shadow_num; i++)                                              /* find the register */
+    {
+        if ((handle->shadow[i].bank == bank) && (handle->shadow[i].reg == reg))           /* check the register */
+        {
+            *value = handle->shadow[i].value;                                             /* get value */
+            
+            return 0;                                                                     /* success return 0 */
         }
     }
     
-    return 0;                                                                                          /* success return 0 */
+    return 4;                                                                             /* return error */
 }
 
 /**
- * @brief     set the raw data grab
+ * @brief     set the stats block
  * @param[in] *handle pointer to a pmw3901mb handle structure
- * @param[in] *grab pointer to a raw data grab buffer
- * @param[in] len grab length
+ * @param[in] *stats pointer to a stats structure, NULL disables the stats
  * @return    status code
  *            - 0 success
- *            - 1 set raw data grab failed
  *            - 2 handle is NULL
- *            - 3 handle is not initialized
- * @note      none
+ * @note      it can be called before init, the stats block is cleared,
+ *            the latency histograms need the get_timestamp_us function
  */
-uint8_t pmw3901mb_set_raw_data_grab(pmw3901mb_handle_t *handle, uint8_t *grab, uint16_t len)
+uint8_t pmw3901mb_set_stats(pmw3901mb_handle_t *handle, pmw3901mb_stats_t *stats)
 {
-    uint8_t res;
-    uint16_t i;
-    
-    if (handle == NULL)                                                                                /* check handle */
-    {
-        return 2;                                                                                      /* return error */
-    }
-    if (handle->inited != 1)                                                                           /* check handle initialization */
+    if (handle == NULL)                                    /* check handle */
     {
-        return 3;                                                                                      /* return error */
+        return 2;                                          /* return error */
     }
     
-    for (i = 0; i < len; i++)                                                                          /* length times */
+    if (stats != NULL)                                     /* check stats */
     {
-        res = a_pmw3901mb_spi_write(handle, PMW3901MB_REG_RAW_DATA_GRAB, (uint8_t *)&grab[i], 1);      /* set raw data grab */
-        if (res != 0)                                                                                  /* check result */
-        {
-            handle->debug_print("pmw3901mb: set raw data grab failed.\n");                             /* set raw data grab failed */
-           
-            return 1;                                                                                  /* return error */
-        }
+        memset(stats, 0, sizeof(pmw3901mb_stats_t));      /* clear the stats */
     }
+    handle->stats = stats;                                 /* set stats */
     
-    return 0;                                                                                          /* success return 0 */
+    return 0;                                              /* success return 0 */
 }
 
 /**
- * @brief      get the raw data grab status
- * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[out] *status pointer to a status buffer
- * @return     status code
- *             - 0 success
- *             - 1 get raw data grab status failed
- *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
+ * @brief     set the spi trace ring
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] *trace pointer to a trace structure, NULL disables the trace
+ * @param[in] *entry pointer to an entry buffer
+ * @param[in] size entry buffer size
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 4 entry is NULL or size is 0
+ * @note      it can be called before init, the oldest entries are overwritten when the ring is full,
+ *            the timestamps need the get_timestamp_us function
  */
-uint8_t pmw3901mb_get_raw_data_grab_status(pmw3901mb_handle_t *handle, uint8_t *status)
+uint8_t pmw3901mb_set_trace(pmw3901mb_handle_t *handle, pmw3901mb_trace_t *trace, pmw3901mb_trace_entry_t *entry, uint32_t size)
 {
-    uint8_t res;
-    
-    if (handle == NULL)                                                                                 /* check handle */
+    if (handle == NULL)                                              /* check handle */
     {
-        return 2;                                                                                       /* return error */
+        return 2;                                                    /* return error */
     }
-    if (handle->inited != 1)                                                                            /* check handle initialization */
+    
+    if (trace == NULL)                                               /* check trace */
     {
-        return 3;                                                                                       /* return error */
+        handle->trace = NULL;                                        /* disable the trace */
+        
+        return 0;                                                    /* success return 0 */
     }
-    
-    res = a_pmw3901mb_spi_read(handle, PMW3901MB_REG_RAW_DATA_GRAB_STATUS, (uint8_t *)status, 1);       /* get raw data grab status */
-    if (res != 0)                                                                                       /* check result */
+    if ((entry == NULL) || (size == 0))                              /* check entry */
     {
-        handle->debug_print("pmw3901mb: get raw data grab status failed.\n");                           /* get raw data grab status failed */
-       
-        return 1;                                                                                       /* return error */
+        handle->debug_print("pmw3901mb: entry is invalid.\n");       /* entry is invalid */
+        
+        return 4;                                                    /* return error */
     }
+    trace->entry = entry;                                            /* set entry */
+    trace->size = size;                                              /* set size */
+    trace->head = 0;                                                 /* clear head */
+    trace->num = 0;                                                  /* clear num */
+    trace->count = 0;                                                /* clear count */
+    handle->trace = trace;                                           /* set trace */
     
-    return 0;                                                                                           /* success return 0 */
+    return 0;                                                        /* success return 0 */
 }
 
 /**
- * @brief      convert the delta raw to the delta cm
+ * @brief      dump the spi trace ring in the binary format
  * @param[in]  *handle pointer to a pmw3901mb handle structure
- * @param[in]  raw delta raw
- * @param[in]  height_m height(m)
- * @param[out] *cm pointer to a cm buffer
+ * @param[out] *buf pointer to a dump buffer
+ * @param[in]  len buffer length
+ * @param[out] *dump_len pointer to a dump length buffer
  * @return     status code
  *             - 0 success
- *             - 1 delta raw to delta cm failed
  *             - 2 handle is NULL
- *             - 3 handle is not initialized
- * @note       none
+ *             - 4 trace is not set
+ *             - 5 buffer is too small
+ * @note       the records are dumped from the oldest to the newest,
+ *             dump_len is the needed length when the buffer is too small, dropped wraps at 2^32,
+ *             the 32 bits timestamps wrap every 71.6 min and the decoder unwraps them
+ *             while the records are less than one wrap apart
  */
-uint8_t pmw3901mb_delta_raw_to_delta_cm(pmw3901mb_handle_t *handle, int16_t raw, float height_m, float *cm)
+uint8_t pmw3901mb_trace_dump(pmw3901mb_handle_t *handle, uint8_t *buf, uint32_t len, uint32_t *dump_len)
 {
-    if (handle == NULL)                                     /* check handle */
+    pmw3901mb_trace_t *trace;
+    pmw3901mb_trace_entry_t *entry;
+    uint32_t first;
+    uint32_t index;
+    uint32_t num;
+    uint32_t dropped;
+    uint32_t need;
+    uint32_t i;
+    uint16_t j;
+    uint16_t payload;
+    uint8_t *p;
+    
+    if (handle == NULL)                                                                        /* check handle */
     {
-        return 2;                                           /* return error */
+        return 2;                                                                              /* return error */
     }
-    if (handle->inited != 1)                                /* check handle initialization */
+    if (handle->trace == NULL)                                                                 /* check trace */
     {
-        return 3;                                           /* return error */
+        handle->debug_print("pmw3901mb: trace is not set.\n");                                 /* trace is not set */
+        
+        return 4;                                                                              /* return error */
+    }
+    
+    trace = handle->trace;                                                                     /* get trace */
+    num = trace->num;                                                                          /* get the entry number */
+    first = (num < trace->size) ? 0 : trace->head;                                             /* get the oldest entry */
+    need = PMW3901MB_TRACE_DUMP_HEADER_SIZE;                                                   /* header size */
+    index = first;                                                                             /* start from the oldest */
+    for (i = 0; i < num; i++)                                                                  /* get the dump length */
+    {
+        entry = &trace->entry[index];                                                          /* get entry */
+        index = (index + 1 < trace->size) ? (index + 1) : 0;                                   /* next entry */
+        payload = (entry->len < PMW3901MB_TRACE_PAYLOAD_MAX) ? entry->len :
+                  PMW3901MB_TRACE_PAYLOAD_MAX;                                                 /* get payload length */
+        need += PMW3901MB_TRACE_DUMP_RECORD_SIZE + payload;                                    /* add the record */
+    }
+    *dump_len = need;                                                                          /* set dump length */
+    if ((buf == NULL) || (len < need))                                                         /* check buffer */
+    {
+        return 5;                                                                              /* return error */
+    }
+    
+    p = buf;                                                                                   /* set pointer */
+    p[0] = (uint8_t)(PMW3901MB_TRACE_DUMP_MAGIC >> 0);                                         /* set magic */
+    p[1] = (uint8_t)(PMW3901MB_TRACE_DUMP_MAGIC >> 8);                                         /* set magic */
+    p[2] = (uint8_t)(PMW3901MB_TRACE_DUMP_MAGIC >> 16);                                        /* set magic */
+    p[3] = (uint8_t)(PMW3901MB_TRACE_DUMP_MAGIC >> 24);                                        /* set magic */
+    p[4] = PMW3901MB_TRACE_DUMP_VERSION;                                                       /* set version */
+    p[5] = PMW3901MB_TRACE_PAYLOAD_MAX;                                                        /* set payload max */
+    p[6] = 0;                                                                                  /* reserved */
+    p[7] = 0;                                                                                  /* reserved */
+    p[8] = (uint8_t)(num >> 0);                                                                /* set num */
+    p[9] = (uint8_t)(num >> 8);                                                                /* set num */
+    p[10] = (uint8_t)(num >> 16);                                                              /* set num */
+    p[11] = (uint8_t)(num >> 24);                                                              /* set num */
+    dropped = trace->count - num;                                                              /* get the dropped number */
+    p[12] = (uint8_t)(dropped >> 0);                                                           /* set dropped */
+    p[13] = (uint8_t)(dropped >> 8);                                                           /* set dropped */
+    p[14] = (uint8_t)(dropped >> 16);                                                          /* set dropped */
+    p[15] = (uint8_t)(dropped >> 24);                                                          /* set dropped */
+    p += PMW3901MB_TRACE_DUMP_HEADER_SIZE;                                                     /* skip the header */
+    index = first;                                                                             /* start from the oldest */
+    for (i = 0; i < num; i++)                                                                  /* dump all */
+    {
+        entry = &trace->entry[index];                                                          /* get entry */
+        index = (index + 1 < trace->size) ? (index + 1) : 0;                                   /* next entry */
+        p[0] = (uint8_t)(entry->timestamp_us >> 0);                                            /* set timestamp */
+        p[1] = (uint8_t)(entry->timestamp_us >> 8);                                            /* set timestamp */
+        p[2] = (uint8_t)(entry->timestamp_us >> 16);                                           /* set timestamp */
+        p[3] = (uint8_t)(entry->timestamp_us >> 24);                                           /* set timestamp */
+        p[4] = entry->reg;                                                                     /* set reg */
+        p[5] = entry->result;                                                                  /* set result */
+        p[6] = (uint8_t)(entry->len >> 0);                                                     /* set len */
+        p[7] = (uint8_t)(entry->len >> 8);                                                     /* set len */
+        p += PMW3901MB_TRACE_DUMP_RECORD_SIZE;                                                 /* skip the record */
+        payload = (entry->len < PMW3901MB_TRACE_PAYLOAD_MAX) ? entry->len :
+                  PMW3901MB_TRACE_PAYLOAD_MAX;                                                 /* get payload length */
+        for (j = 0; j < payload; j++)                                                          /* copy the payload */
+        {
+            p[j] = entry->payload[j];                                                          /* copy the byte */
+        }
+        p += payload;                                                                          /* skip the payload */
     }
     
-    *cm = (float)(raw) * height_m / 11.914f * 2.54f;        /* convert */
-    
-    return 0;                                               /* success return 0 */
+    return 0;                                                                                  /* success return 0 */
 }
 
 /**
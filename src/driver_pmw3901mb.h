@@ -56,6 +56,36 @@ extern "C"{
  * @{
  */
 
+/**
+ * @brief pmw3901mb frame status enumeration definition
+ */
+typedef enum
+{
+    PMW3901MB_FRAME_STATUS_IDLE = 0x00,        /**< no frame is in progress */
+    PMW3901MB_FRAME_STATUS_WAIT = 0x01,        /**< wait for the raw data grab status */
+    PMW3901MB_FRAME_STATUS_READ = 0x02,        /**< read the pixels */
+    PMW3901MB_FRAME_STATUS_DONE = 0x03,        /**< the frame is finished */
+} pmw3901mb_frame_status_t;
+
+/**
+ * @brief pmw3901mb boot status enumeration definition
+ */
+typedef enum
+{
+    PMW3901MB_BOOT_STATUS_BUSY = 0x00,        /**< call the step again after the wait */
+    PMW3901MB_BOOT_STATUS_DONE = 0x01,        /**< the chip is ready */
+} pmw3901mb_boot_status_t;
+
+/**
+ * @brief pmw3901mb burst profile enumeration definition
+ */
+typedef enum
+{
+    PMW3901MB_BURST_PROFILE_MOTION = 6,         /**< motion, observation and deltas */
+    PMW3901MB_BURST_PROFILE_SQUAL  = 7,         /**< motion profile and surface quality */
+    PMW3901MB_BURST_PROFILE_FULL   = 12,        /**< all the burst registers */
+} pmw3901mb_burst_profile_t;
+
 /**
  * @brief pmw3901mb motion structure definition
  */
@@ -71,23 +101,192 @@ typedef struct pmw3901mb_motion_s
     uint8_t observation;             /**< observation */
     uint16_t shutter;                /**< shutter */
     uint8_t is_valid;                /**< valid flag, 0 meas invalid, 1 meas invalid, 2 meas inner errors */
+    uint64_t timestamp_us;           /**< burst read timestamp in us, 0 if get_timestamp_us is not linked */
 } pmw3901mb_motion_t;
 
+/**
+ * @brief pmw3901mb transfer structure definition
+ */
+typedef struct pmw3901mb_transfer_s
+{
+    uint8_t reg;          /**< register address, bit 7 set means write */
+    uint8_t *buf;         /**< pointer to a data buffer */
+    uint16_t len;         /**< data buffer length */
+} pmw3901mb_transfer_t;
+
+/**
+ * @brief pmw3901mb shadow size definition
+ */
+#define PMW3901MB_SHADOW_MAX        96        /**< shadow buffer size that holds all the optimum performance registers */
+
+/**
+ * @brief pmw3901mb resume image size definition
+ */
+#define PMW3901MB_IMAGE_MAX         128       /**< image buffer size that holds the whole optimum performance log */
+
+/**
+ * @brief pmw3901mb shadow register structure definition
+ */
+typedef struct pmw3901mb_shadow_s
+{
+    uint8_t bank;         /**< register bank */
+    uint8_t reg;          /**< register address */
+    uint8_t value;        /**< last written value */
+} pmw3901mb_shadow_t;
+
+/**
+ * @brief pmw3901mb sequence record structure definition
+ */
+typedef struct pmw3901mb_sequence_s
+{
+    uint8_t op;           /**< opcode */
+    uint8_t reg;          /**< register address */
+    uint8_t value;        /**< register value, compare value, bit mask or retry times */
+    uint8_t param;        /**< delay ms or skip records */
+} pmw3901mb_sequence_t;
+
+/**
+ * @brief pmw3901mb stats bucket definition
+ */
+#ifndef PMW3901MB_STATS_BUCKET_MAX
+    #define PMW3901MB_STATS_BUCKET_MAX        24        /**< log2 latency buckets, the last one holds all the longer calls */
+#endif
+
+/**
+ * @brief pmw3901mb stats api enumeration definition
+ */
+typedef enum
+{
+    PMW3901MB_STATS_API_INIT                    = 0x00,        /**< pmw3901mb_init */
+    PMW3901MB_STATS_API_POWER_UP                = 0x01,        /**< pmw3901mb_power_up */
+    PMW3901MB_STATS_API_BURST_READ              = 0x02,        /**< pmw3901mb_burst_read */
+    PMW3901MB_STATS_API_GET_FRAME               = 0x03,        /**< pmw3901mb_get_frame */
+    PMW3901MB_STATS_API_SET_OPTIMUM_PERFORMANCE = 0x04,        /**< pmw3901mb_set_optimum_performance */
+    PMW3901MB_STATS_API_START_FRAME_CAPTURE     = 0x05,        /**< pmw3901mb_start_frame_capture */
+    PMW3901MB_STATS_API_STOP_FRAME_CAPTURE      = 0x06,        /**< pmw3901mb_stop_frame_capture */
+    PMW3901MB_STATS_API_RESUME                  = 0x07,        /**< pmw3901mb_resume */
+    PMW3901MB_STATS_API_BURST_READ_PROFILE      = 0x08,        /**< pmw3901mb_burst_read_profile */
+    PMW3901MB_STATS_API_BURST_READ_MANY         = 0x09,        /**< pmw3901mb_burst_read_many */
+    PMW3901MB_STATS_API_DEINIT                  = 0x0A,        /**< pmw3901mb_deinit */
+    PMW3901MB_STATS_API_BOOT_BEGIN              = 0x0B,        /**< pmw3901mb_boot_begin */
+    PMW3901MB_STATS_API_BOOT_STEP               = 0x0C,        /**< pmw3901mb_boot_step */
+    PMW3901MB_STATS_API_FRAME_BEGIN             = 0x0D,        /**< pmw3901mb_frame_begin */
+    PMW3901MB_STATS_API_FRAME_STEP              = 0x0E,        /**< pmw3901mb_frame_step */
+    PMW3901MB_STATS_API_ODOMETRY_BURST_READ     = 0x0F,        /**< pmw3901mb_odometry_burst_read */
+    PMW3901MB_STATS_API_RESET                   = 0x10,        /**< pmw3901mb_reset */
+    PMW3901MB_STATS_API_SHUTDOWN                = 0x11,        /**< pmw3901mb_shutdown */
+    PMW3901MB_STATS_API_MAX                     = 0x12,        /**< api number */
+} pmw3901mb_stats_api_t;
+
+/**
+ * @brief pmw3901mb stats structure definition
+ * @note  api_call, api_error and latency cover the apis in pmw3901mb_stats_api_t, the single register
+ *        get and set apis, pmw3901mb_set_reg and pmw3901mb_get_reg are only counted in the spi counters
+ */
+typedef struct pmw3901mb_stats_s
+{
+    uint32_t spi_read;                                                              /**< spi read transfers */
+    uint32_t spi_write;                                                             /**< spi write transfers */
+    uint32_t spi_batch;                                                             /**< spi batch calls */
+    uint32_t read_bytes;                                                            /**< read bytes */
+    uint32_t write_bytes;                                                           /**< written bytes */
+    uint32_t spi_error;                                                             /**< failed spi calls */
+    uint32_t frame_retry;                                                           /**< get frame retries without progress */
+    uint32_t burst_invalid;                                                         /**< burst reads with is_valid 0 */
+    uint32_t burst_error;                                                           /**< burst reads with is_valid 2 */
+    uint32_t api_call[PMW3901MB_STATS_API_MAX];                                     /**< api calls */
+    uint32_t api_error[PMW3901MB_STATS_API_MAX];                                    /**< api errors */
+    uint32_t latency[PMW3901MB_STATS_API_MAX][PMW3901MB_STATS_BUCKET_MAX];          /**< api latency, bucket n holds [2^n, 2^(n + 1)) us */
+} pmw3901mb_stats_t;
+
+/**
+ * @brief pmw3901mb trace payload definition
+ */
+#ifndef PMW3901MB_TRACE_PAYLOAD_MAX
+    #define PMW3901MB_TRACE_PAYLOAD_MAX        12        /**< max recorded payload bytes of one transfer */
+#endif
+
+/**
+ * @brief pmw3901mb trace dump definition
+ */
+#define PMW3901MB_TRACE_DUMP_MAGIC          0x54574D50U        /**< "PMWT" in little endian */
+#define PMW3901MB_TRACE_DUMP_VERSION        1                  /**< dump format version */
+#define PMW3901MB_TRACE_DUMP_HEADER_SIZE    16                 /**< magic 4, version 1, payload max 1, reserved 2, num 4, dropped 4 */
+#define PMW3901MB_TRACE_DUMP_RECORD_SIZE    8                  /**< timestamp 4, reg 1, result 1, len 2 and then min(len, payload max) bytes */
+
+/**
+ * @brief pmw3901mb trace entry structure definition
+ */
+typedef struct pmw3901mb_trace_entry_s
+{
+    uint32_t timestamp_us;                                /**< low 32 bits of the timestamp, it wraps every 2^32 us, about 71.6 min */
+    uint8_t reg;                                          /**< register address, bit 7 is set for a write */
+    uint8_t result;                                       /**< spi result */
+    uint16_t len;                                         /**< transfer length */
+    uint8_t payload[PMW3901MB_TRACE_PAYLOAD_MAX];         /**< the first transferred bytes */
+} pmw3901mb_trace_entry_t;
+
+/**
+ * @brief pmw3901mb trace structure definition
+ */
+typedef struct pmw3901mb_trace_s
+{
+    pmw3901mb_trace_entry_t *entry;        /**< entry ring */
+    uint32_t size;                         /**< entry ring size */
+    uint32_t head;                         /**< next entry index, it wraps at size */
+    uint32_t num;                          /**< valid entries, it stops at size */
+    uint32_t count;                        /**< recorded transfers since the trace was set, it wraps at 2^32 */
+} pmw3901mb_trace_t;
+
 /**
  * @brief pmw3901mb handle structure definition
  */
 typedef struct pmw3901mb_handle_s
 {
-    uint8_t (*reset_gpio_init)(void);                                     /**< point to a reset_gpio_init function address */
-    uint8_t (*reset_gpio_deinit)(void);                                   /**< point to a reset_gpio_deinit function address */
-    uint8_t (*reset_gpio_write)(uint8_t value);                           /**< point to a reset_gpio_write function address */
-    uint8_t (*spi_init)(void);                                            /**< point to a spi_init function address */
-    uint8_t (*spi_deinit)(void);                                          /**< point to a spi_deinit function address */
-    uint8_t (*spi_read)(uint8_t reg, uint8_t *buf, uint16_t len);         /**< point to a spi_read function address */
-    uint8_t (*spi_write)(uint8_t reg, uint8_t *buf, uint16_t len);        /**< point to a spi_write function address */
-    void (*delay_ms)(uint32_t ms);                                        /**< point to a delay_ms function address */
-    void (*debug_print)(const char *const fmt, ...);                      /**< point to a debug_print function address */
-    uint8_t inited;                                                       /**< inited flag */
+    uint8_t (*reset_gpio_init)(void);                                                 /**< point to a reset_gpio_init function address */
+    uint8_t (*reset_gpio_deinit)(void);                                               /**< point to a reset_gpio_deinit function address */
+    uint8_t (*reset_gpio_write)(uint8_t value);                                       /**< point to a reset_gpio_write function address */
+    uint8_t (*spi_init)(void);                                                        /**< point to a spi_init function address */
+    uint8_t (*spi_deinit)(void);                                                      /**< point to a spi_deinit function address */
+    uint8_t (*spi_read)(uint8_t reg, uint8_t *buf, uint16_t len);                     /**< point to a spi_read function address */
+    uint8_t (*spi_write)(uint8_t reg, uint8_t *buf, uint16_t len);                    /**< point to a spi_write function address */
+    uint8_t (*spi_transfer_batch)(pmw3901mb_transfer_t *transfer, uint16_t num);      /**< point to a spi_transfer_batch function address */
+    void (*delay_ms)(uint32_t ms);                                                    /**< point to a delay_ms function address */
+    void (*delay_us)(uint32_t us);                                                    /**< point to a delay_us function address */
+    uint64_t (*get_timestamp_us)(void);                                               /**< point to a get_timestamp_us function address */
+    void (*debug_print)(const char *const fmt, ...);                                  /**< point to a debug_print function address */
+    uint8_t inited;                                                                   /**< inited flag */
+    uint8_t (*frame)[35];                                                             /**< frame buffer */
+    uint16_t frame_pixel;                                                             /**< frame finished pixels */
+    uint8_t frame_high;                                                               /**< frame upper bits read flag */
+    uint8_t frame_status;                                                             /**< frame status */
+    uint16_t seq_index;                                                               /**< sequence record index */
+    uint16_t seq_retry_point;                                                         /**< sequence retry point */
+    uint8_t seq_retry_times;                                                          /**< sequence retry times */
+    uint8_t seq_retry_delay;                                                          /**< sequence retry delay */
+    uint16_t seq_poll;                                                                /**< sequence expect polls in the retry delay */
+    uint8_t seq_c1;                                                                   /**< sequence c1 */
+    uint8_t seq_c2;                                                                   /**< sequence c2 */
+    uint8_t boot_state;                                                               /**< boot state */
+    int32_t odometry_scale_q16;                                                       /**< odometry cm per count in q16.16 */
+    int64_t odometry_x_q16;                                                           /**< odometry accumulated x cm in q16.16 */
+    int64_t odometry_y_q16;                                                           /**< odometry accumulated y cm in q16.16 */
+    int64_t odometry_checkpoint_x_q16;                                                /**< odometry checkpoint x cm in q16.16 */
+    int64_t odometry_checkpoint_y_q16;                                                /**< odometry checkpoint y cm in q16.16 */
+    uint8_t shadow_enable;                                                            /**< shadow enable flag */
+    uint8_t shadow_bank;                                                              /**< shadow current bank */
+    uint8_t shadow_bank_valid;                                                        /**< shadow current bank valid flag */
+    uint16_t shadow_num;                                                              /**< shadow registers number */
+    uint16_t shadow_size;                                                             /**< shadow registers buffer size */
+    pmw3901mb_shadow_t *shadow;                                                       /**< shadow registers buffer */
+    uint8_t image_capture;                                                            /**< register image capture flag */
+    uint8_t image_full;                                                               /**< register image overflow flag */
+    uint16_t image_num;                                                               /**< register image records number */
+    uint16_t image_size;                                                              /**< register image buffer size */
+    uint16_t image_retry;                                                             /**< register image retry point */
+    pmw3901mb_sequence_t *image;                                                      /**< register image log buffer */
+    pmw3901mb_stats_t *stats;                                                         /**< stats block */
+    pmw3901mb_trace_t *trace;                                                         /**< trace ring */
 } pmw3901mb_handle_t;
 
 /**
@@ -157,6 +356,14 @@ typedef struct pmw3901mb_info_s
  */
 #define DRIVER_PMW3901MB_LINK_SPI_WRITE(HANDLE, FUC)                (HANDLE)->spi_write = FUC
 
+/**
+ * @brief     link spi_transfer_batch function
+ * @param[in] HANDLE pointer to a pmw3901mb handle structure
+ * @param[in] FUC pointer to a spi_transfer_batch function address
+ * @note      optional, the driver uses spi_read and spi_write when it is NULL
+ */
+#define DRIVER_PMW3901MB_LINK_SPI_TRANSFER_BATCH(HANDLE, FUC)       (HANDLE)->spi_transfer_batch = FUC
+
 /**
  * @brief     link reset_gpio_init function
  * @param[in] HANDLE pointer to a pmw3901mb handle structure
@@ -189,6 +396,22 @@ typedef struct pmw3901mb_info_s
  */
 #define DRIVER_PMW3901MB_LINK_DELAY_MS(HANDLE, FUC)                 (HANDLE)->delay_ms = FUC
 
+/**
+ * @brief     link delay_us function
+ * @param[in] HANDLE pointer to a pmw3901mb handle structure
+ * @param[in] FUC pointer to a delay_us function address
+ * @note      the delay_us function is optional, if linked the driver waits the datasheet minimum timings
+ */
+#define DRIVER_PMW3901MB_LINK_DELAY_US(HANDLE, FUC)                 (HANDLE)->delay_us = FUC
+
+/**
+ * @brief     link get_timestamp_us function
+ * @param[in] HANDLE pointer to a pmw3901mb handle structure
+ * @param[in] FUC pointer to a get_timestamp_us function address
+ * @note      the get_timestamp_us function is optional, if linked the burst read results are stamped
+ */
+#define DRIVER_PMW3901MB_LINK_GET_TIMESTAMP_US(HANDLE, FUC)         (HANDLE)->get_timestamp_us = FUC
+
 /**
  * @brief     link debug_print function
  * @param[in] HANDLE pointer to a pmw3901mb handle structure
@@ -245,6 +468,40 @@ uint8_t pmw3901mb_init(pmw3901mb_handle_t *handle);
  */
 uint8_t pmw3901mb_deinit(pmw3901mb_handle_t *handle);
 
+/**
+ * @brief      begin a non-blocking boot
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *wait_us pointer to a wait us buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 spi or gpio initialization failed
+ *             - 2 handle is NULL
+ *             - 3 linked functions is NULL
+ *             - 5 reset failed
+ * @note       the boot covers init, power up and set optimum performance,
+ *             call pmw3901mb_boot_step after at least wait_us until it is done
+ */
+uint8_t pmw3901mb_boot_begin(pmw3901mb_handle_t *handle, uint32_t *wait_us);
+
+/**
+ * @brief      run the non-blocking boot until it needs a wait
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *wait_us pointer to a wait us buffer
+ * @param[out] *status pointer to a boot status buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 boot step failed
+ *             - 2 handle is NULL
+ *             - 4 id is invalid
+ *             - 5 reset failed
+ *             - 6 boot is not begun
+ *             - 7 register image is full
+ * @note       the step never sleeps, call it again after at least wait_us,
+ *             spi and gpio are closed when the boot fails, with 7 the boot is done
+ *             and only the resume image is dropped
+ */
+uint8_t pmw3901mb_boot_step(pmw3901mb_handle_t *handle, uint32_t *wait_us, pmw3901mb_boot_status_t *status);
+
 /**
  * @brief     power up the chip
  * @param[in] *handle pointer to a pmw3901mb handle structure
@@ -289,10 +546,26 @@ uint8_t pmw3901mb_reset(pmw3901mb_handle_t *handle);
  *            - 1 set optimum performance failed
  *            - 2 handle is NULL
  *            - 3 handle is not initialized
- * @note      none
+ *            - 4 register image is full
+ * @note      with 4 the chip is set and only the resume image is dropped
  */
 uint8_t pmw3901mb_set_optimum_performance(pmw3901mb_handle_t *handle);
 
+/**
+ * @brief     resume the chip from the captured register image
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 1 resume failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ *            - 4 no register image
+ * @note      the image is captured into the resume buffer by the last set optimum performance or boot,
+ *            a failed capture drops the image, the chip is powered up and the image replays the writes,
+ *            the delays and the handshake polls in the captured order with the branches already resolved
+ */
+uint8_t pmw3901mb_resume(pmw3901mb_handle_t *handle);
+
 /**
  * @brief      burst read data
  * @param[in]  *handle pointer to a pmw3901mb handle structure
@@ -306,6 +579,41 @@ uint8_t pmw3901mb_set_optimum_performance(pmw3901mb_handle_t *handle);
  */
 uint8_t pmw3901mb_burst_read(pmw3901mb_handle_t *handle, pmw3901mb_motion_t *motion);
 
+/**
+ * @brief      burst read a profile prefix
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[in]  profile burst profile
+ * @param[out] *motion pointer to a motion structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 burst read failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 profile is invalid
+ * @note       only the first profile bytes are read and decoded, the other raw bytes and fields are not touched,
+ *             the surface quality check runs from the squal profile and the shutter check in the full profile
+ */
+uint8_t pmw3901mb_burst_read_profile(pmw3901mb_handle_t *handle, pmw3901mb_burst_profile_t profile, pmw3901mb_motion_t *motion);
+
+/**
+ * @brief      burst read many samples
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *samples pointer to a motion array
+ * @param[in]  n sample number
+ * @param[in]  period_us sample period in us, 0 means back to back
+ * @return     status code
+ *             - 0 success
+ *             - 1 burst read failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 samples is NULL
+ * @note       the samples are read with the full profile, each one is stamped when get_timestamp_us is linked,
+ *             with a period the samples are paced from the first timestamp and late samples don't wait,
+ *             without get_timestamp_us the period is a plain delay between samples,
+ *             the samples before a failed read are kept
+ */
+uint8_t pmw3901mb_burst_read_many(pmw3901mb_handle_t *handle, pmw3901mb_motion_t *samples, uint32_t n, uint32_t period_us);
+
 /**
  * @brief      convert the delta raw to the delta cm
  * @param[in]  *handle pointer to a pmw3901mb handle structure
@@ -321,6 +629,243 @@ uint8_t pmw3901mb_burst_read(pmw3901mb_handle_t *handle, pmw3901mb_motion_t *mot
  */
 uint8_t pmw3901mb_delta_raw_to_delta_cm(pmw3901mb_handle_t *handle, int16_t raw, float height_m, float *cm);
 
+/**
+ * @brief      convert the delta raw array to the delta cm array
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[in]  *raw pointer to a delta raw array
+ * @param[in]  height_m height(m)
+ * @param[out] *cm pointer to a cm array
+ * @param[in]  len array length
+ * @return     status code
+ *             - 0 success
+ *             - 1 delta raw to delta cm failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       the scale is computed once for the whole array
+ */
+uint8_t pmw3901mb_delta_raw_to_delta_cm_batch(pmw3901mb_handle_t *handle, const int16_t *raw, float height_m,
+                                              float *cm, uint16_t len);
+
+/**
+ * @brief      get the q16.16 delta scale
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[in]  height_m_q16 height(m) in q16.16
+ * @param[out] *scale_q16 pointer to a cm per count scale buffer in q16.16
+ * @return     status code
+ *             - 0 success
+ *             - 1 get delta scale failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       height_m_q16 can't be negative
+ */
+uint8_t pmw3901mb_get_delta_scale_q16(pmw3901mb_handle_t *handle, int32_t height_m_q16, int32_t *scale_q16);
+
+/**
+ * @brief      convert the delta raw array to the q16.16 delta cm array
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[in]  *raw pointer to a delta raw array
+ * @param[in]  height_m_q16 height(m) in q16.16
+ * @param[out] *cm_q16 pointer to a cm array in q16.16
+ * @param[in]  len array length
+ * @return     status code
+ *             - 0 success
+ *             - 1 delta raw to delta cm failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       no float operation is used, the results saturate at the q16.16 range
+ */
+uint8_t pmw3901mb_delta_raw_to_delta_cm_q16(pmw3901mb_handle_t *handle, const int16_t *raw, int32_t height_m_q16,
+                                            int32_t *cm_q16, uint16_t len);
+
+/**
+ * @brief     reset the odometry
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] height_m_q16 height(m) in q16.16
+ * @return    status code
+ *            - 0 success
+ *            - 1 odometry reset failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the position and the checkpoint are cleared
+ */
+uint8_t pmw3901mb_odometry_reset(pmw3901mb_handle_t *handle, int32_t height_m_q16);
+
+/**
+ * @brief     set the odometry height
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] height_m_q16 height(m) in q16.16
+ * @return    status code
+ *            - 0 success
+ *            - 1 set height failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the new height is used by the following samples
+ */
+uint8_t pmw3901mb_odometry_set_height(pmw3901mb_handle_t *handle, int32_t height_m_q16);
+
+/**
+ * @brief     update the odometry with a motion sample
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] *motion pointer to a motion structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      only the valid samples are integrated
+ */
+uint8_t pmw3901mb_odometry_update(pmw3901mb_handle_t *handle, const pmw3901mb_motion_t *motion);
+
+/**
+ * @brief      burst read and update the odometry
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *motion pointer to a motion structure
+ * @return     status code
+ *             - 0 success
+ *             - 1 burst read failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t pmw3901mb_odometry_burst_read(pmw3901mb_handle_t *handle, pmw3901mb_motion_t *motion);
+
+/**
+ * @brief      get the odometry position
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *x_cm_q16 pointer to an x cm buffer in q16.16
+ * @param[out] *y_cm_q16 pointer to a y cm buffer in q16.16
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t pmw3901mb_odometry_get_position(pmw3901mb_handle_t *handle, int64_t *x_cm_q16, int64_t *y_cm_q16);
+
+/**
+ * @brief     set the odometry checkpoint at the current position
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      none
+ */
+uint8_t pmw3901mb_odometry_set_checkpoint(pmw3901mb_handle_t *handle);
+
+/**
+ * @brief      get the odometry displacement since the checkpoint
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *x_cm_q16 pointer to an x cm buffer in q16.16
+ * @param[out] *y_cm_q16 pointer to a y cm buffer in q16.16
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ * @note       none
+ */
+uint8_t pmw3901mb_odometry_get_since_checkpoint(pmw3901mb_handle_t *handle, int64_t *x_cm_q16, int64_t *y_cm_q16);
+
+/**
+ * @brief     enable or disable the register shadow
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] enable bool value
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ * @note      it can be called before init, the shadow is cleared on every change and chip reset,
+ *            with the shadow the redundant bank select writes are skipped, the register values
+ *            are only kept when a shadow buffer is set
+ */
+uint8_t pmw3901mb_set_shadow(pmw3901mb_handle_t *handle, uint8_t enable);
+
+/**
+ * @brief     set the shadow registers buffer
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] *shadow pointer to a shadow buffer, NULL drops the register values
+ * @param[in] size shadow buffer size
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 4 size is 0
+ * @note      it can be called before init, the shadow is cleared,
+ *            PMW3901MB_SHADOW_MAX entries hold all the optimum performance registers
+ */
+uint8_t pmw3901mb_set_shadow_buffer(pmw3901mb_handle_t *handle, pmw3901mb_shadow_t *shadow, uint16_t size);
+
+/**
+ * @brief     set the register image buffer of the resume
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] *image pointer to an image buffer, NULL disables the capture
+ * @param[in] size image buffer size
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 4 size is 0
+ * @note      it can be called before init, the image is captured by the next set optimum performance or boot,
+ *            PMW3901MB_IMAGE_MAX records hold the whole optimum performance log
+ */
+uint8_t pmw3901mb_set_resume_buffer(pmw3901mb_handle_t *handle, pmw3901mb_sequence_t *image, uint16_t size);
+
+/**
+ * @brief      get a register value from the shadow
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[in]  bank register bank
+ * @param[in]  reg register address
+ * @param[out] *value pointer to a value buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 register is not shadowed
+ * @note       the value is the last one the driver wrote, no spi transfer is used
+ */
+uint8_t pmw3901mb_get_shadow_reg(pmw3901mb_handle_t *handle, uint8_t bank, uint8_t reg, uint8_t *value);
+
+/**
+ * @brief     set the stats block
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] *stats pointer to a stats structure, NULL disables the stats
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ * @note      it can be called before init, the stats block is cleared,
+ *            the latency histograms need the get_timestamp_us function
+ */
+uint8_t pmw3901mb_set_stats(pmw3901mb_handle_t *handle, pmw3901mb_stats_t *stats);
+
+/**
+ * @brief     set the spi trace ring
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] *trace pointer to a trace structure, NULL disables the trace
+ * @param[in] *entry pointer to an entry buffer
+ * @param[in] size entry buffer size
+ * @return    status code
+ *            - 0 success
+ *            - 2 handle is NULL
+ *            - 4 entry is NULL or size is 0
+ * @note      it can be called before init, the oldest entries are overwritten when the ring is full,
+ *            the timestamps need the get_timestamp_us function
+ */
+uint8_t pmw3901mb_set_trace(pmw3901mb_handle_t *handle, pmw3901mb_trace_t *trace, pmw3901mb_trace_entry_t *entry, uint32_t size);
+
+/**
+ * @brief      dump the spi trace ring in the binary format
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[out] *buf pointer to a dump buffer
+ * @param[in]  len buffer length
+ * @param[out] *dump_len pointer to a dump length buffer
+ * @return     status code
+ *             - 0 success
+ *             - 2 handle is NULL
+ *             - 4 trace is not set
+ *             - 5 buffer is too small
+ * @note       the records are dumped from the oldest to the newest,
+ *             dump_len is the needed length when the buffer is too small, dropped wraps at 2^32,
+ *             the 32 bits timestamps wrap every 71.6 min and the decoder unwraps them
+ *             while the records are less than one wrap apart
+ */
+uint8_t pmw3901mb_trace_dump(pmw3901mb_handle_t *handle, uint8_t *buf, uint32_t len, uint32_t *dump_len);
+
 /**
  * @brief     start frame capture
  * @param[in] *handle pointer to a pmw3901mb handle structure
@@ -362,6 +907,36 @@ uint8_t pmw3901mb_stop_frame_capture(pmw3901mb_handle_t *handle);
  */
 uint8_t pmw3901mb_get_frame(pmw3901mb_handle_t *handle, uint8_t frame[35][35]);
 
+/**
+ * @brief     begin a non-blocking frame read
+ * @param[in] *handle pointer to a pmw3901mb handle structure
+ * @param[in] **frame pointer to a frame buffer
+ * @return    status code
+ *            - 0 success
+ *            - 1 frame begin failed
+ *            - 2 handle is NULL
+ *            - 3 handle is not initialized
+ * @note      the frame capture must be started and the frame buffer must be kept until the frame is done
+ */
+uint8_t pmw3901mb_frame_begin(pmw3901mb_handle_t *handle, uint8_t frame[35][35]);
+
+/**
+ * @brief      run a bounded step of the non-blocking frame read
+ * @param[in]  *handle pointer to a pmw3901mb handle structure
+ * @param[in]  budget max register reads in this step
+ * @param[out] *status pointer to a frame status buffer
+ * @param[out] *pixel pointer to a finished pixels buffer
+ * @return     status code
+ *             - 0 success
+ *             - 1 frame step failed
+ *             - 2 handle is NULL
+ *             - 3 handle is not initialized
+ *             - 4 frame is not begun
+ * @note       the step returns early when the sensor is not ready, the caller decides when to step again
+ *             and how long to wait before giving up
+ */
+uint8_t pmw3901mb_frame_step(pmw3901mb_handle_t *handle, uint16_t budget, pmw3901mb_frame_status_t *status, uint16_t *pixel);
+
 /**
  * @brief      get the product id
  * @param[in]  *handle pointer to a pmw3901mb handle structure
@@ -59,10 +59,13 @@ uint8_t pmw3901mb_frame_test(uint32_t times)
     DRIVER_PMW3901MB_LINK_SPI_DEINIT(&gs_handle, pmw3901mb_interface_spi_deinit);
     DRIVER_PMW3901MB_LINK_SPI_READ(&gs_handle, pmw3901mb_interface_spi_read);
     DRIVER_PMW3901MB_LINK_SPI_WRITE(&gs_handle, pmw3901mb_interface_spi_write);
+    DRIVER_PMW3901MB_LINK_SPI_TRANSFER_BATCH(&gs_handle, pmw3901mb_interface_spi_transfer_batch);
     DRIVER_PMW3901MB_LINK_RESET_GPIO_INIT(&gs_handle, pmw3901mb_interface_reset_gpio_init);
     DRIVER_PMW3901MB_LINK_RESET_GPIO_DEINIT(&gs_handle, pmw3901mb_interface_reset_gpio_deinit);
     DRIVER_PMW3901MB_LINK_RESET_GPIO_WRITE(&gs_handle, pmw3901mb_interface_reset_gpio_write);
     DRIVER_PMW3901MB_LINK_DELAY_MS(&gs_handle, pmw3901mb_interface_delay_ms);
+    DRIVER_PMW3901MB_LINK_DELAY_US(&gs_handle, pmw3901mb_interface_delay_us);
+    DRIVER_PMW3901MB_LINK_GET_TIMESTAMP_US(&gs_handle, pmw3901mb_interface_get_timestamp_us);
     DRIVER_PMW3901MB_LINK_DEBUG_PRINT(&gs_handle, pmw3901mb_interface_debug_print);
     
     /* get information */
@@ -37,6 +37,29 @@
 #include "driver_pmw3901mb_read_test.h"
 
 static pmw3901mb_handle_t gs_handle;        /**< pmw3901mb handle */
+static pmw3901mb_trace_t gs_trace;          /**< spi trace */
+static pmw3901mb_trace_entry_t gs_entry[4]; /**< spi trace entry */
+
+/**
+ * @brief     decode the valid flag from the raw burst bytes
+ * @param[in] *raw pointer to a raw burst buffer
+ * @param[in] len read burst length
+ * @return    valid flag, 0 no motion, 1 valid and 2 invalid data
+ * @note      squal and shutter are only checked when they are read
+ */
+static uint8_t a_pmw3901mb_read_test_valid(const uint8_t *raw, uint8_t len)
+{
+    if ((raw[0] & 0x80) == 0)
+    {
+        return 0;
+    }
+    if (((len > 6) && (raw[6] < 0x19)) || ((len > 10) && (raw[10] == 0x1F)))
+    {
+        return 2;
+    }
+
+    return 1;
+}
 
 /**
  * @brief     read test
@@ -58,10 +81,13 @@ uint8_t pmw3901mb_read_test(float height_m, uint32_t times)
     DRIVER_PMW3901MB_LINK_SPI_DEINIT(&gs_handle, pmw3901mb_interface_spi_deinit);
     DRIVER_PMW3901MB_LINK_SPI_READ(&gs_handle, pmw3901mb_interface_spi_read);
     DRIVER_PMW3901MB_LINK_SPI_WRITE(&gs_handle, pmw3901mb_interface_spi_write);
+    DRIVER_PMW3901MB_LINK_SPI_TRANSFER_BATCH(&gs_handle, pmw3901mb_interface_spi_transfer_batch);
     DRIVER_PMW3901MB_LINK_RESET_GPIO_INIT(&gs_handle, pmw3901mb_interface_reset_gpio_init);
     DRIVER_PMW3901MB_LINK_RESET_GPIO_DEINIT(&gs_handle, pmw3901mb_interface_reset_gpio_deinit);
     DRIVER_PMW3901MB_LINK_RESET_GPIO_WRITE(&gs_handle, pmw3901mb_interface_reset_gpio_write);
     DRIVER_PMW3901MB_LINK_DELAY_MS(&gs_handle, pmw3901mb_interface_delay_ms);
+    DRIVER_PMW3901MB_LINK_DELAY_US(&gs_handle, pmw3901mb_interface_delay_us);
+    DRIVER_PMW3901MB_LINK_GET_TIMESTAMP_US(&gs_handle, pmw3901mb_interface_get_timestamp_us);
     DRIVER_PMW3901MB_LINK_DEBUG_PRINT(&gs_handle, pmw3901mb_interface_debug_print);
 
     /* get information */
@@ -176,6 +202,99 @@ uint8_t pmw3901mb_read_test(float height_m, uint32_t times)
         times--;
     }
 
+    /* burst read profiles */
+    {
+        const pmw3901mb_burst_profile_t profile[3] = {PMW3901MB_BURST_PROFILE_MOTION,
+                                                      PMW3901MB_BURST_PROFILE_SQUAL,
+                                                      PMW3901MB_BURST_PROFILE_FULL};
+        pmw3901mb_motion_t motion;
+        pmw3901mb_trace_entry_t *entry;
+        uint8_t i;
+
+        res = pmw3901mb_set_trace(&gs_handle, &gs_trace, gs_entry, 4);
+        if (res != 0)
+        {
+            pmw3901mb_interface_debug_print("pmw3901mb: set trace failed.\n");
+            (void)pmw3901mb_deinit(&gs_handle);
+
+            return 1;
+        }
+        for (i = 0; i < 3; i++)
+        {
+            res = pmw3901mb_burst_read_profile(&gs_handle, profile[i], &motion);
+            if (res != 0)
+            {
+                pmw3901mb_interface_debug_print("pmw3901mb: burst read profile failed.\n");
+                (void)pmw3901mb_deinit(&gs_handle);
+
+                return 1;
+            }
+            pmw3901mb_interface_debug_print("pmw3901mb: burst read %d bytes, valid flag is %d.\n", profile[i], motion.is_valid);
+
+            /* check the read length */
+            entry = &gs_entry[(gs_trace.head + 3) % 4];
+            if ((entry->reg != 0x16) || (entry->len != (uint16_t)profile[i]))
+            {
+                pmw3901mb_interface_debug_print("pmw3901mb: burst read reg 0x%02X %d bytes, expect reg 0x16 %d bytes.\n",
+                                                entry->reg, entry->len, profile[i]);
+                (void)pmw3901mb_deinit(&gs_handle);
+
+                return 1;
+            }
+
+            /* check the valid flag */
+            if (motion.is_valid != a_pmw3901mb_read_test_valid(motion.raw, (uint8_t)profile[i]))
+            {
+                pmw3901mb_interface_debug_print("pmw3901mb: valid flag doesn't match the burst bytes.\n");
+                (void)pmw3901mb_deinit(&gs_handle);
+
+                return 1;
+            }
+        }
+        (void)pmw3901mb_set_trace(&gs_handle, NULL, NULL, 0);
+    }
+
+    /* burst read many */
+    {
+        pmw3901mb_motion_t samples[8];
+        uint8_t i;
+
+        res = pmw3901mb_burst_read_many(&gs_handle, samples, 8, 1000);
+        if (res != 0)
+        {
+            pmw3901mb_interface_debug_print("pmw3901mb: burst read many failed.\n");
+            (void)pmw3901mb_deinit(&gs_handle);
+
+            return 1;
+        }
+        for (i = 0; i < 8; i++)
+        {
+            pmw3901mb_interface_debug_print("pmw3901mb: sample %d at %dus, valid flag is %d.\n", i,
+                                            (int)(samples[i].timestamp_us - samples[0].timestamp_us), samples[i].is_valid);
+
+            /* the samples are paced from the first one, a period apart unless the previous one was late */
+            if ((i != 0) && ((samples[i].timestamp_us <= samples[i - 1].timestamp_us) ||
+                             (samples[i].timestamp_us - samples[0].timestamp_us < (uint64_t)i * 1000) ||
+                             ((samples[i].timestamp_us - samples[i - 1].timestamp_us < 1000) &&
+                              (samples[i - 1].timestamp_us - samples[0].timestamp_us == (uint64_t)(i - 1) * 1000))))
+            {
+                pmw3901mb_interface_debug_print("pmw3901mb: sample %d is too early.\n", i);
+                (void)pmw3901mb_deinit(&gs_handle);
+
+                return 1;
+            }
+
+            /* check the valid flag */
+            if (samples[i].is_valid != a_pmw3901mb_read_test_valid(samples[i].raw, 12))
+            {
+                pmw3901mb_interface_debug_print("pmw3901mb: sample %d valid flag doesn't match the burst bytes.\n", i);
+                (void)pmw3901mb_deinit(&gs_handle);
+
+                return 1;
+            }
+        }
+    }
+
     /* finish the read test */
     pmw3901mb_interface_debug_print("pmw3901mb: finish the read test.\n");
     (void)pmw3901mb_deinit(&gs_handle);